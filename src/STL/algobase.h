@@ -66,7 +66,7 @@ const T& min(const T& lhs, const T& rhs, Compare comp) {
 
 template <class FIter1, class FIter2>
 void iter_swap(FIter1 lhs, FIter2 rhs) {
-  Mystl::swap(lhs, rhs);
+  Mystl::swap(*lhs, *rhs);
 }
 
 /**
@@ -234,18 +234,6 @@ Mystl::pair<InputIter, OutputIter> copy_n(InputIter  first,
   return unchecked_copy_n(first, n, result, iterator_category(first));
 }
 
-template <class RandomIter1, class RandomIter2>
-RandomIter2 unchecked_move_backward_cat(RandomIter1 first,
-                                        RandomIter2 last,
-                                        RandomIter2 result,
-                                        Mystl::random_access_iterator_tag) {
-  for (auto n = last - first; n > 0; --n) {
-    *--result = Mystl::move(*--last);
-  }
-
-  return result;
-}
-
 /*****************************************************************************************/
 // move
 // 把 [first, last)区间内的元素移动到 [result, result + (last - first))内
@@ -325,7 +313,7 @@ RandomIter2 unchecked_move_backward_cat(RandomIter1 first,
 
 template <class BidirectionalIter1, class BidirectionalIter2>
 BidirectionalIter2 unchecked_move_backward(BidirectionalIter1 first,
-                                           BidirectionalIter2 last,
+                                           BidirectionalIter1 last,
                                            BidirectionalIter2 result) {
   return unchecked_move_backward_cat(first,
                                      last,
@@ -352,7 +340,7 @@ template <class BidirectionalIter1, class BidirectionalIter2>
 BidirectionalIter2 move_backward(BidirectionalIter1 first,
                                  BidirectionalIter1 last,
                                  BidirectionalIter2 result) {
-  return uncheck_move_backward(first, last, result);
+  return unchecked_move_backward(first, last, result);
 }
 
 /**
@@ -414,7 +402,7 @@ typename std::enable_if<std::is_integral<Tp>::value && sizeof(Tp) == 1 &&
                         Tp*>::type
 unchecked_fill_n(Tp* first, Size n, Up value) {
   if (n > 0) {
-    std::memmove(first, (unsigned char)value, (size_t)(n));
+    std::memset(first, (unsigned char)value, (size_t)(n));
   }
 
   return first + n;
@@ -440,7 +428,7 @@ void fill_cat(RandomIter first,
               RandomIter last,
               const T&   value,
               Mystl::random_access_iterator_tag) {
-  fill_n(first, last - first, value);
+  Mystl::fill_n(first, last - first, value);
 }
 
 template <class ForwardIter, class T>
@@ -448,6 +436,20 @@ void fill(ForwardIter first, ForwardIter last, const T& value) {
   fill_cat(first, last, value, iterator_category(first));
 }
 
+/**
+ * @brief reverse 将[first, last)区间内的元素反转
+ * @tparam BidirectionalIter
+ * @param  first            My Pan doc
+ * @param  last             My Pan doc
+ * */
+template <class BidirectionalIter>
+void reverse(BidirectionalIter first, BidirectionalIter last) {
+  while (first != last && first != --last) {
+    Mystl::iter_swap(first, last);
+    ++first;
+  }
+}
+
 /**
  * @brief lexicographical_compare
  * 以字典序排列对两个序列进行比较，当在某个位置发现第一组不相等元素时，有下列几种情况：
@@ -490,10 +492,10 @@ bool lexicographical_compare(InputIter1 first1,
   return first1 == last1 && first2 == last2;
 }
 
-bool lexicographical_compare(const unsigned char* first1,
-                             const unsigned char* last1,
-                             const unsigned char* first2,
-                             const unsigned char* last2) {
+inline bool lexicographical_compare(const unsigned char* first1,
+                                    const unsigned char* last1,
+                                    const unsigned char* first2,
+                                    const unsigned char* last2) {
   const auto len1 = last1 - first1;
   const auto len2 = last2 - first2;
 
@@ -0,0 +1,330 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file alloc.h
+ * @brief 第二级配置器, 以 size class 自由链表管理小块内存
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-12 10:05:21
+ *
+ * 小于等于 ALLOC_MAX_BYTES 的请求被上调至 ALLOC_ALIGN 的倍数, 由对应的
+ * 自由链表服务; 链表为空时一次从内存池切出若干块(refill), 内存池不足时
+ * 再向 ::operator new 申请一大块(chunk_alloc)。大块请求直接交给
+ * ::operator new。内存池中的 chunk 在进程生命周期内不会归还给系统。
+ *
+ * */
+
+#ifndef __ALLOC_H__
+#define __ALLOC_H__
+
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include "construct.h"
+#include "util.h"
+
+namespace Mystl {
+
+// 小块内存的对齐粒度, 保证与 ::operator new 相同的基本对齐
+enum { ALLOC_ALIGN = alignof(std::max_align_t) };
+// 小块内存的上限, 超过该值直接使用 ::operator new
+enum { ALLOC_MAX_BYTES = 256 };
+// 自由链表的个数
+enum { ALLOC_NFREELISTS = ALLOC_MAX_BYTES / ALLOC_ALIGN };
+// 每次 refill 默认切出的块数
+enum { ALLOC_NOBJS = 20 };
+
+/**
+ * @brief 第二级配置器
+ * @tparam threads          是否需要加锁, 单线程使用时可以关闭
+ * @tparam inst             用于区分不同的内存池实例
+ * */
+template <bool threads, int inst>
+class default_alloc_template {
+public:
+  static void* allocate(size_t n);
+  static void  deallocate(void* p, size_t n);
+  static void* reallocate(void* p, size_t old_sz, size_t new_sz);
+
+private:
+  union obj {
+    union obj* next;  // 指向下一个空闲块
+    char       data[1];
+  };
+
+  // 多线程时以互斥锁保护自由链表与内存池
+  struct lock {
+    lock() {
+      if (threads) mutex_.lock();
+    }
+    ~lock() {
+      if (threads) mutex_.unlock();
+    }
+  };
+
+  static size_t round_up(size_t bytes) {
+    return (bytes + ALLOC_ALIGN - 1) & ~(static_cast<size_t>(ALLOC_ALIGN) - 1);
+  }
+
+  static size_t freelist_index(size_t bytes) {
+    return (bytes + ALLOC_ALIGN - 1) / ALLOC_ALIGN - 1;
+  }
+
+  static void* refill(size_t n);
+  static char* chunk_alloc(size_t size, int& nobjs);
+
+  static obj*       free_list_[ALLOC_NFREELISTS];
+  static char*      start_free_;  // 内存池起始位置
+  static char*      end_free_;    // 内存池结束位置
+  static size_t     heap_size_;   // 已向系统申请的总量
+  static std::mutex mutex_;
+};
+
+template <bool threads, int inst>
+typename default_alloc_template<threads, inst>::obj*
+    default_alloc_template<threads, inst>::free_list_[ALLOC_NFREELISTS] = {};
+
+template <bool threads, int inst>
+char* default_alloc_template<threads, inst>::start_free_ = nullptr;
+
+template <bool threads, int inst>
+char* default_alloc_template<threads, inst>::end_free_ = nullptr;
+
+template <bool threads, int inst>
+size_t default_alloc_template<threads, inst>::heap_size_ = 0;
+
+template <bool threads, int inst>
+std::mutex default_alloc_template<threads, inst>::mutex_;
+
+/**
+ * @brief 分配 n 字节, 小块从自由链表取出
+ * @param  n                My Pan doc
+ * @return void*
+ * */
+template <bool threads, int inst>
+void* default_alloc_template<threads, inst>::allocate(size_t n) {
+  if (n > static_cast<size_t>(ALLOC_MAX_BYTES)) {
+    return ::operator new(n);
+  }
+  if (0 == n) n = 1;
+
+  lock  guard;
+  obj** my_free_list = free_list_ + freelist_index(n);
+  obj*  result       = *my_free_list;
+  if (nullptr == result) {
+    return refill(round_up(n));
+  }
+  *my_free_list = result->next;
+  return result;
+}
+
+/**
+ * @brief 归还 n 字节, 小块挂回自由链表
+ * @param  p                My Pan doc
+ * @param  n                My Pan doc
+ * */
+template <bool threads, int inst>
+void default_alloc_template<threads, inst>::deallocate(void* p, size_t n) {
+  if (n > static_cast<size_t>(ALLOC_MAX_BYTES)) {
+    ::operator delete(p);
+    return;
+  }
+  if (0 == n) n = 1;
+
+  lock  guard;
+  obj*  q            = static_cast<obj*>(p);
+  obj** my_free_list = free_list_ + freelist_index(n);
+  q->next            = *my_free_list;
+  *my_free_list      = q;
+}
+
+/**
+ * @brief 重新分配, 同一 size class 内直接返回原指针
+ * @param  p                My Pan doc
+ * @param  old_sz           My Pan doc
+ * @param  new_sz           My Pan doc
+ * @return void*
+ * */
+template <bool threads, int inst>
+void* default_alloc_template<threads, inst>::reallocate(void*  p,
+                                                        size_t old_sz,
+                                                        size_t new_sz) {
+  if (old_sz <= static_cast<size_t>(ALLOC_MAX_BYTES) &&
+      new_sz <= static_cast<size_t>(ALLOC_MAX_BYTES) &&
+      round_up(old_sz) == round_up(new_sz)) {
+    return p;
+  }
+
+  void*        result    = allocate(new_sz);
+  const size_t copy_size = old_sz < new_sz ? old_sz : new_sz;
+  std::memcpy(result, p, copy_size);
+  deallocate(p, old_sz);
+  return result;
+}
+
+/**
+ * @brief 自由链表为空时, 从内存池切出 ALLOC_NOBJS 块, 返回其中一块,
+ *        其余挂到自由链表上。调用者已持有锁
+ * @param  n                已上调至 ALLOC_ALIGN 的倍数
+ * @return void*
+ * */
+template <bool threads, int inst>
+void* default_alloc_template<threads, inst>::refill(size_t n) {
+  int   nobjs = ALLOC_NOBJS;
+  char* chunk = chunk_alloc(n, nobjs);
+  if (1 == nobjs) {
+    return chunk;
+  }
+
+  obj** my_free_list = free_list_ + freelist_index(n);
+  obj*  result       = reinterpret_cast<obj*>(chunk);
+  obj*  cur          = reinterpret_cast<obj*>(chunk + n);
+  *my_free_list      = cur;
+  for (int i = 2; i < nobjs; ++i) {
+    obj* next = reinterpret_cast<obj*>(reinterpret_cast<char*>(cur) + n);
+    cur->next = next;
+    cur       = next;
+  }
+  cur->next = nullptr;
+  return result;
+}
+
+/**
+ * @brief 从内存池中取 nobjs 个 size 大小的块, 不足时尽量多给,
+ *        连一块都给不出时向系统申请新的 chunk
+ * @param  size             My Pan doc
+ * @param  nobjs            实际取得的块数
+ * @return char*
+ * */
+template <bool threads, int inst>
+char* default_alloc_template<threads, inst>::chunk_alloc(size_t size,
+                                                         int&   nobjs) {
+  char*  result      = nullptr;
+  size_t total_bytes = size * nobjs;
+  size_t bytes_left  = end_free_ - start_free_;
+
+  if (bytes_left >= total_bytes) {
+    result = start_free_;
+    start_free_ += total_bytes;
+    return result;
+  } else if (bytes_left >= size) {
+    nobjs       = static_cast<int>(bytes_left / size);
+    total_bytes = size * nobjs;
+    result      = start_free_;
+    start_free_ += total_bytes;
+    return result;
+  }
+
+  // 内存池剩余的零头挂到对应的自由链表上
+  if (bytes_left > 0) {
+    obj** my_free_list = free_list_ + freelist_index(bytes_left);
+    reinterpret_cast<obj*>(start_free_)->next = *my_free_list;
+    *my_free_list = reinterpret_cast<obj*>(start_free_);
+  }
+
+  const size_t bytes_to_get = 2 * total_bytes + round_up(heap_size_ >> 4);
+  start_free_ = static_cast<char*>(::operator new(bytes_to_get, std::nothrow));
+  if (nullptr == start_free_) {
+    // 系统内存不足, 尝试从更大的 size class 中借一块
+    for (size_t i = size; i <= static_cast<size_t>(ALLOC_MAX_BYTES);
+         i += ALLOC_ALIGN) {
+      obj** my_free_list = free_list_ + freelist_index(i);
+      obj*  p            = *my_free_list;
+      if (nullptr != p) {
+        *my_free_list = p->next;
+        start_free_   = reinterpret_cast<char*>(p);
+        end_free_     = start_free_ + i;
+        return chunk_alloc(size, nobjs);
+      }
+    }
+    end_free_   = nullptr;
+    start_free_ = static_cast<char*>(::operator new(bytes_to_get));
+  }
+
+  heap_size_ += bytes_to_get;
+  end_free_ = start_free_ + bytes_to_get;
+  return chunk_alloc(size, nobjs);
+}
+
+typedef default_alloc_template<true, 0>  alloc;
+typedef default_alloc_template<false, 0> single_client_alloc;
+
+/**
+ * @brief 以第二级配置器为后端的 allocator, 接口与 Mystl::allocator 相同
+ * @tparam T
+ * @tparam Alloc            第二级配置器, 默认为线程安全的 alloc
+ * */
+template <class T, class Alloc = alloc>
+class pool_allocator {
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <class U>
+  struct rebind {
+    typedef pool_allocator<U, Alloc> other;
+  };
+
+  pool_allocator() noexcept {
+  }
+
+  template <class U>
+  pool_allocator(const pool_allocator<U, Alloc>&) noexcept {
+  }
+
+  static T* allocate() {
+    return static_cast<T*>(Alloc::allocate(sizeof(T)));
+  }
+
+  static T* allocate(size_type n) {
+    if (0 == n) {
+      return nullptr;
+    }
+    return static_cast<T*>(Alloc::allocate(n * sizeof(T)));
+  }
+
+  static void deallocate(T* ptr) {
+    if (nullptr == ptr) return;
+    Alloc::deallocate(ptr, sizeof(T));
+  }
+
+  static void deallocate(T* ptr, size_type n) {
+    if (nullptr == ptr) return;
+    Alloc::deallocate(ptr, n * sizeof(T));
+  }
+
+  static void construct(T* ptr) {
+    Mystl::construct(ptr);
+  }
+
+  static void construct(T* ptr, const T& value) {
+    Mystl::construct(ptr, value);
+  }
+
+  static void construct(T* ptr, T&& value) {
+    Mystl::construct(ptr, Mystl::move(value));
+  }
+
+  template <class... Args>
+  static void construct(T* ptr, Args&&... args) {
+    Mystl::construct(ptr, Mystl::forward<Args>(args)...);
+  }
+
+  static void destroy(T* ptr) {
+    Mystl::destroy(ptr);
+  }
+
+  static void destroy(T* first, T* last) {
+    Mystl::destroy(first, last);
+  }
+};
+
+}  // namespace Mystl
+
+#endif /* __ALLOC_H__ */
@@ -0,0 +1,304 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file alloc_stats.h
+ * @brief 记录分配次数、字节数与大小分布的 allocator 包装
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-17 10:05:44
+ *
+ * instrumented_allocator<Alloc, Tag> 把请求转发给 Alloc, 同时在
+ * alloc_stats 中累计分配/释放次数、当前占用字节、峰值字节以及按 2 的幂
+ * 分桶的请求大小直方图。每个 (Tag, value_type) 组合对应一份统计, 第一次
+ * 使用时登记到全局链表, dump_alloc_stats 输出全部统计。
+ *
+ * 定义 MYSTL_ALLOC_STATS 后 vector 与 list 的默认 allocator 被包装, 未
+ * 定义时容器不包含本文件, 没有任何开销。计数器为 relaxed 原子变量,
+ * 可以在多线程中使用。
+ *
+ * */
+
+#ifndef __ALLOC_STATS_H__
+#define __ALLOC_STATS_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif  // __GNUG__
+
+#include "allocator.h"
+#include "util.h"
+
+namespace Mystl {
+
+// 直方图的桶数, 第 k 个桶统计 [2^k, 2^(k+1)) 字节的请求
+enum { ALLOC_STATS_BUCKETS = 48 };
+
+/**
+ * @brief 一个 (容器, 元素类型) 组合的分配统计
+ * */
+struct alloc_stats {
+  std::string         name;
+  std::atomic<size_t> allocs;      // 分配次数
+  std::atomic<size_t> deallocs;    // 释放次数
+  std::atomic<size_t> bytes_live;  // 当前占用字节
+  std::atomic<size_t> peak_bytes;  // 占用字节的峰值
+  std::atomic<size_t> histogram[ALLOC_STATS_BUCKETS];
+  alloc_stats*        next;        // 全局链表中的下一份统计
+
+  explicit alloc_stats(const std::string& n)
+      : name(n), allocs(0), deallocs(0), bytes_live(0), peak_bytes(0) {
+    for (size_t i = 0; i < ALLOC_STATS_BUCKETS; ++i) {
+      histogram[i].store(0, std::memory_order_relaxed);
+    }
+    link(this);
+  }
+
+  void record_allocate(size_t bytes) noexcept {
+    allocs.fetch_add(1, std::memory_order_relaxed);
+    histogram[bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+    add_live(bytes);
+  }
+
+  void record_deallocate(size_t bytes) noexcept {
+    deallocs.fetch_add(1, std::memory_order_relaxed);
+    bytes_live.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  // reallocate 计为一次新大小的分配与一次旧大小的释放
+  void record_reallocate(size_t old_bytes, size_t new_bytes) noexcept {
+    record_allocate(new_bytes);
+    if (old_bytes != 0) {
+      record_deallocate(old_bytes);
+    }
+  }
+
+  // 全局链表的头部
+  static std::atomic<alloc_stats*>& head() {
+    static std::atomic<alloc_stats*> h(nullptr);
+    return h;
+  }
+
+private:
+  static size_t bucket(size_t bytes) noexcept {
+    size_t k = 0;
+    while (bytes > 1 && k + 1 < ALLOC_STATS_BUCKETS) {
+      bytes >>= 1;
+      ++k;
+    }
+    return k;
+  }
+
+  void add_live(size_t bytes) noexcept {
+    const size_t live =
+        bytes_live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_bytes.compare_exchange_weak(
+                              peak, live, std::memory_order_relaxed)) {
+    }
+  }
+
+  static void link(alloc_stats* s) {
+    alloc_stats* old = head().load(std::memory_order_relaxed);
+    do {
+      s->next = old;
+    } while (!head().compare_exchange_weak(old, s, std::memory_order_release,
+                                           std::memory_order_relaxed));
+  }
+
+  alloc_stats(const alloc_stats&);
+  void operator=(const alloc_stats&);
+};
+
+// 类型名, gcc/clang 下还原为可读形式
+inline std::string readable_type_name(const char* mangled) {
+#if defined(__GNUG__)
+  int   status = 0;
+  char* name   = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+  if (status == 0 && name != nullptr) {
+    std::string result(name);
+    std::free(name);
+    return result;
+  }
+#endif  // __GNUG__
+  return mangled;
+}
+
+/**
+ * @brief 取得 (Tag, T) 对应的统计, 第一次调用时创建并登记
+ * @tparam Tag              提供 static const char* name() 的标签类型
+ * @tparam T                分配的对象类型
+ * @return alloc_stats&
+ * */
+template <class Tag, class T>
+alloc_stats& stats_for() {
+  static alloc_stats s(std::string(Tag::name()) + " / " +
+                       readable_type_name(typeid(T).name()));
+  return s;
+}
+
+/**
+ * @brief 输出全部已登记的统计
+ * @param  os               My Pan doc
+ * */
+inline void dump_alloc_stats(std::ostream& os = std::cerr) {
+  for (alloc_stats* s = alloc_stats::head().load(std::memory_order_acquire);
+       s != nullptr; s = s->next) {
+    os << s->name << '\n'
+       << "  allocs : " << s->allocs.load(std::memory_order_relaxed)
+       << "  deallocs : " << s->deallocs.load(std::memory_order_relaxed)
+       << "  live bytes : " << s->bytes_live.load(std::memory_order_relaxed)
+       << "  peak bytes : " << s->peak_bytes.load(std::memory_order_relaxed)
+       << '\n';
+    for (size_t k = 0; k < ALLOC_STATS_BUCKETS; ++k) {
+      const size_t count = s->histogram[k].load(std::memory_order_relaxed);
+      if (count != 0) {
+        os << "    [2^" << k << ", 2^" << k + 1 << ") : " << count << '\n';
+      }
+    }
+  }
+  os.flush();
+}
+
+/**
+ * @brief 在 Alloc 之上记录分配统计的 allocator
+ * @tparam Alloc            实际完成分配的 allocator
+ * @tparam Tag              统计的分组标签, 通常对应容器类型
+ * */
+template <class Alloc, class Tag>
+class instrumented_allocator : private alloc_holder<Alloc> {
+  typedef alloc_holder<Alloc>     alloc_base;
+  typedef allocator_traits<Alloc> base_traits;
+
+public:
+  typedef typename Alloc::value_type      value_type;
+  typedef typename Alloc::pointer         pointer;
+  typedef typename Alloc::const_pointer   const_pointer;
+  typedef typename Alloc::reference       reference;
+  typedef typename Alloc::const_reference const_reference;
+  typedef typename Alloc::size_type       size_type;
+  typedef typename Alloc::difference_type difference_type;
+
+  typedef typename base_traits::propagate_on_container_copy_assignment
+      propagate_on_container_copy_assignment;
+  typedef typename base_traits::propagate_on_container_move_assignment
+      propagate_on_container_move_assignment;
+  typedef typename base_traits::propagate_on_container_swap
+      propagate_on_container_swap;
+  typedef typename base_traits::is_always_equal is_always_equal;
+
+  template <class U>
+  struct rebind {
+    typedef instrumented_allocator<
+        typename base_traits::template rebind_alloc<U>, Tag>
+        other;
+  };
+
+  instrumented_allocator() : alloc_base() {
+  }
+
+  explicit instrumented_allocator(const Alloc& a) : alloc_base(a) {
+  }
+
+  template <class A>
+  instrumented_allocator(const instrumented_allocator<A, Tag>& rhs)
+      : alloc_base(Alloc(rhs.base())) {
+  }
+
+  const Alloc& base() const noexcept {
+    return this->get_alloc();
+  }
+
+  instrumented_allocator select_on_container_copy_construction() const {
+    return instrumented_allocator(
+        base_traits::select_on_container_copy_construction(base()));
+  }
+
+  pointer allocate() {
+    pointer p = this->get_alloc().allocate();
+    stats().record_allocate(sizeof(value_type));
+    return p;
+  }
+
+  pointer allocate(size_type n) {
+    pointer p = this->get_alloc().allocate(n);
+    if (n != 0) {
+      stats().record_allocate(n * sizeof(value_type));
+    }
+    return p;
+  }
+
+  void deallocate(pointer p) {
+    if (nullptr == p) return;
+    stats().record_deallocate(sizeof(value_type));
+    this->get_alloc().deallocate(p);
+  }
+
+  void deallocate(pointer p, size_type n) {
+    if (nullptr == p) return;
+    stats().record_deallocate(n * sizeof(value_type));
+    this->get_alloc().deallocate(p, n);
+  }
+
+  bool try_expand(pointer p, size_type old_n, size_type new_n) {
+    if (!base_traits::try_expand(this->get_alloc(), p, old_n, new_n)) {
+      return false;
+    }
+    stats().record_reallocate(old_n * sizeof(value_type),
+                              new_n * sizeof(value_type));
+    return true;
+  }
+
+  // 只有 Alloc 提供 reallocate 时才存在
+  template <class A = Alloc>
+  auto reallocate(pointer p, size_type old_n, size_type new_n)
+      -> decltype(std::declval<A&>().reallocate(p, old_n, new_n)) {
+    pointer q = this->get_alloc().reallocate(p, old_n, new_n);
+    stats().record_reallocate(old_n * sizeof(value_type),
+                              new_n * sizeof(value_type));
+    return q;
+  }
+
+  size_type good_size(size_type n) const {
+    return base_traits::good_size(this->get_alloc(), n);
+  }
+
+  template <class... Args>
+  void construct(pointer p, Args&&... args) {
+    this->get_alloc().construct(p, Mystl::forward<Args>(args)...);
+  }
+
+  void destroy(pointer p) {
+    this->get_alloc().destroy(p);
+  }
+
+  void destroy(pointer first, pointer last) {
+    this->get_alloc().destroy(first, last);
+  }
+
+  static alloc_stats& stats() {
+    return stats_for<Tag, value_type>();
+  }
+};
+
+template <class Alloc, class Tag>
+bool operator==(const instrumented_allocator<Alloc, Tag>& lhs,
+                const instrumented_allocator<Alloc, Tag>& rhs) {
+  return allocator_traits<Alloc>::equal(lhs.base(), rhs.base());
+}
+
+template <class Alloc, class Tag>
+bool operator!=(const instrumented_allocator<Alloc, Tag>& lhs,
+                const instrumented_allocator<Alloc, Tag>& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace Mystl
+
+#endif /* __ALLOC_STATS_H__ */
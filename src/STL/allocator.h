@@ -11,11 +11,66 @@
 #ifndef __ALLOCATOR_H__
 #define __ALLOCATOR_H__
 
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 #include "construct.h"
+#include "type_traits.h"
 #include "util.h"
 
 namespace Mystl {
 
+/**
+ * @brief 按 align 对齐分配 bytes 字节, 失败时抛出 std::bad_alloc
+ * @param  bytes            My Pan doc
+ * @param  align            必须是 2 的幂
+ * @return void*            以 aligned_deallocate 释放
+ * */
+inline void* aligned_allocate(size_t bytes, size_t align) {
+  if (align < sizeof(void*)) align = sizeof(void*);
+  void* p = nullptr;
+  if (::posix_memalign(&p, align, bytes == 0 ? 1 : bytes) != 0) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+inline void aligned_deallocate(void* p) noexcept {
+  ::free(p);
+}
+
+/**
+ * @brief 申请 bytes 字节时 malloc 实际给出的块大小。按 jemalloc 的 size
+ *        class 计算: 128 字节以内以 16 字节为间隔, 之后每个 2 的幂区间分
+ *        为 4 档; glibc malloc 的块以 16 字节为间隔, 按这张表取整同样不会
+ *        超出实际得到的空间太多
+ * @param  bytes            My Pan doc
+ * @return size_t
+ * */
+inline size_t size_class_bytes(size_t bytes) noexcept {
+  if (bytes <= 8) {
+    return 8;
+  }
+  if (bytes <= 128) {
+    return (bytes + 15) & ~static_cast<size_t>(15);
+  }
+  size_t lg = 0;  // 2^lg < bytes <= 2^(lg + 1)
+  for (size_t x = bytes - 1; x > 1; x >>= 1) {
+    ++lg;
+  }
+  const size_t delta = static_cast<size_t>(1) << (lg - 2);
+  const size_t size  = (bytes + delta - 1) & ~(delta - 1);
+  return size < bytes ? bytes : size;
+}
+
+// 对齐要求超过 ::operator new 所保证的基本对齐的类型
+template <class T>
+struct is_over_aligned
+    : m_bool_constant<(alignof(T) > alignof(std::max_align_t))> {};
+
 template <class T>
 class allocator {
 public:
@@ -27,6 +82,18 @@ public:
   typedef size_t    size_type;
   typedef ptrdiff_t difference_type;
 
+  template <class U>
+  struct rebind {
+    typedef allocator<U> other;
+  };
+
+  allocator() noexcept {
+  }
+
+  template <class U>
+  allocator(const allocator<U>&) noexcept {
+  }
+
   static T* allocate();
   static T* allocate(size_type n);
 
@@ -42,11 +109,51 @@ public:
 
   static void destroy(T* ptr);
   static void destroy(T* ptr, T* last);
+
+  // 按字节搬移地扩大或缩小 ptr 处的空间, 只能用于可平凡复制的类型
+  static T* reallocate(T* ptr, size_type old_n, size_type new_n);
+
+  // 申请 n 个对象时 malloc 实际给出的空间可以容纳的对象个数
+  static size_type good_size(size_type n) noexcept {
+    return size_class_bytes(n * sizeof(T)) / sizeof(T);
+  }
+
+private:
+  // 超对齐类型改用 aligned_allocate, 两条路径都以 free 释放
+  static void* raw_allocate(size_t bytes, m_false_type) {
+    void* p = std::malloc(bytes);
+    if (nullptr == p) {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+  static void* raw_allocate(size_t bytes, m_true_type) {
+    return aligned_allocate(bytes, alignof(T));
+  }
+
+  // realloc 在 glibc 中对大块内存使用 mremap, 不需要复制
+  static void* raw_reallocate(void* ptr, size_t, size_t new_bytes,
+                              m_false_type) {
+    void* p = std::realloc(ptr, new_bytes);
+    if (nullptr == p) {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+  static void* raw_reallocate(void* ptr, size_t old_bytes, size_t new_bytes,
+                              m_true_type) {
+    void* p = aligned_allocate(new_bytes, alignof(T));
+    if (ptr != nullptr) {
+      std::memcpy(p, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+      aligned_deallocate(ptr);
+    }
+    return p;
+  }
 };
 
 template <typename T>
 T* allocator<T>::allocate() {
-  return static_cast<T*>(::operator new(sizeof(T)));
+  return static_cast<T*>(raw_allocate(sizeof(T), is_over_aligned<T>()));
 }
 
 template <typename T>
@@ -55,19 +162,26 @@ T* allocator<T>::allocate(size_type n) {
     return nullptr;
   }
 
-  return static_cast<T*>(::operator new(n * sizeof(T)));
+  return static_cast<T*>(raw_allocate(n * sizeof(T), is_over_aligned<T>()));
 }
 
 template <typename T>
 void allocator<T>::deallocate(T* ptr) {
   if (nullptr == ptr) return;
-  ::operator delete(ptr);
+  std::free(ptr);
 }
 
 template <typename T>
 void allocator<T>::deallocate(T* ptr, size_type) {
   if (nullptr == ptr) return;
-  ::operator delete(ptr);
+  std::free(ptr);
+}
+
+template <typename T>
+T* allocator<T>::reallocate(T* ptr, size_type old_n, size_type new_n) {
+  return static_cast<T*>(raw_reallocate(ptr, old_n * sizeof(T),
+                                        new_n * sizeof(T),
+                                        is_over_aligned<T>()));
 }
 
 template <typename T>
@@ -88,7 +202,7 @@ void allocator<T>::construct(T* ptr, T&& value) {
 template <typename T>
 template <typename... Args>
 void allocator<T>::construct(T* ptr, Args&&... args) {
-  Mystl::construct(ptr, Mystl::forward<Args>(args)....);
+  Mystl::construct(ptr, Mystl::forward<Args>(args)...);
 }
 
 template <typename T>
@@ -101,6 +215,209 @@ void allocator<T>::destroy(T* first, T* last) {
   Mystl::destroy(first, last);
 }
 
+/**
+ * @brief 萃取 allocator 在容器复制、移动、交换时的传播策略。allocator
+ *        未定义对应的嵌套类型时, 三种传播均为 false, 空类 allocator 视为
+ *        总是相等
+ * @tparam Alloc
+ * */
+template <class Alloc>
+struct allocator_traits {
+private:
+  struct two {
+    char a;
+    char b;
+  };
+
+  template <class U>
+  static two test_pocca(...);
+  template <class U>
+  static char test_pocca(
+      typename U::propagate_on_container_copy_assignment* = 0);
+
+  template <class U>
+  static two test_pocma(...);
+  template <class U>
+  static char test_pocma(
+      typename U::propagate_on_container_move_assignment* = 0);
+
+  template <class U>
+  static two test_pocs(...);
+  template <class U>
+  static char test_pocs(typename U::propagate_on_container_swap* = 0);
+
+  template <class U>
+  static two test_equal(...);
+  template <class U>
+  static char test_equal(typename U::is_always_equal* = 0);
+
+  template <class U, bool>
+  struct pocca_imp : m_false_type {};
+  template <class U>
+  struct pocca_imp<U, true>
+      : m_bool_constant<U::propagate_on_container_copy_assignment::value> {};
+
+  template <class U, bool>
+  struct pocma_imp : m_false_type {};
+  template <class U>
+  struct pocma_imp<U, true>
+      : m_bool_constant<U::propagate_on_container_move_assignment::value> {};
+
+  template <class U, bool>
+  struct pocs_imp : m_false_type {};
+  template <class U>
+  struct pocs_imp<U, true>
+      : m_bool_constant<U::propagate_on_container_swap::value> {};
+
+  template <class U, bool>
+  struct equal_imp : m_bool_constant<std::is_empty<U>::value> {};
+  template <class U>
+  struct equal_imp<U, true> : m_bool_constant<U::is_always_equal::value> {};
+
+  template <class U>
+  static auto select_imp(const U& a, int)
+      -> decltype(a.select_on_container_copy_construction()) {
+    return a.select_on_container_copy_construction();
+  }
+
+  template <class U>
+  static U select_imp(const U& a, long) {
+    return a;
+  }
+
+  template <class U>
+  static two test_reallocate(...);
+  template <class U>
+  static char test_reallocate(
+      decltype(std::declval<U&>().reallocate(
+          std::declval<typename U::pointer>(), size_t(), size_t()))* = 0);
+
+  template <class U>
+  static auto try_expand_imp(U&                  a,
+                             typename U::pointer p,
+                             size_t              old_n,
+                             size_t              new_n,
+                             int) -> decltype(a.try_expand(p, old_n, new_n)) {
+    return a.try_expand(p, old_n, new_n);
+  }
+
+  template <class U>
+  static bool try_expand_imp(U&, typename U::pointer, size_t, size_t, long) {
+    return false;
+  }
+
+  template <class U>
+  static auto good_size_imp(const U& a, size_t n, int)
+      -> decltype(a.good_size(n)) {
+    return a.good_size(n);
+  }
+
+  template <class U>
+  static size_t good_size_imp(const U&, size_t n, long) {
+    return n;
+  }
+
+public:
+  typedef Alloc allocator_type;
+
+  template <class U>
+  using rebind_alloc = typename Alloc::template rebind<U>::other;
+
+  typedef pocca_imp<Alloc, sizeof(test_pocca<Alloc>(0)) == sizeof(char)>
+      propagate_on_container_copy_assignment;
+  typedef pocma_imp<Alloc, sizeof(test_pocma<Alloc>(0)) == sizeof(char)>
+      propagate_on_container_move_assignment;
+  typedef pocs_imp<Alloc, sizeof(test_pocs<Alloc>(0)) == sizeof(char)>
+      propagate_on_container_swap;
+  typedef equal_imp<Alloc, sizeof(test_equal<Alloc>(0)) == sizeof(char)>
+      is_always_equal;
+
+  // allocator 是否提供 reallocate(p, old_n, new_n), 它按字节搬移原有内容,
+  // 可能移动缓冲区, 失败时抛出异常且原缓冲区不变
+  typedef m_bool_constant<sizeof(test_reallocate<Alloc>(0)) == sizeof(char)>
+      has_reallocate;
+
+  // 复制构造容器时使用的 allocator
+  static Alloc select_on_container_copy_construction(const Alloc& a) {
+    return select_imp(a, 0);
+  }
+
+  // 尝试在原地把 p 处 old_n 个对象的空间扩大到 new_n 个,
+  // allocator 没有提供 try_expand 时总是返回 false
+  static bool try_expand(Alloc&                  a,
+                         typename Alloc::pointer p,
+                         size_t                  old_n,
+                         size_t                  new_n) {
+    return try_expand_imp(a, p, old_n, new_n, 0);
+  }
+
+  // 申请 n 个对象时 allocator 实际给出的空间可以容纳的对象个数,
+  // allocator 没有提供 good_size 时返回 n
+  static size_t good_size(const Alloc& a, size_t n) {
+    return good_size_imp(a, n, 0);
+  }
+
+  // 两个 allocator 能否互相释放对方分配的内存
+  static bool equal(const Alloc& lhs, const Alloc& rhs) {
+    return equal_dispatch(lhs, rhs, is_always_equal());
+  }
+
+private:
+  static bool equal_dispatch(const Alloc&, const Alloc&, m_true_type) {
+    return true;
+  }
+
+  static bool equal_dispatch(const Alloc& lhs,
+                             const Alloc& rhs,
+                             m_false_type) {
+    return lhs == rhs;
+  }
+};
+
+/**
+ * @brief 容器保存 allocator 实例的基类, allocator 为空类时利用空基类优化
+ *        不占用空间
+ * @tparam Alloc
+ * */
+template <class Alloc, bool = std::is_empty<Alloc>::value>
+class alloc_holder : private Alloc {
+public:
+  alloc_holder() : Alloc() {
+  }
+
+  explicit alloc_holder(const Alloc& a) : Alloc(a) {
+  }
+
+  Alloc& get_alloc() noexcept {
+    return *this;
+  }
+
+  const Alloc& get_alloc() const noexcept {
+    return *this;
+  }
+};
+
+template <class Alloc>
+class alloc_holder<Alloc, false> {
+public:
+  alloc_holder() : alloc_() {
+  }
+
+  explicit alloc_holder(const Alloc& a) : alloc_(a) {
+  }
+
+  Alloc& get_alloc() noexcept {
+    return alloc_;
+  }
+
+  const Alloc& get_alloc() const noexcept {
+    return alloc_;
+  }
+
+private:
+  Alloc alloc_;
+};
+
 }  // namespace Mystl
 
 #endif /* __ALLOCATOR_H__ */
@@ -0,0 +1,294 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file arena.h
+ * @brief 单调增长的 arena 内存资源及对应的 allocator
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-14 09:05:36
+ *
+ * monotonic_arena 以指针递增的方式从 chunk 中切出内存, 释放单个对象时
+ * 什么也不做, 只在 release() 或析构时一次性归还全部 chunk。适用于生命
+ * 周期一致的一组容器, 例如一次请求内构建、请求结束时整体丢弃的数据。
+ *
+ * arena_allocator 把分配请求转发给它绑定的 arena, 默认构造时绑定当前
+ * 线程上由 arena_scope 安装的 arena。
+ *
+ * */
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "construct.h"
+#include "exceptdef.h"
+#include "util.h"
+
+namespace Mystl {
+
+/**
+ * @brief 单调增长的内存资源
+ * */
+class monotonic_arena {
+public:
+  explicit monotonic_arena(size_t initial_size = 4096)
+      : chunks_(nullptr),
+        cur_(nullptr),
+        end_(nullptr),
+        buffer_(nullptr),
+        buffer_size_(0),
+        initial_size_(initial_size < 64 ? 64 : initial_size),
+        next_size_(initial_size_) {
+  }
+
+  // 先使用调用者提供的缓冲区(例如栈上数组), 用完后再向系统申请
+  monotonic_arena(void* buffer, size_t size)
+      : chunks_(nullptr),
+        cur_(static_cast<char*>(buffer)),
+        end_(static_cast<char*>(buffer) + size),
+        buffer_(static_cast<char*>(buffer)),
+        buffer_size_(size),
+        initial_size_(size < 64 ? 64 : size),
+        next_size_(initial_size_) {
+  }
+
+  ~monotonic_arena() {
+    release();
+  }
+
+  /**
+   * @brief 分配 bytes 字节, 按 align 对齐
+   * @param  bytes            My Pan doc
+   * @param  align            必须是 2 的幂
+   * @return void*
+   * */
+  void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+    MYSTL_DEBUG((align & (align - 1)) == 0);
+    char* p = align_up(cur_, align);
+    if (cur_ == nullptr || p > end_ ||
+        static_cast<size_t>(end_ - p) < bytes) {
+      p = new_chunk(bytes, align);
+    }
+    cur_ = p + bytes;
+    return p;
+  }
+
+  // 单个对象的释放是空操作
+  void deallocate(void*, size_t) noexcept {
+  }
+
+  /**
+   * @brief p 是最近一次分配且当前 chunk 剩余足够时, 原地扩大到 new_bytes
+   * @param  p                My Pan doc
+   * @param  old_bytes        My Pan doc
+   * @param  new_bytes        My Pan doc
+   * @return bool
+   * */
+  bool try_expand(void* p, size_t old_bytes, size_t new_bytes) noexcept {
+    char* q = static_cast<char*>(p);
+    if (q + old_bytes != cur_ || static_cast<size_t>(end_ - q) < new_bytes) {
+      return false;
+    }
+    cur_ = q + new_bytes;
+    return true;
+  }
+
+  // 一次性归还全部 chunk, 之后 arena 可以继续使用
+  void release() noexcept {
+    while (chunks_ != nullptr) {
+      chunk_header* next = chunks_->next;
+      ::operator delete(chunks_);
+      chunks_ = next;
+    }
+    cur_       = buffer_;
+    end_       = buffer_ == nullptr ? nullptr : buffer_ + buffer_size_;
+    next_size_ = initial_size_;
+  }
+
+  // 从系统申请的总字节数, 不含调用者提供的缓冲区
+  size_t bytes_reserved() const noexcept {
+    size_t total = 0;
+    for (chunk_header* c = chunks_; c != nullptr; c = c->next) {
+      total += c->size;
+    }
+    return total;
+  }
+
+private:
+  struct chunk_header {
+    chunk_header* next;
+    size_t        size;
+  };
+
+  static char* align_up(char* p, size_t align) {
+    const uintptr_t v = reinterpret_cast<uintptr_t>(p);
+    return reinterpret_cast<char*>((v + align - 1) & ~(align - 1));
+  }
+
+  // 申请一个新的 chunk, chunk 大小按几何级数增长; 翻倍会溢出时恰好
+  // 申请 need 字节, 所需大小本身无法表示时抛出 std::bad_alloc
+  char* new_chunk(size_t bytes, size_t align) {
+    const size_t max_size = static_cast<size_t>(-1);
+    if (bytes > max_size - sizeof(chunk_header) - align) {
+      throw std::bad_alloc();
+    }
+    const size_t need = sizeof(chunk_header) + bytes + align;
+    size_t       size = next_size_;
+    while (size < need) {
+      size = size > max_size / 2 ? need : size * 2;
+    }
+    chunk_header* c = static_cast<chunk_header*>(::operator new(size));
+    c->next         = chunks_;
+    c->size         = size;
+    chunks_         = c;
+    next_size_      = size > max_size / 2 ? size : size * 2;
+
+    end_ = reinterpret_cast<char*>(c) + size;
+    return align_up(reinterpret_cast<char*>(c + 1), align);
+  }
+
+  monotonic_arena(const monotonic_arena&);
+  void operator=(const monotonic_arena&);
+
+  chunk_header* chunks_;        // 已申请的 chunk 链表
+  char*         cur_;           // 当前 chunk 中下一个可用位置
+  char*         end_;           // 当前 chunk 的结束位置
+  char*         buffer_;        // 调用者提供的初始缓冲区
+  size_t        buffer_size_;   // 初始缓冲区大小
+  size_t        initial_size_;  // 第一个 chunk 的大小
+  size_t        next_size_;     // 下一个 chunk 的大小
+};
+
+// 当前线程正在使用的 arena
+inline monotonic_arena*& current_arena() {
+  static thread_local monotonic_arena* arena = nullptr;
+  return arena;
+}
+
+/**
+ * @brief 在作用域内把 arena 安装为当前线程的 arena, 离开作用域时恢复
+ * */
+class arena_scope {
+public:
+  explicit arena_scope(monotonic_arena& arena) : prev_(current_arena()) {
+    current_arena() = &arena;
+  }
+
+  ~arena_scope() {
+    current_arena() = prev_;
+  }
+
+private:
+  arena_scope(const arena_scope&);
+  void operator=(const arena_scope&);
+
+  monotonic_arena* prev_;
+};
+
+/**
+ * @brief 从 arena 分配的 allocator, deallocate 为空操作。默认构造时绑定
+ *        当前线程上由 arena_scope 安装的 arena
+ * @tparam T
+ * */
+template <class T>
+class arena_allocator {
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <class U>
+  struct rebind {
+    typedef arena_allocator<U> other;
+  };
+
+  arena_allocator() noexcept : arena_(current_arena()) {
+  }
+
+  arena_allocator(monotonic_arena& arena) noexcept : arena_(&arena) {
+  }
+
+  template <class U>
+  arena_allocator(const arena_allocator<U>& rhs) noexcept
+      : arena_(rhs.arena()) {
+  }
+
+  monotonic_arena* arena() const noexcept {
+    return arena_;
+  }
+
+  T* allocate() {
+    return allocate(1);
+  }
+
+  T* allocate(size_type n) {
+    if (0 == n) {
+      return nullptr;
+    }
+    THROW_RUNTIME_ERROR_IF(arena_ == nullptr,
+                           "arena_allocator<T> used without an arena");
+    if (n > static_cast<size_type>(-1) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*) noexcept {
+  }
+
+  void deallocate(T*, size_type) noexcept {
+  }
+
+  bool try_expand(T* ptr, size_type old_n, size_type new_n) noexcept {
+    return arena_ != nullptr &&
+           arena_->try_expand(ptr, old_n * sizeof(T), new_n * sizeof(T));
+  }
+
+  static void construct(T* ptr) {
+    Mystl::construct(ptr);
+  }
+
+  static void construct(T* ptr, const T& value) {
+    Mystl::construct(ptr, value);
+  }
+
+  static void construct(T* ptr, T&& value) {
+    Mystl::construct(ptr, Mystl::move(value));
+  }
+
+  template <class... Args>
+  static void construct(T* ptr, Args&&... args) {
+    Mystl::construct(ptr, Mystl::forward<Args>(args)...);
+  }
+
+  static void destroy(T* ptr) {
+    Mystl::destroy(ptr);
+  }
+
+  static void destroy(T* first, T* last) {
+    Mystl::destroy(first, last);
+  }
+
+private:
+  monotonic_arena* arena_;  // 所属的 arena
+};
+
+template <class T, class U>
+bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) {
+  return lhs.arena() == rhs.arena();
+}
+
+template <class T, class U>
+bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace Mystl
+
+#endif /* __ARENA_H__ */
@@ -16,6 +16,7 @@
 
 #include "iterator.h"
 #include "type_traits.h"
+#include "util.h"
 
 namespace Mystl {
 template <class Ty>
@@ -23,6 +24,12 @@ void construct(Ty *ptr) {
   ::new ((void *)ptr) Ty();
 }
 
+// 默认初始化, 平凡类型的值不确定
+template <class Ty>
+void default_construct(Ty *ptr) {
+  ::new ((void *)ptr) Ty;
+}
+
 template <class Ty1, class Ty2>
 void construct(Ty1 *ptr, const Ty2 &value) {
   ::new ((void *)ptr) Ty1(value);
@@ -49,6 +56,13 @@ template <class ForwardIter>
 void destroy_cat(ForwardIter, ForwardIter, std::true_type) {
 }
 
+template <class ForwardIter>
+void destroy_cat(ForwardIter first, ForwardIter last, std::false_type) {
+  for (; first != last; ++first) {
+    destroy_one(&*first, std::false_type{});
+  }
+}
+
 template <class Ty>
 void destroy(Ty *pointer) {
   destroy_one(pointer, std::is_trivially_destructible<Ty>{});
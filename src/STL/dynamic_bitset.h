@@ -0,0 +1,457 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file dynamic_bitset.h
+ * @brief 长度可变的位集合, 代替被弃用的 vector<bool>
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-22 16:05:44
+ *
+ * dynamic_bitset 以 64 位的字为单位保存在 Mystl::vector 中, 每个 bool 只占
+ * 一位。最后一个字中超出 size() 的位始终为 0, 因此 count、比较与按字的
+ * 集合运算都不需要特殊处理尾部。
+ *
+ * count / find_first / find_next 使用编译器提供的 popcount 与
+ * count-trailing-zeros 内建函数; x86 上需要以 -mpopcnt 或 -march 编译
+ * 才会生成 popcnt 指令。&=, |=, ^= 与 and_not 是逐字的简单循环, 由编译器
+ * 自动向量化。
+ *
+ * */
+
+#ifndef __DYNAMIC_BITSET_H__
+#define __DYNAMIC_BITSET_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif  // _MSC_VER
+
+#include "exceptdef.h"
+#include "util.h"
+#include "vector.h"
+
+namespace Mystl {
+
+/**
+ * @brief 统计 x 中为 1 的位数
+ * @param  x                My Pan doc
+ * @return unsigned
+ * */
+inline unsigned popcount64(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return static_cast<unsigned>(__popcnt64(x));
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+#endif  // __GNUC__ || __clang__
+}
+
+/**
+ * @brief 最低位的 1 所在的位置, x 不能为 0
+ * @param  x                My Pan doc
+ * @return unsigned
+ * */
+inline unsigned ctz64(uint64_t x) noexcept {
+  MYSTL_DEBUG(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return static_cast<unsigned>(index);
+#else
+  unsigned n = 0;
+  for (; (x & 1) == 0; x >>= 1) {
+    ++n;
+  }
+  return n;
+#endif  // __GNUC__ || __clang__
+}
+
+/**
+ * @brief 长度可变的位集合
+ * */
+class dynamic_bitset {
+public:
+  typedef uint64_t word_type;
+  typedef size_t   size_type;
+
+  enum { bits_per_word = 64 };
+
+  // 查找失败时的返回值。头文件中无法给出静态成员的类外定义, 按引用传递
+  // 时会链接失败, 因此用枚举
+  enum : size_type { npos = static_cast<size_type>(-1) };
+
+  // 指向某一位的代理引用
+  class reference {
+    friend class dynamic_bitset;
+
+    reference(word_type* word, word_type mask) noexcept
+        : word_(word), mask_(mask) {
+    }
+
+  public:
+    operator bool() const noexcept {
+      return (*word_ & mask_) != 0;
+    }
+
+    bool operator~() const noexcept {
+      return (*word_ & mask_) == 0;
+    }
+
+    reference& operator=(bool value) noexcept {
+      if (value) {
+        *word_ |= mask_;
+      } else {
+        *word_ &= ~mask_;
+      }
+      return *this;
+    }
+
+    reference& operator=(const reference& rhs) noexcept {
+      return *this = static_cast<bool>(rhs);
+    }
+
+    reference& flip() noexcept {
+      *word_ ^= mask_;
+      return *this;
+    }
+
+  private:
+    word_type* word_;
+    word_type  mask_;
+  };
+
+  dynamic_bitset() noexcept : words_(), size_(0) {
+  }
+
+  explicit dynamic_bitset(size_type n, bool value = false)
+      : words_(word_count(n), value ? ~word_type(0) : word_type(0)),
+        size_(n) {
+    clear_unused();
+  }
+
+  // 容量相关
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  size_type size() const noexcept {
+    return size_;
+  }
+
+  size_type num_words() const noexcept {
+    return words_.size();
+  }
+
+  size_type capacity() const noexcept {
+    return words_.capacity() * bits_per_word;
+  }
+
+  void reserve(size_type n) {
+    words_.reserve(word_count(n));
+  }
+
+  void resize(size_type n, bool value = false);
+
+  void clear() noexcept {
+    words_.clear();
+    size_ = 0;
+  }
+
+  void push_back(bool value) {
+    if (size_ % bits_per_word == 0) {
+      words_.push_back(word_type(0));
+    }
+    ++size_;
+    set(size_ - 1, value);
+  }
+
+  void pop_back() {
+    MYSTL_DEBUG(!empty());
+    --size_;
+    if (size_ % bits_per_word == 0) {
+      words_.pop_back();
+    } else {
+      clear_unused();
+    }
+  }
+
+  // 访问元素相关操作
+  bool operator[](size_type pos) const {
+    MYSTL_DEBUG(pos < size_);
+    return (words_[word_index(pos)] & bit_mask(pos)) != 0;
+  }
+
+  reference operator[](size_type pos) {
+    MYSTL_DEBUG(pos < size_);
+    return reference(&words_[word_index(pos)], bit_mask(pos));
+  }
+
+  bool test(size_type pos) const {
+    THROW_OUT_OF_RANGE_IF(!(pos < size_),
+                          "dynamic_bitset::test() subscript out of range");
+    return (*this)[pos];
+  }
+
+  const word_type* data() const noexcept {
+    return words_.data();
+  }
+
+  // 修改元素相关操作
+  dynamic_bitset& set(size_type pos, bool value = true) {
+    (*this)[pos] = value;
+    return *this;
+  }
+
+  dynamic_bitset& reset(size_type pos) {
+    return set(pos, false);
+  }
+
+  dynamic_bitset& flip(size_type pos) {
+    (*this)[pos].flip();
+    return *this;
+  }
+
+  dynamic_bitset& set() noexcept {
+    Mystl::fill(words_.begin(), words_.end(), ~word_type(0));
+    clear_unused();
+    return *this;
+  }
+
+  dynamic_bitset& reset() noexcept {
+    Mystl::fill(words_.begin(), words_.end(), word_type(0));
+    return *this;
+  }
+
+  dynamic_bitset& flip() noexcept;
+
+  // 统计与查找
+  size_type count() const noexcept;
+
+  bool any() const noexcept;
+
+  bool none() const noexcept {
+    return !any();
+  }
+
+  bool all() const noexcept {
+    return count() == size_;
+  }
+
+  // 第一个为 1 的位, 不存在时返回 npos
+  size_type find_first() const noexcept {
+    return find_from(0);
+  }
+
+  // pos 之后第一个为 1 的位, 不存在时返回 npos
+  size_type find_next(size_type pos) const noexcept;
+
+  // 集合运算, 两者的长度必须相同
+  dynamic_bitset& operator&=(const dynamic_bitset& rhs) noexcept;
+  dynamic_bitset& operator|=(const dynamic_bitset& rhs) noexcept;
+  dynamic_bitset& operator^=(const dynamic_bitset& rhs) noexcept;
+
+  // 清除 rhs 中为 1 的位, 即 *this &= ~rhs
+  dynamic_bitset& and_not(const dynamic_bitset& rhs) noexcept;
+
+  dynamic_bitset operator~() const {
+    dynamic_bitset tmp(*this);
+    tmp.flip();
+    return tmp;
+  }
+
+  void swap(dynamic_bitset& rhs) noexcept {
+    words_.swap(rhs.words_);
+    Mystl::swap(size_, rhs.size_);
+  }
+
+private:
+  static size_type word_count(size_type n) noexcept {
+    return (n + bits_per_word - 1) / bits_per_word;
+  }
+
+  static size_type word_index(size_type pos) noexcept {
+    return pos / bits_per_word;
+  }
+
+  static word_type bit_mask(size_type pos) noexcept {
+    return word_type(1) << (pos % bits_per_word);
+  }
+
+  // 把最后一个字中超出 size_ 的位清零
+  void clear_unused() noexcept {
+    const size_type extra = size_ % bits_per_word;
+    if (extra != 0) {
+      words_.back() &= ~(~word_type(0) << extra);
+    }
+  }
+
+  size_type find_from(size_type first_word) const noexcept;
+
+  Mystl::vector<word_type> words_;  // 按字保存的各位
+  size_type                size_;   // 位数
+};
+
+/*****************************************************************************************/
+
+inline void dynamic_bitset::resize(size_type n, bool value) {
+  const size_type old_size = size_;
+  words_.resize(word_count(n), value ? ~word_type(0) : word_type(0));
+  size_ = n;
+  // 原最后一个字中未使用的位为 0, 需要补上
+  if (value && n > old_size && old_size % bits_per_word != 0) {
+    words_[word_index(old_size)] |= ~word_type(0)
+                                    << (old_size % bits_per_word);
+  }
+  clear_unused();
+}
+
+inline dynamic_bitset& dynamic_bitset::flip() noexcept {
+  word_type*      w = words_.data();
+  const size_type n = words_.size();
+  for (size_type i = 0; i < n; ++i) {
+    w[i] = ~w[i];
+  }
+  clear_unused();
+  return *this;
+}
+
+inline dynamic_bitset::size_type dynamic_bitset::count() const noexcept {
+  const word_type* w   = words_.data();
+  const size_type  n   = words_.size();
+  size_type        sum = 0;
+  for (size_type i = 0; i < n; ++i) {
+    sum += popcount64(w[i]);
+  }
+  return sum;
+}
+
+inline bool dynamic_bitset::any() const noexcept {
+  const word_type* w = words_.data();
+  const size_type  n = words_.size();
+  for (size_type i = 0; i < n; ++i) {
+    if (w[i] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline dynamic_bitset::size_type dynamic_bitset::find_next(
+    size_type pos) const noexcept {
+  if (pos >= size_ || ++pos == size_) {
+    return npos;
+  }
+  const size_type i = word_index(pos);
+  const word_type x = words_[i] & (~word_type(0) << (pos % bits_per_word));
+  if (x != 0) {
+    return i * bits_per_word + ctz64(x);
+  }
+  return find_from(i + 1);
+}
+
+inline dynamic_bitset::size_type dynamic_bitset::find_from(
+    size_type first_word) const noexcept {
+  const word_type* w = words_.data();
+  const size_type  n = words_.size();
+  for (size_type i = first_word; i < n; ++i) {
+    if (w[i] != 0) {
+      return i * bits_per_word + ctz64(w[i]);
+    }
+  }
+  return npos;
+}
+
+inline dynamic_bitset& dynamic_bitset::operator&=(
+    const dynamic_bitset& rhs) noexcept {
+  MYSTL_DEBUG(size_ == rhs.size_);
+  word_type*       w = words_.data();
+  const word_type* r = rhs.words_.data();
+  const size_type  n = words_.size();
+  for (size_type i = 0; i < n; ++i) {
+    w[i] &= r[i];
+  }
+  return *this;
+}
+
+inline dynamic_bitset& dynamic_bitset::operator|=(
+    const dynamic_bitset& rhs) noexcept {
+  MYSTL_DEBUG(size_ == rhs.size_);
+  word_type*       w = words_.data();
+  const word_type* r = rhs.words_.data();
+  const size_type  n = words_.size();
+  for (size_type i = 0; i < n; ++i) {
+    w[i] |= r[i];
+  }
+  return *this;
+}
+
+inline dynamic_bitset& dynamic_bitset::operator^=(
+    const dynamic_bitset& rhs) noexcept {
+  MYSTL_DEBUG(size_ == rhs.size_);
+  word_type*       w = words_.data();
+  const word_type* r = rhs.words_.data();
+  const size_type  n = words_.size();
+  for (size_type i = 0; i < n; ++i) {
+    w[i] ^= r[i];
+  }
+  return *this;
+}
+
+inline dynamic_bitset& dynamic_bitset::and_not(
+    const dynamic_bitset& rhs) noexcept {
+  MYSTL_DEBUG(size_ == rhs.size_);
+  word_type*       w = words_.data();
+  const word_type* r = rhs.words_.data();
+  const size_type  n = words_.size();
+  for (size_type i = 0; i < n; ++i) {
+    w[i] &= ~r[i];
+  }
+  return *this;
+}
+
+/*****************************************************************************************/
+// 重载操作符
+inline bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+  return lhs.size() == rhs.size() &&
+         Mystl::equal(lhs.data(), lhs.data() + lhs.num_words(), rhs.data());
+}
+
+inline bool operator!=(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+  return !(lhs == rhs);
+}
+
+inline dynamic_bitset operator&(const dynamic_bitset& lhs,
+                                const dynamic_bitset& rhs) {
+  dynamic_bitset tmp(lhs);
+  tmp &= rhs;
+  return tmp;
+}
+
+inline dynamic_bitset operator|(const dynamic_bitset& lhs,
+                                const dynamic_bitset& rhs) {
+  dynamic_bitset tmp(lhs);
+  tmp |= rhs;
+  return tmp;
+}
+
+inline dynamic_bitset operator^(const dynamic_bitset& lhs,
+                                const dynamic_bitset& rhs) {
+  dynamic_bitset tmp(lhs);
+  tmp ^= rhs;
+  return tmp;
+}
+
+inline void swap(dynamic_bitset& lhs, dynamic_bitset& rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+}  // namespace Mystl
+
+#endif /* __DYNAMIC_BITSET_H__ */
@@ -0,0 +1,317 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file huge_alloc.h
+ * @brief 指定对齐的 allocator 与以透明大页为后端的 allocator
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-16 10:05:03
+ *
+ * aligned_allocator<T, Align> 按 max(Align, alignof(T)) 对齐分配, 可用于
+ * 需要按 cache line 或 SIMD 宽度对齐的缓冲区。
+ *
+ * huge_page_allocator<T> 对不小于 HUGE_PAGE_SIZE 的请求直接 mmap 一段
+ * 按大页对齐的匿名内存, 并以 MADV_HUGEPAGE 请求内核使用透明大页, 以减少
+ * 大 vector 随机访问时的 TLB miss; 小请求仍交给 Mystl::allocator。非
+ * Linux 平台上大请求退化为按大页对齐的普通分配。
+ *
+ * */
+
+#ifndef __HUGE_ALLOC_H__
+#define __HUGE_ALLOC_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif  // __linux__
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+namespace Mystl {
+
+// 透明大页的大小
+enum { HUGE_PAGE_SIZE = 2 * 1024 * 1024 };
+
+/**
+ * @brief 按 Align 与 alignof(T) 中较大者对齐的 allocator
+ * @tparam T
+ * @tparam Align            必须是 2 的幂
+ * */
+template <class T, size_t Align = alignof(T)>
+class aligned_allocator {
+  static_assert((Align & (Align - 1)) == 0, "Align must be a power of two");
+
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  enum { alignment = Align > alignof(T) ? Align : alignof(T) };
+
+  template <class U>
+  struct rebind {
+    typedef aligned_allocator<U, Align> other;
+  };
+
+  aligned_allocator() noexcept {
+  }
+
+  template <class U>
+  aligned_allocator(const aligned_allocator<U, Align>&) noexcept {
+  }
+
+  static T* allocate() {
+    return allocate(1);
+  }
+
+  static T* allocate(size_type n) {
+    if (0 == n) {
+      return nullptr;
+    }
+    return static_cast<T*>(aligned_allocate(n * sizeof(T), alignment));
+  }
+
+  static void deallocate(T* ptr) {
+    aligned_deallocate(ptr);
+  }
+
+  static void deallocate(T* ptr, size_type) {
+    aligned_deallocate(ptr);
+  }
+
+  static void construct(T* ptr) {
+    Mystl::construct(ptr);
+  }
+
+  static void construct(T* ptr, const T& value) {
+    Mystl::construct(ptr, value);
+  }
+
+  static void construct(T* ptr, T&& value) {
+    Mystl::construct(ptr, Mystl::move(value));
+  }
+
+  template <class... Args>
+  static void construct(T* ptr, Args&&... args) {
+    Mystl::construct(ptr, Mystl::forward<Args>(args)...);
+  }
+
+  static void destroy(T* ptr) {
+    Mystl::destroy(ptr);
+  }
+
+  static void destroy(T* first, T* last) {
+    Mystl::destroy(first, last);
+  }
+};
+
+/**
+ * @brief 申请 bytes 字节按大页对齐的匿名内存, 并建议内核使用透明大页
+ * @param  bytes            已上调至 HUGE_PAGE_SIZE 的倍数
+ * @return void*            以 huge_page_deallocate 释放
+ * */
+inline void* huge_page_allocate(size_t bytes) {
+#if defined(__linux__)
+  // 多映射一个大页, 再裁掉首尾未对齐的部分
+  const size_t map_size = bytes + HUGE_PAGE_SIZE;
+  void*        raw      = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  const uintptr_t begin   = reinterpret_cast<uintptr_t>(raw);
+  const uintptr_t aligned = (begin + HUGE_PAGE_SIZE - 1) &
+                            ~static_cast<uintptr_t>(HUGE_PAGE_SIZE - 1);
+  const size_t    head    = aligned - begin;
+  const size_t    tail    = map_size - head - bytes;
+  if (head > 0) ::munmap(raw, head);
+  if (tail > 0) ::munmap(reinterpret_cast<char*>(aligned + bytes), tail);
+
+#if defined(MADV_HUGEPAGE)
+  // 内核不支持透明大页时 madvise 失败, 内存仍可正常使用
+  ::madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+#endif  // MADV_HUGEPAGE
+  return reinterpret_cast<void*>(aligned);
+#else
+  return aligned_allocate(bytes, HUGE_PAGE_SIZE);
+#endif  // __linux__
+}
+
+/**
+ * @brief 把 huge_page_allocate 得到的 old_bytes 字节扩大到 new_bytes,
+ *        may_move 为 false 时只在原地扩大
+ * @param  p                My Pan doc
+ * @param  old_bytes        My Pan doc
+ * @param  new_bytes        My Pan doc
+ * @param  may_move         My Pan doc
+ * @return void*            失败或平台不支持时返回 nullptr, 原映射不变
+ * */
+inline void* huge_page_remap(void*  p,
+                             size_t old_bytes,
+                             size_t new_bytes,
+                             bool   may_move) noexcept {
+#if defined(__linux__)
+  void* q = ::mremap(p, old_bytes, new_bytes, may_move ? MREMAP_MAYMOVE : 0);
+  return q == MAP_FAILED ? nullptr : q;
+#else
+  (void)p;
+  (void)old_bytes;
+  (void)new_bytes;
+  (void)may_move;
+  return nullptr;
+#endif  // __linux__
+}
+
+inline void huge_page_deallocate(void* p, size_t bytes) noexcept {
+#if defined(__linux__)
+  ::munmap(p, bytes);
+#else
+  (void)bytes;
+  aligned_deallocate(p);
+#endif  // __linux__
+}
+
+/**
+ * @brief 大块请求以透明大页为后端的 allocator, 释放时必须给出与申请时
+ *        相同的个数
+ * @tparam T
+ * */
+template <class T>
+class huge_page_allocator {
+  static_assert(alignof(T) <= HUGE_PAGE_SIZE, "T is over-aligned");
+
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <class U>
+  struct rebind {
+    typedef huge_page_allocator<U> other;
+  };
+
+  huge_page_allocator() noexcept {
+  }
+
+  template <class U>
+  huge_page_allocator(const huge_page_allocator<U>&) noexcept {
+  }
+
+  static T* allocate() {
+    return Mystl::allocator<T>::allocate();
+  }
+
+  static T* allocate(size_type n) {
+    if (0 == n) {
+      return nullptr;
+    }
+    if (!is_huge(n)) {
+      return Mystl::allocator<T>::allocate(n);
+    }
+    return static_cast<T*>(huge_page_allocate(round_up(n * sizeof(T))));
+  }
+
+  static void deallocate(T* ptr) {
+    Mystl::allocator<T>::deallocate(ptr);
+  }
+
+  static void deallocate(T* ptr, size_type n) {
+    if (nullptr == ptr) return;
+    if (!is_huge(n)) {
+      Mystl::allocator<T>::deallocate(ptr, n);
+    } else {
+      huge_page_deallocate(ptr, round_up(n * sizeof(T)));
+    }
+  }
+
+  // 两端都是大页映射时以 mremap 原地扩大
+  static bool try_expand(T* ptr, size_type old_n, size_type new_n) {
+    if (!is_huge(old_n) || !is_huge(new_n)) {
+      return false;
+    }
+    const size_t old_bytes = round_up(old_n * sizeof(T));
+    const size_t new_bytes = round_up(new_n * sizeof(T));
+    return old_bytes == new_bytes ||
+           huge_page_remap(ptr, old_bytes, new_bytes, false) != nullptr;
+  }
+
+  // 按字节搬移地改变空间大小, 大页之间以 mremap 移动映射, 不复制内容
+  static T* reallocate(T* ptr, size_type old_n, size_type new_n) {
+    if (!is_huge(old_n) && !is_huge(new_n)) {
+      return Mystl::allocator<T>::reallocate(ptr, old_n, new_n);
+    }
+    if (is_huge(old_n) && is_huge(new_n)) {
+      void* p = huge_page_remap(ptr, round_up(old_n * sizeof(T)),
+                                round_up(new_n * sizeof(T)), true);
+      if (p != nullptr) {
+        return static_cast<T*>(p);
+      }
+    }
+    T* p = allocate(new_n);
+    if (ptr != nullptr) {
+      std::memcpy(p, ptr, (old_n < new_n ? old_n : new_n) * sizeof(T));
+      deallocate(ptr, old_n);
+    }
+    return p;
+  }
+
+  // 大块请求按整个大页计算
+  static size_type good_size(size_type n) noexcept {
+    if (!is_huge(n)) {
+      return Mystl::allocator<T>::good_size(n);
+    }
+    return round_up(n * sizeof(T)) / sizeof(T);
+  }
+
+  static void construct(T* ptr) {
+    Mystl::construct(ptr);
+  }
+
+  static void construct(T* ptr, const T& value) {
+    Mystl::construct(ptr, value);
+  }
+
+  static void construct(T* ptr, T&& value) {
+    Mystl::construct(ptr, Mystl::move(value));
+  }
+
+  template <class... Args>
+  static void construct(T* ptr, Args&&... args) {
+    Mystl::construct(ptr, Mystl::forward<Args>(args)...);
+  }
+
+  static void destroy(T* ptr) {
+    Mystl::destroy(ptr);
+  }
+
+  static void destroy(T* first, T* last) {
+    Mystl::destroy(first, last);
+  }
+
+private:
+  static bool is_huge(size_type n) {
+    return n * sizeof(T) >= static_cast<size_t>(HUGE_PAGE_SIZE);
+  }
+
+  static size_t round_up(size_t bytes) {
+    return (bytes + HUGE_PAGE_SIZE - 1) &
+           ~static_cast<size_t>(HUGE_PAGE_SIZE - 1);
+  }
+};
+
+}  // namespace Mystl
+
+#endif /* __HUGE_ALLOC_H__ */
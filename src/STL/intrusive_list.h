@@ -0,0 +1,644 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file intrusive_list.h
+ * @brief 侵入式双向链表, 链接已有的对象而不申请节点
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-25 10:05:27
+ *
+ * 对象自身带有挂钩 (intrusive_list_hook), 挂钩与 list_node_base 一样只含
+ * prev / next 两个指针。intrusive_list 把对象的挂钩链在一起:
+ *
+ *   - 插入删除只改指针, 不申请内存, 也不复制对象;
+ *   - 链表不拥有对象, 对象的生命周期由调用者管理, 销毁前需从链表中移除;
+ *   - 可以由对象直接得到其迭代器 (iterator_to), 适合 LRU、定时器等
+ *     先查到对象再调整其位置的场景;
+ *   - 挂钩可以作为基类 (intrusive_base_hook) 或成员 (intrusive_member_hook),
+ *     用不同 Tag 的基类挂钩或多个成员挂钩, 一个对象可以同时位于多个链表。
+ *     成员挂钩以 offsetof 给出位置, 因此对象必须是标准布局类型;
+ *   - intrusive_auto_unlink 模式的挂钩在析构时自动从链表中移除, 也可以
+ *     直接调用 unlink(); 此时链表无法维护元素个数, size() 为 O(n)。
+ *
+ * splice、merge、sort 与 list 的语义相同, sort 与 list 共用自底向上的
+ * 归并排序。
+ *
+ * */
+
+#ifndef __INTRUSIVE_LIST_H__
+#define __INTRUSIVE_LIST_H__
+
+#include <cstddef>
+#include <type_traits>
+
+#include "exceptdef.h"
+#include "functional.h"
+#include "iterator.h"
+#include "list.h"
+#include "util.h"
+
+namespace Mystl {
+
+// 挂钩的链接模式
+enum intrusive_link_mode {
+  intrusive_safe_link,   // 调试模式下检查对象销毁时已从链表中移除
+  intrusive_auto_unlink  // 对象销毁时自动从链表中移除
+};
+
+/**
+ * @brief 链表节点, 只含前后指针; 未链入链表时均为 nullptr
+ * */
+struct intrusive_list_node {
+  intrusive_list_node* prev;  // 前一个节点
+  intrusive_list_node* next;  // 下一个节点
+};
+
+/**
+ * @brief 放在对象中的挂钩, 复制对象时不复制链接状态
+ * @tparam Tag              区分同一对象的多个基类挂钩
+ * @tparam Mode             链接模式
+ * */
+template <class Tag = void, intrusive_link_mode Mode = intrusive_safe_link>
+class intrusive_list_hook : public intrusive_list_node {
+public:
+  typedef Tag tag;
+
+  enum { auto_unlink = Mode == intrusive_auto_unlink };
+
+  intrusive_list_hook() noexcept {
+    prev = next = nullptr;
+  }
+
+  intrusive_list_hook(const intrusive_list_hook&) noexcept {
+    prev = next = nullptr;
+  }
+
+  intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept {
+    return *this;
+  }
+
+  ~intrusive_list_hook() {
+    destroy(m_bool_constant<auto_unlink>());
+  }
+
+  bool is_linked() const noexcept {
+    return next != nullptr;
+  }
+
+  // 从所在链表中移除, 只有 intrusive_auto_unlink 模式可以使用
+  void unlink() noexcept {
+    static_assert(Mode == intrusive_auto_unlink,
+                  "only auto_unlink hooks can unlink themselves");
+    if (is_linked()) {
+      prev->next = next;
+      next->prev = prev;
+      prev = next = nullptr;
+    }
+  }
+
+private:
+  void destroy(m_true_type) noexcept {
+    unlink();
+  }
+
+  void destroy(m_false_type) noexcept {
+    MYSTL_DEBUG(!is_linked());
+  }
+};
+
+/**
+ * @brief 对象以基类的方式继承挂钩
+ * @tparam T
+ * @tparam Hook
+ * */
+template <class T, class Hook = intrusive_list_hook<>>
+struct intrusive_base_hook {
+  typedef Hook hook_type;
+
+  static hook_type* to_hook(T* p) noexcept {
+    return static_cast<hook_type*>(p);
+  }
+
+  static T* to_value(intrusive_list_node* p) noexcept {
+    return static_cast<T*>(static_cast<hook_type*>(p));
+  }
+};
+
+/**
+ * @brief 挂钩是对象的数据成员, 位于对象起始处之后 Offset 字节。由挂钩
+ *        反推对象需要成员的偏移, 只有标准布局类型能以 offsetof 合法地
+ *        取得, 例如:
+ *
+ *          typedef intrusive_member_hook<Foo, intrusive_list_hook<>,
+ *                                        offsetof(Foo, hook)> access;
+ *          intrusive_list<Foo, access> l;
+ * @tparam T                必须是标准布局类型
+ * @tparam Hook
+ * @tparam Offset           offsetof(T, 挂钩成员)
+ * */
+template <class T, class Hook, size_t Offset>
+struct intrusive_member_hook {
+  static_assert(std::is_standard_layout<T>::value,
+                "intrusive_member_hook requires a standard-layout T");
+  static_assert(Offset + sizeof(Hook) <= sizeof(T),
+                "intrusive_member_hook offset is out of T");
+
+  typedef Hook hook_type;
+
+  static hook_type* to_hook(T* p) noexcept {
+    return reinterpret_cast<hook_type*>(reinterpret_cast<char*>(p) + Offset);
+  }
+
+  static T* to_value(intrusive_list_node* p) noexcept {
+    char* hook = reinterpret_cast<char*>(static_cast<hook_type*>(p));
+    return reinterpret_cast<T*>(hook - Offset);
+  }
+};
+
+template <class T, class Access, class Ref, class Ptr>
+struct intrusive_list_iterator
+    : public Mystl::iterator<Mystl::bidirectional_iterator_tag,
+                             T,
+                             ptrdiff_t,
+                             Ptr,
+                             Ref> {
+  typedef Ref                                          reference;
+  typedef Ptr                                          pointer;
+  typedef intrusive_list_node*                         base_ptr;
+  typedef intrusive_list_iterator<T, Access, Ref, Ptr> self;
+
+  base_ptr node_;  // 指向当前节点
+
+  intrusive_list_iterator() noexcept : node_(nullptr) {
+  }
+
+  explicit intrusive_list_iterator(base_ptr x) noexcept : node_(x) {
+  }
+
+  // iterator 可以转换为 const_iterator
+  template <class R, class P>
+  intrusive_list_iterator(
+      const intrusive_list_iterator<T, Access, R, P>& rhs) noexcept
+      : node_(rhs.node_) {
+  }
+
+  // 重载操作符
+  reference operator*() const {
+    return *Access::to_value(node_);
+  }
+
+  pointer operator->() const {
+    return &(operator*());
+  }
+
+  self& operator++() {
+    MYSTL_DEBUG(node_ != nullptr);
+    node_ = node_->next;
+    return *this;
+  }
+
+  self operator++(int) {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  self& operator--() {
+    MYSTL_DEBUG(node_ != nullptr);
+    node_ = node_->prev;
+    return *this;
+  }
+
+  self operator--(int) {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const {
+    return node_ == rhs.node_;
+  }
+
+  bool operator!=(const self& rhs) const {
+    return node_ != rhs.node_;
+  }
+};
+
+/**
+ * @brief 侵入式双向链表, 不可复制
+ * @tparam T
+ * @tparam Access           由对象取得挂钩及由挂钩取得对象的方式
+ * */
+template <class T, class Access = intrusive_base_hook<T>>
+class intrusive_list {
+public:
+  typedef typename Access::hook_type hook_type;
+
+  static_assert(std::is_base_of<intrusive_list_node, hook_type>::value,
+                "hook_type must be an intrusive_list_hook");
+
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  typedef intrusive_list_iterator<T, Access, T&, T*>             iterator;
+  typedef intrusive_list_iterator<T, Access, const T&, const T*> const_iterator;
+  typedef Mystl::reverse_iterator<iterator>       reverse_iterator;
+  typedef Mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  typedef intrusive_list_node* base_ptr;
+
+  // 元素个数是否为 O(1) 维护
+  enum { constant_time_size = !hook_type::auto_unlink };
+
+  intrusive_list() noexcept : size_(0) {
+    reset();
+  }
+
+  template <class Iter>
+  intrusive_list(Iter first, Iter last) : size_(0) {
+    reset();
+    insert(end(), first, last);
+  }
+
+  intrusive_list(const intrusive_list&) = delete;
+  intrusive_list& operator=(const intrusive_list&) = delete;
+
+  intrusive_list(intrusive_list&& rhs) noexcept : size_(0) {
+    reset();
+    take_nodes(rhs);
+  }
+
+  intrusive_list& operator=(intrusive_list&& rhs) noexcept {
+    if (this != &rhs) {
+      clear();
+      take_nodes(rhs);
+    }
+    return *this;
+  }
+
+  // 链表不拥有对象, 析构时只把各元素标记为未链接
+  ~intrusive_list() {
+    clear();
+  }
+
+  // 迭代器相关操作
+  iterator begin() noexcept {
+    return iterator(root_.next);
+  }
+
+  const_iterator begin() const noexcept {
+    return const_iterator(root_.next);
+  }
+
+  iterator end() noexcept {
+    return iterator(&root_);
+  }
+
+  const_iterator end() const noexcept {
+    return const_iterator(const_cast<base_ptr>(&root_));
+  }
+
+  reverse_iterator rbegin() noexcept {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() noexcept {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const noexcept {
+    return begin();
+  }
+
+  const_iterator cend() const noexcept {
+    return end();
+  }
+
+  // 由链表中的对象得到其迭代器
+  iterator iterator_to(reference value) noexcept {
+    MYSTL_DEBUG(Access::to_hook(&value)->is_linked());
+    return iterator(Access::to_hook(&value));
+  }
+
+  const_iterator iterator_to(const_reference value) const noexcept {
+    hook_type* hook = Access::to_hook(const_cast<pointer>(&value));
+    MYSTL_DEBUG(hook->is_linked());
+    return const_iterator(hook);
+  }
+
+  // 容量相关
+  bool empty() const noexcept {
+    return root_.next == &root_;
+  }
+
+  size_type size() const noexcept {
+    return size_dispatch(m_bool_constant<constant_time_size>());
+  }
+
+  // 访问元素相关操作
+  reference front() {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  const_reference front() const {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  reference back() {
+    MYSTL_DEBUG(!empty());
+    return *--end();
+  }
+
+  const_reference back() const {
+    MYSTL_DEBUG(!empty());
+    return *--end();
+  }
+
+  // 修改容器相关操作, value 插入前不能位于任何链表中
+  iterator insert(const_iterator pos, reference value) noexcept {
+    base_ptr node = Access::to_hook(&value);
+    MYSTL_DEBUG(node->next == nullptr);
+    link_nodes(pos.node_, node, node);
+    ++size_;
+    return iterator(node);
+  }
+
+  template <class Iter>
+  void insert(const_iterator pos, Iter first, Iter last) {
+    for (; first != last; ++first) {
+      insert(pos, *first);
+    }
+  }
+
+  void push_front(reference value) noexcept {
+    insert(begin(), value);
+  }
+
+  void push_back(reference value) noexcept {
+    insert(end(), value);
+  }
+
+  void pop_front() noexcept {
+    MYSTL_DEBUG(!empty());
+    erase(begin());
+  }
+
+  void pop_back() noexcept {
+    MYSTL_DEBUG(!empty());
+    erase(iterator(root_.prev));
+  }
+
+  iterator erase(const_iterator pos) noexcept {
+    MYSTL_DEBUG(pos != cend());
+    base_ptr node = pos.node_;
+    base_ptr next = node->next;
+    unlink_nodes(node, node);
+    node->prev = node->next = nullptr;
+    --size_;
+    return iterator(next);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) noexcept {
+    while (first != last) {
+      first = erase(first);
+    }
+    return iterator(last.node_);
+  }
+
+  void clear() noexcept;
+
+  // 把 x 的全部元素移到 pos 之前
+  void splice(const_iterator pos, intrusive_list& x) noexcept {
+    MYSTL_DEBUG(this != &x);
+    if (!x.empty()) {
+      transfer(pos.node_, x.root_.next, &x.root_);
+      size_ += x.size_;
+      x.size_ = 0;
+    }
+  }
+
+  // 把 x 中 it 所指的元素移到 pos 之前
+  void splice(const_iterator pos, intrusive_list& x, const_iterator it) {
+    if (pos != it && pos.node_ != it.node_->next) {
+      transfer(pos.node_, it.node_, it.node_->next);
+      ++size_;
+      --x.size_;
+    }
+  }
+
+  // 把 x 的 [first, last) 移到 pos 之前; 需要维护元素个数时为 O(n)
+  void splice(const_iterator  pos,
+              intrusive_list& x,
+              const_iterator  first,
+              const_iterator  last) {
+    if (first != last && this != &x) {
+      const size_type n =
+          constant_time_size ? Mystl::distance(first, last) : 0;
+      size_ += n;
+      x.size_ -= n;
+    }
+    if (first != last && pos != last) {
+      transfer(pos.node_, first.node_, last.node_);
+    }
+  }
+
+  template <class UnaryPredicate>
+  void remove_if(UnaryPredicate pred);
+
+  void remove(const_reference value) {
+    remove_if([&](const_reference v) { return v == value; });
+  }
+
+  void merge(intrusive_list& x) {
+    merge(x, Mystl::less<T>());
+  }
+
+  // 稳定地合并, 相等时本链表的元素在前; comp 抛出异常时两个链表
+  // 都保持有效
+  template <class Compare>
+  void merge(intrusive_list& x, Compare comp);
+
+  // 稳定排序, 与 list::sort 使用相同的归并排序
+  void sort() {
+    sort(Mystl::less<T>());
+  }
+
+  template <class Compare>
+  void sort(Compare comp) {
+    if (root_.next != root_.prev) {
+      list_merge_sort(&root_, value_of(), comp);
+    }
+  }
+
+  void reverse() noexcept;
+
+  void swap(intrusive_list& rhs) noexcept {
+    intrusive_list tmp(Mystl::move(rhs));
+    rhs.take_nodes(*this);
+    take_nodes(tmp);
+  }
+
+private:
+  typedef const intrusive_list_node* const_base_ptr;
+
+  // 由节点取得元素, 供 list_merge_sort 使用
+  struct value_of {
+    const T& operator()(base_ptr p) const {
+      return *Access::to_value(p);
+    }
+  };
+
+  size_type size_dispatch(m_true_type) const noexcept {
+    return size_;
+  }
+
+  size_type size_dispatch(m_false_type) const noexcept {
+    size_type n = 0;
+    for (const_base_ptr p = root_.next; p != &root_; p = p->next) {
+      ++n;
+    }
+    return n;
+  }
+
+  void reset() noexcept {
+    root_.prev = root_.next = &root_;
+    size_                   = 0;
+  }
+
+  // 本链表为空时接管 rhs 的全部节点
+  void take_nodes(intrusive_list& rhs) noexcept;
+
+  // 在 pos 之前链入 [first, last]
+  static void link_nodes(base_ptr pos, base_ptr first, base_ptr last) noexcept {
+    pos->prev->next = first;
+    first->prev     = pos->prev;
+    pos->prev       = last;
+    last->next      = pos;
+  }
+
+  // 断开 [first, last] 与所在链表的链接
+  static void unlink_nodes(base_ptr first, base_ptr last) noexcept {
+    first->prev->next = last->next;
+    last->next->prev  = first->prev;
+  }
+
+  // 把 [first, last) 移到 pos 之前, pos 不能位于其中
+  static void transfer(base_ptr pos, base_ptr first, base_ptr last) noexcept {
+    base_ptr tail = last->prev;
+    unlink_nodes(first, tail);
+    link_nodes(pos, first, tail);
+  }
+
+  intrusive_list_node root_;  // 哨兵节点
+  size_type           size_;  // 大小, 仅 constant_time_size 时有意义
+};
+
+/**
+ * @brief 清空链表, 逐个把元素标记为未链接
+ * @tparam T
+ * @tparam Access
+ * */
+template <class T, class Access>
+void intrusive_list<T, Access>::clear() noexcept {
+  base_ptr p = root_.next;
+  while (p != &root_) {
+    base_ptr next = p->next;
+    p->prev = p->next = nullptr;
+    p                 = next;
+  }
+  reset();
+}
+
+template <class T, class Access>
+template <class UnaryPredicate>
+void intrusive_list<T, Access>::remove_if(UnaryPredicate pred) {
+  for (iterator it = begin(); it != end();) {
+    if (pred(*it)) {
+      it = erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+/**
+ * @brief 把 x 中的元素按 comp 合并到本链表, 连续小于当前元素的一段一次
+ *        性移过来
+ * @tparam T
+ * @tparam Access
+ * @tparam Compare
+ * @param  x                My Pan doc
+ * @param  comp             My Pan doc
+ * */
+template <class T, class Access>
+template <class Compare>
+void intrusive_list<T, Access>::merge(intrusive_list& x, Compare comp) {
+  if (this == &x) {
+    return;
+  }
+  value_of value;
+  base_ptr f1 = root_.next;
+  base_ptr f2 = x.root_.next;
+  while (f1 != &root_ && f2 != &x.root_) {
+    if (comp(value(f2), value(f1))) {
+      base_ptr  l2 = f2->next;
+      size_type n  = 1;
+      for (; l2 != &x.root_ && comp(value(l2), value(f1)); l2 = l2->next) {
+        ++n;
+      }
+      transfer(f1, f2, l2);
+      size_ += n;
+      x.size_ -= n;
+      f2 = l2;
+    }
+    f1 = f1->next;
+  }
+  splice(end(), x);
+}
+
+template <class T, class Access>
+void intrusive_list<T, Access>::reverse() noexcept {
+  base_ptr p = &root_;
+  do {
+    Mystl::swap(p->prev, p->next);
+    p = p->prev;
+  } while (p != &root_);
+}
+
+template <class T, class Access>
+void intrusive_list<T, Access>::take_nodes(intrusive_list& rhs) noexcept {
+  MYSTL_DEBUG(empty());
+  if (!rhs.empty()) {
+    root_.next       = rhs.root_.next;
+    root_.prev       = rhs.root_.prev;
+    root_.next->prev = &root_;
+    root_.prev->next = &root_;
+    size_            = rhs.size_;
+    rhs.reset();
+  }
+}
+
+template <class T, class Access>
+void swap(intrusive_list<T, Access>& lhs,
+          intrusive_list<T, Access>& rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+}  // namespace Mystl
+
+#endif  // __INTRUSIVE_LIST_H__
@@ -44,9 +44,6 @@ struct iterator {
 // iterator traits
 template <class T>
 struct has_iterator_cat {
-public:
-  static const bool value = sizeof(test<T>(0)) == sizeof(char);
-
 private:
   struct two {
     char a;
@@ -58,6 +55,9 @@ private:
 
   template <class U>
   static char test(typename U::iterator_category* = 0);
+
+public:
+  static const bool value = sizeof(test<T>(0)) == sizeof(char);
 };
 
 template <class Iterator, bool>
@@ -77,9 +77,9 @@ struct iterator_traits_helpers {};
 
 template <class Iterator>
 struct iterator_traits_helpers<Iterator, true>
-    : public iterator_traits_helpers<
+    : public iterator_traits_imp<
           Iterator,
-          std::is_convertible<typename Iterator::iterator_categpry,
+          std::is_convertible<typename Iterator::iterator_category,
                               input_iterator_tag>::value ||
               std::is_convertible<typename Iterator::iterator_category,
                                   output_iterator_tag>::value> {};
@@ -98,7 +98,7 @@ template <class T>
 struct iterator_traits<T*> {
   typedef random_access_iterator_tag iterator_category;
   typedef T                          value_type;
-  typedef T*                         pionter;
+  typedef T*                         pointer;
   typedef T&                         reference;
   typedef ptrdiff_t                  difference_type;
 };
@@ -22,8 +22,51 @@
 #include "memory.h"
 #include "util.h"
 
+#if defined(MYSTL_USE_SLAB_ALLOC)
+#include "slab.h"
+#elif defined(MYSTL_USE_THREAD_ALLOC)
+#include "thread_alloc.h"
+#elif defined(MYSTL_USE_POOL_ALLOC)
+#include "alloc.h"
+#endif  // MYSTL_USE_SLAB_ALLOC
+
+#if defined(MYSTL_ALLOC_STATS)
+#include "alloc_stats.h"
+#endif  // MYSTL_ALLOC_STATS
+
 namespace Mystl {
 
+// list 默认使用的配置器, 可以通过宏切换为内存池
+#if defined(MYSTL_USE_SLAB_ALLOC)
+template <class T>
+using list_backend_alloc = Mystl::slab_allocator<T>;
+#elif defined(MYSTL_USE_THREAD_ALLOC)
+template <class T>
+using list_backend_alloc = Mystl::pool_allocator<T, Mystl::thread_alloc>;
+#elif defined(MYSTL_USE_POOL_ALLOC)
+template <class T>
+using list_backend_alloc = Mystl::pool_allocator<T, Mystl::alloc>;
+#else
+template <class T>
+using list_backend_alloc = Mystl::allocator<T>;
+#endif  // MYSTL_USE_SLAB_ALLOC
+
+// 定义 MYSTL_ALLOC_STATS 时记录 list 的分配统计
+#if defined(MYSTL_ALLOC_STATS)
+struct list_stats_tag {
+  static const char* name() {
+    return "list";
+  }
+};
+
+template <class T>
+using list_default_alloc =
+    Mystl::instrumented_allocator<list_backend_alloc<T>, list_stats_tag>;
+#else
+template <class T>
+using list_default_alloc = list_backend_alloc<T>;
+#endif  // MYSTL_ALLOC_STATS
+
 template <class T>
 struct list_node_base;
 
@@ -53,7 +96,7 @@ struct list_node_base {
   }
 
   base_ptr self() {
-    return static_cast<node_ptr>(&*this);
+    return this;
   }
 };
 
@@ -209,14 +252,330 @@ struct list_const_iterator : public iterator<bidirectional_iterator_tag, T> {
   }
 };
 
+// list::sort 的桶数, 第 i 个桶至少含 2^i 个节点, 64 个桶足以容纳任意长度
+enum { LIST_SORT_BINS = 64 };
+
+// 元素可平凡复制、不超过 LIST_COPY_SORT_BYTES 字节且个数不少于
+// LIST_COPY_SORT_MIN_SIZE 时, list::sort 把元素连同节点指针复制到连续的
+// 缓冲区中排序; 定义 MYSTL_LIST_MERGE_SORT_ONLY 时总是在链表上归并
+enum { LIST_COPY_SORT_BYTES = 16, LIST_COPY_SORT_MIN_SIZE = 64 };
+
+// 连续排序时先对每 LIST_COPY_SORT_RUN 个元素做插入排序
+enum { LIST_COPY_SORT_RUN = 32 };
+
+/**
+ * @brief 复制出来排序的元素及其所在节点
+ * @tparam T
+ * */
 template <class T>
-class list {
+struct list_sort_entry {
+  T                                 value;
+  typename node_traits<T>::base_ptr node;
+};
+
+/**
+ * @brief 稳定的插入排序
+ * @tparam Entry
+ * @tparam Compare
+ * @param  first            My Pan doc
+ * @param  last             My Pan doc
+ * @param  comp             My Pan doc
+ * */
+template <class Entry, class Compare>
+void list_entry_insertion_sort(Entry *first, Entry *last, Compare comp) {
+  for (Entry *i = first + 1; i < last; ++i) {
+    const Entry tmp = *i;
+    Entry      *j   = i;
+    for (; j != first && comp(tmp.value, (j - 1)->value); --j) {
+      *j = *(j - 1);
+    }
+    *j = tmp;
+  }
+}
+
+/**
+ * @brief 把 [first, mid) 与 [mid, last) 稳定地合并到 result
+ * @tparam Entry
+ * @tparam Compare
+ * @param  first            My Pan doc
+ * @param  mid              My Pan doc
+ * @param  last             My Pan doc
+ * @param  result           My Pan doc
+ * @param  comp             My Pan doc
+ * */
+template <class Entry, class Compare>
+void list_entry_merge(Entry  *first,
+                      Entry  *mid,
+                      Entry  *last,
+                      Entry  *result,
+                      Compare comp) {
+  Entry *i = first;
+  Entry *j = mid;
+  while (i != mid && j != last) {
+    if (comp(j->value, i->value)) {
+      *result++ = *j++;
+    } else {
+      *result++ = *i++;
+    }
+  }
+  for (; i != mid; ++i) {
+    *result++ = *i;
+  }
+  for (; j != last; ++j) {
+    *result++ = *j;
+  }
+}
+
+/**
+ * @brief 自底向上的稳定归并排序, 在 data 与 buf 之间来回合并
+ * @tparam Entry
+ * @tparam Compare
+ * @param  data             n 个元素
+ * @param  buf              可容纳 n 个元素
+ * @param  n                My Pan doc
+ * @param  comp             My Pan doc
+ * @return Entry*           排好序的一侧, 为 data 或 buf
+ * */
+template <class Entry, class Compare>
+Entry *list_entry_sort(Entry *data, Entry *buf, size_t n, Compare comp) {
+  for (size_t i = 0; i < n; i += LIST_COPY_SORT_RUN) {
+    const size_t last = n - i < LIST_COPY_SORT_RUN ? n : i + LIST_COPY_SORT_RUN;
+    list_entry_insertion_sort(data + i, data + last, comp);
+  }
+  Entry *src = data;
+  Entry *dst = buf;
+  for (size_t width = LIST_COPY_SORT_RUN; width < n; width *= 2) {
+    for (size_t i = 0; i < n; i += 2 * width) {
+      const size_t mid  = n - i < width ? n : i + width;
+      const size_t last = n - mid < width ? n : mid + width;
+      // 两段已经首尾有序时只需复制
+      if (mid == last || !comp(src[mid].value, src[mid - 1].value)) {
+        Mystl::copy(src + i, src + last, dst + i);
+      } else {
+        list_entry_merge(src + i, src + mid, src + last, dst + i, comp);
+      }
+    }
+    Mystl::swap(src, dst);
+  }
+  return src;
+}
+
+/**
+ * @brief 取出 list 节点中的元素, 供链表归并排序使用
+ * @tparam T
+ * */
+template <class T>
+struct list_value_of {
+  const T &operator()(typename node_traits<T>::base_ptr p) const {
+    return p->as_node()->value;
+  }
+};
+
+/**
+ * @brief 从 rest 开头取出最长的非降序区间, 或严格降序区间并将其反转,
+ *        rest 指向剩余部分。比较全部完成后才修改指针
+ * @tparam BasePtr
+ * @tparam Value
+ * @tparam Compare
+ * @param  rest             My Pan doc
+ * @param  value            由节点取得元素
+ * @param  comp             My Pan doc
+ * @return BasePtr          以 nullptr 结尾的有序区间
+ * */
+template <class BasePtr, class Value, class Compare>
+BasePtr list_sort_take_run(BasePtr &rest, Value value, Compare comp) {
+  BasePtr head = rest;
+  BasePtr last = head;
+  BasePtr next = head->next;
+  if (next != nullptr && comp(value(next), value(head))) {
+    // 严格降序时反转不影响稳定性
+    do {
+      last = next;
+      next = next->next;
+    } while (next != nullptr && comp(value(next), value(last)));
+    BasePtr reversed = nullptr;
+    for (BasePtr p = head; p != next;) {
+      BasePtr q = p->next;
+      p->next   = reversed;
+      reversed  = p;
+      p         = q;
+    }
+    rest = next;
+    return reversed;
+  }
+  while (next != nullptr && !comp(value(next), value(last))) {
+    last = next;
+    next = next->next;
+  }
+  last->next = nullptr;
+  rest       = next;
+  return head;
+}
+
+/**
+ * @brief 合并两段以 nullptr 结尾的有序区间, first 中的元素在前, 相等时
+ *        first 优先。结果接在 head 之后并放入 second, first 置为 nullptr;
+ *        LinkPrev 为 true 时同时设置 prev 指针, 结果与 head 首尾相接。comp
+ *        抛出异常时 second 是包含全部节点、以 nullptr 结尾的单链
+ * @tparam LinkPrev
+ * @tparam BasePtr
+ * @tparam Value
+ * @tparam Compare
+ * @param  first            My Pan doc
+ * @param  second           My Pan doc
+ * @param  head             My Pan doc
+ * @param  value            由节点取得元素
+ * @param  comp             My Pan doc
+ * */
+template <bool LinkPrev, class BasePtr, class Value, class Compare>
+void list_sort_merge(BasePtr &first,
+                     BasePtr &second,
+                     BasePtr  head,
+                     Value    value,
+                     Compare  comp) {
+  BasePtr a    = first;
+  BasePtr b    = second;
+  BasePtr last = head;
+  first        = nullptr;
+  try {
+    // 只在切换来源时写 next 指针, 连续取自同一段的节点保持原有链接; 结束
+    // 一段的那次比较同时决定了下一段的来源, 不再重复比较
+    bool take_second =
+        a != nullptr && b != nullptr && comp(value(b), value(a));
+    while (a != nullptr && b != nullptr) {
+      if (take_second) {
+        last->next = b;
+        do {
+          if (LinkPrev) b->prev = last;
+          last = b;
+          b    = b->next;
+        } while (b != nullptr && comp(value(b), value(a)));
+      } else {
+        last->next = a;
+        do {
+          if (LinkPrev) a->prev = last;
+          last = a;
+          a    = a->next;
+        } while (a != nullptr && !comp(value(b), value(a)));
+      }
+      take_second = !take_second;
+    }
+  } catch (...) {
+    last->next = a;
+    while (last->next != nullptr) {
+      last = last->next;
+    }
+    last->next = b;
+    second     = head->next;
+    throw;
+  }
+  last->next = a != nullptr ? a : b;
+  if (LinkPrev) {
+    for (BasePtr p = last->next; p != nullptr; p = p->next) {
+      p->prev = last;
+      last    = p;
+    }
+    last->next = head;
+    head->prev = last;
+  }
+  second = head->next;
+}
+
+// 把以 nullptr 结尾的单链重新链到 node 之后, 并恢复 prev 指针
+template <class BasePtr>
+void list_sort_relink(BasePtr node, BasePtr chain) noexcept {
+  BasePtr prev = node;
+  for (BasePtr p = chain; p != nullptr; p = p->next) {
+    p->prev    = prev;
+    prev->next = p;
+    prev       = p;
+  }
+  prev->next = node;
+  node->prev = prev;
+}
+
+/**
+ * @brief 自底向上的归并排序, 对以 node 为哨兵、至少含两个元素的环形链表
+ *        排序。先把链表断开为以 nullptr 结尾的单链, 每次取出一段自然有序的
+ *        区间, 像二进制加法一样与各桶中的区间逐级合并; 中间的合并只改 next
+ *        指针, 最后一次合并时顺带恢复 prev 指针并链回哨兵。已有序的输入只需
+ *        n - 1 次比较。list 与 intrusive_list 共用
+ * @tparam BasePtr          节点指针, 所指类型含 prev / next, 可默认构造
+ * @tparam Value
+ * @tparam Compare
+ * @param  node             哨兵节点
+ * @param  value            由节点取得元素
+ * @param  comp             My Pan doc
+ * */
+template <class BasePtr, class Value, class Compare>
+void list_merge_sort(BasePtr node, Value value, Compare comp) {
+  typedef typename std::remove_pointer<BasePtr>::type base_type;
+
+  node->prev->next = nullptr;
+  BasePtr   rest   = node->next;
+  BasePtr   run    = nullptr;
+  BasePtr   bins[LIST_SORT_BINS];
+  size_t    fill = 0;  // 已使用的桶数, bins[fill - 1] 总是非空
+  base_type head;      // 中间合并结果的临时头节点
+  try {
+    while (rest != nullptr) {
+      // 编号越大的桶中的元素越靠前, 合并时放在前面以保持稳定
+      run      = list_sort_take_run(rest, value, comp);
+      size_t i = 0;
+      for (; i < fill && bins[i] != nullptr; ++i) {
+        list_sort_merge<false>(bins[i], run, &head, value, comp);
+      }
+      if (i == fill) {
+        ++fill;
+      }
+      bins[i] = run;
+      run     = nullptr;
+    }
+    for (size_t i = 0; i + 1 < fill; ++i) {
+      if (bins[i] != nullptr) {
+        list_sort_merge<false>(bins[i], run, &head, value, comp);
+      }
+    }
+  } catch (...) {
+    // 把所有未合并的区间首尾相接, 重新链回
+    BasePtr *tail = &run;
+    for (size_t i = 0; i <= fill; ++i) {
+      while (*tail != nullptr) {
+        tail = &(*tail)->next;
+      }
+      *tail = i < fill ? bins[i] : rest;
+      if (i < fill) {
+        bins[i] = nullptr;
+      }
+    }
+    list_sort_relink(node, run);
+    throw;
+  }
+
+  if (run == nullptr) {
+    list_sort_relink(node, bins[fill - 1]);
+    return;
+  }
+  try {
+    list_sort_merge<true>(bins[fill - 1], run, node, value, comp);
+  } catch (...) {
+    list_sort_relink(node, run);
+    throw;
+  }
+}
+
+template <class T, class Alloc = list_default_alloc<T>>
+class list : private Mystl::alloc_holder<Alloc> {
 public:
   // list 的嵌套类别定义
-  typedef Mystl::allocator<T>                 allocator_type;
-  typedef Mystl::allocator<T>                 data_allocator;
-  typedef Mystl::allocator<list_node_base<T>> base_allocator;
-  typedef Mystl::allocator<list_node<T>>      node_allocator;
+  typedef Alloc                          allocator_type;
+  typedef Alloc                          data_allocator;
+  typedef Mystl::allocator_traits<Alloc> alloc_traits;
+  typedef Mystl::alloc_holder<Alloc>     alloc_base;
+  typedef typename alloc_traits::template rebind_alloc<list_node_base<T>>
+      base_allocator;
+  typedef typename alloc_traits::template rebind_alloc<list_node<T>>
+      node_allocator;
 
   typedef typename allocator_type::value_type      value_type;
   typedef typename allocator_type::pointer         pointer;
@@ -234,58 +593,80 @@ public:
   typedef typename node_traits<T>::base_ptr base_ptr;
   typedef typename node_traits<T>::node_ptr node_ptr;
 
-  allocator_type get_allocator() {
-    return node_allocator();
+  allocator_type get_allocator() const {
+    return get_alloc();
   }
 
   list() {
     fill_init(0, value_type());
   }
 
-  explicit list(size_type n) {
+  explicit list(const allocator_type &alloc) : alloc_base(alloc) {
+    fill_init(0, value_type());
+  }
+
+  explicit list(size_type n, const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
     fill_init(n, value_type());
   }
 
-  list(size_type n, const T &value) {
+  list(size_type             n,
+       const T &             value,
+       const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
     fill_init(n, value);
   }
 
   template <class Iter,
-            typename std::enable_if<Mystl::is_input_iterator<Iter>::value_type,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
                                     int>::type = 0>
-  list(Iter first, Iter last) {
+  list(Iter first, Iter last, const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
     copy_init(first, last);
   }
 
-  list(std::initializer_list<T> ilist) {
+  list(std::initializer_list<T> ilist,
+       const allocator_type &   alloc = allocator_type())
+      : alloc_base(alloc) {
     copy_init(ilist.begin(), ilist.end());
   }
 
-  list(const list &rhs) {
+  list(const list &rhs)
+      : alloc_base(alloc_traits::select_on_container_copy_construction(
+            rhs.get_alloc())) {
     copy_init(rhs.cbegin(), rhs.cend());
   }
 
-  list(list &&rhs) noexcept : node_(rhs.node_), size_(rhs.size_) {
-    rhs.node_ = nullptr;
-    rhs.size_ = 0;
+  list(const list &rhs, const allocator_type &alloc) : alloc_base(alloc) {
+    copy_init(rhs.cbegin(), rhs.cend());
   }
 
-  list &operator=(const list &rhs) {
-    if (this != &rhs) {
-      assign(rhs.begin(), rhs.end());
-    }
-
-    return *this;
+  // 哨兵在堆上, rhs 需要一个新的空哨兵才能继续使用, 因此可能抛出异常;
+  // 申请失败时 rhs 不变
+  list(list &&rhs)
+      : alloc_base(rhs.get_alloc()),
+        node_(nullptr),
+        size_(0),
+        free_(nullptr),
+        free_count_(0),
+        node_reserve_(0) {
+    base_ptr node = rhs.base_alloc().allocate(1);
+    node->unlink();
+    node_     = rhs.node_;
+    size_     = rhs.size_;
+    rhs.node_ = node;
+    rhs.size_ = 0;
+    swap_free_nodes(rhs);
   }
 
-  list &operator=(list &&rhs) noexcept {
-    clear();
-    splice(end(), rhs);
-    return *this;
-  }
+  list &operator=(const list &rhs);
+
+  // allocator 传播且不相等时要为 rhs 申请新的哨兵, 因此只在 allocator
+  // 总是相等时保证不抛出异常
+  list &operator=(list &&rhs) noexcept(alloc_traits::is_always_equal::value);
 
   list &operator=(std::initializer_list<T> ilist) {
-    list tmp(ilist.begin(), ilist.end());
+    list tmp(ilist.begin(), ilist.end(), get_alloc());
     swap(tmp);
 
     return *this;
@@ -294,10 +675,11 @@ public:
   ~list() {
     if (node_) {
       clear();
-      base_allocator::deallocate(node_);
+      base_alloc().deallocate(node_);
       node_ = nullptr;
       size_ = 0;
     }
+    release_nodes();
   }
 
   // 迭代器相关操作
@@ -413,14 +795,14 @@ public:
   void emplace_back(Args &&...args) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "list<T>'s size too big");
     auto link_node = create_node(Mystl::forward<Args>(args)...);
-    link_nodes_ad_back(link_node->as_base(), link_node->as_base());
+    link_nodes_at_back(link_node->as_base(), link_node->as_base());
     ++size_;
   }
 
   template <class... Args>
   iterator emplace(const_iterator pos, Args &&...args) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "list<T>'s size too big");
-    auto link_node = create_node(Mystl::forward<Args>(args)....);
+    auto link_node = create_node(Mystl::forward<Args>(args)...);
     link_nodes(pos.node_, link_node->as_base(), link_node->as_base());
     ++size_;
     return iterator(link_node);
@@ -428,7 +810,7 @@ public:
 
   // insert
   iterator insert(const_iterator pos, const value_type &value) {
-    THROE_LENGTH_ERROR_IF(size_ > max_size() - 1, "list<T>'s size too big");
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "list<T>'s size too big");
     auto link_node = create_node(value);
     ++size_;
     return link_iter_node(pos, link_node->as_base());
@@ -459,7 +841,7 @@ public:
   void push_front(const value_type &value) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "lsit<T>'s size too big");
     auto link_node = create_node(value);
-    link_node_at_front(link_node->as_base(), link_node->as_base());
+    link_nodes_at_front(link_node->as_base(), link_node->as_base());
     ++size_;
   }
 
@@ -470,7 +852,7 @@ public:
   void push_back(const value_type &value) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "list<T>'s size too big");
     auto link_node = create_node(value);
-    link_node_at_back(link_node->as_base(), link_node->as_base());
+    link_nodes_at_back(link_node->as_base(), link_node->as_base());
     ++size_;
   }
 
@@ -491,7 +873,7 @@ public:
     MYSTL_DEBUG(!empty());
     auto n = node_->prev;
     unlink_nodes(n, n);
-    destroy_node(n->as_base());
+    destroy_node(n->as_node());
     --size_;
   }
 
@@ -510,10 +892,27 @@ public:
   void resize(size_type new_size, const value_type &value);
 
   void swap(list &rhs) noexcept {
+    // 不传播 allocator 时, 两者必须相等
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                alloc_traits::equal(get_alloc(), rhs.get_alloc()));
     Mystl::swap(node_, rhs.node_);
     Mystl::swap(size_, rhs.size_);
+    swap_free_nodes(rhs);
+    swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+  }
+
+  // 节点缓存: erase / pop / clear 释放的节点最多保留 node_reserve_ 个, 之后
+  // 插入元素时优先复用, 不再经过配置器
+  void reserve_nodes(size_type n);
+
+  // 不申请内存即可容纳的元素个数
+  size_type node_capacity() const noexcept {
+    return size_ + free_count_;
   }
 
+  // 释放缓存的全部节点并取消保留
+  void release_nodes() noexcept;
+
   // list 相关操作
   void splice(const_iterator pos, list &other);
   void splice(const_iterator pos, list &other, const_iterator it);
@@ -545,24 +944,71 @@ public:
   template <class Compare>
   void merge(list &x, Compare comp);
 
+  // 稳定排序, 节点只重新链接, 迭代器保持有效; comp 抛出异常时保留
+  // 全部节点, 但顺序未指定
   void sort() {
-    list_sort(begin(), end(), size(), Mystl::less<T>());
+    sort(Mystl::less<T>());
   }
 
   template <class Compare>
   void sort(Compare comp) {
-    list_sort(begin(), end(), size(), Mystl::less<T>());
+#if defined(MYSTL_LIST_MERGE_SORT_ONLY)
+    list_sort(comp);
+#else
+    sort_dispatch(
+        comp, m_bool_constant<std::is_trivially_copyable<T>::value &&
+                              sizeof(T) <= LIST_COPY_SORT_BYTES>());
+#endif  // MYSTL_LIST_MERGE_SORT_ONLY
   }
 
   void reverse();
 
 private:
+  using alloc_base::get_alloc;
+
+  base_allocator base_alloc() const {
+    return base_allocator(get_alloc());
+  }
+
+  node_allocator node_alloc() const {
+    return node_allocator(get_alloc());
+  }
+
+  // move assign
+  void move_assign(list &rhs, m_true_type);
+  void move_assign(list &rhs, m_false_type);
+
+  // propagate / swap allocator
+  void copy_alloc(const list &rhs, m_true_type) {
+    get_alloc() = rhs.get_alloc();
+  }
+  void copy_alloc(const list &, m_false_type) {
+  }
+  void swap_alloc(list &rhs, m_true_type) {
+    Mystl::swap(get_alloc(), rhs.get_alloc());
+  }
+  void swap_alloc(list &, m_false_type) {
+  }
+
   // create / destroty node
   template <class... Args>
   node_ptr create_node(Args &&...args);
   void     destroy_node(node_ptr p);
+  node_ptr take_free_node();
+  void     recycle_node(node_ptr p) noexcept;
+  void     destroy_chain(base_ptr first, base_ptr last);
+  void     swap_free_nodes(list &rhs) noexcept {
+    Mystl::swap(free_, rhs.free_);
+    Mystl::swap(free_count_, rhs.free_count_);
+    Mystl::swap(node_reserve_, rhs.node_reserve_);
+  }
+
+  // 批量插入: 先构造一条独立的链, 全部成功后一次链入
+  template <class MakeNode>
+  iterator chain_insert(const_iterator pos, size_type n, MakeNode make);
 
   // initialize
+  void init_node();
   void fill_init(size_type n, const value_type &value);
   template <class Iter>
   void copy_init(Iter first, Iter last);
@@ -589,20 +1035,148 @@ private:
 
   // sort
   template <class Compare>
-  iterator list_sort(iterator first, iterator last, size_type n, Compare comp);
+  void sort_dispatch(Compare comp, m_true_type) {
+    if (size_ < LIST_COPY_SORT_MIN_SIZE || !copy_sort(comp)) {
+      list_sort(comp);
+    }
+  }
+
+  template <class Compare>
+  void sort_dispatch(Compare comp, m_false_type) {
+    list_sort(comp);
+  }
+
+  template <class Compare>
+  bool copy_sort(Compare comp);
+
+  template <class Compare>
+  void list_sort(Compare comp) {
+    if (size_ >= 2) {
+      list_merge_sort(node_, list_value_of<T>(), comp);
+    }
+  }
 
-  base_ptr  node_;  // 指向末尾节点
-  size_type size_;  // 大小
+  base_ptr  node_;          // 指向末尾节点
+  size_type size_;          // 大小
+  base_ptr  free_;          // 缓存的空闲节点, 以 next 相连, 元素未构造
+  size_type free_count_;    // 缓存的节点数
+  size_type node_reserve_;  // 最多缓存的节点数
 };
 
+/**
+ * @brief 复制赋值, allocator 需要传播且不相等时先用旧的 allocator 释放全部节点
+ * @tparam T
+ * @param  rhs              My Pan doc
+ * @return list<T, Alloc>&
+ * */
+template <class T, class Alloc>
+list<T, Alloc> &list<T, Alloc>::operator=(const list &rhs) {
+  if (this != &rhs) {
+    typedef typename alloc_traits::propagate_on_container_copy_assignment pocca;
+    if (pocca::value && !alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+      // 先用新的 allocator 申请哨兵, 失败时容器不变
+      base_ptr node = base_allocator(rhs.get_alloc()).allocate(1);
+      node->unlink();
+      clear();
+      release_nodes();
+      base_alloc().deallocate(node_);
+      copy_alloc(rhs, pocca());
+      node_ = node;
+    }
+    assign(rhs.begin(), rhs.end());
+  }
+
+  return *this;
+}
+
+/**
+ * @brief 移动赋值
+ * @tparam T
+ * @param  rhs              My Pan doc
+ * @return list<T, Alloc>&
+ * */
+template <class T, class Alloc>
+list<T, Alloc> &list<T, Alloc>::operator=(list &&rhs) noexcept(
+    alloc_traits::is_always_equal::value) {
+  if (this != &rhs) {
+    move_assign(
+        rhs,
+        m_bool_constant<
+            alloc_traits::propagate_on_container_move_assignment::value ||
+            alloc_traits::is_always_equal::value>());
+  }
+
+  return *this;
+}
+
+/**
+ * @brief 移动赋值, allocator 可以传播或总是相等时直接接管 rhs 的节点。
+ *        rhs 留下一个空的哨兵, 之后仍可继续使用
+ * @tparam T
+ * @param  rhs              My Pan doc
+ * */
+template <class T, class Alloc>
+void list<T, Alloc>::move_assign(list &rhs, m_true_type) {
+  typedef typename alloc_traits::propagate_on_container_move_assignment pocma;
+  if (alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+    // 哨兵可以互换, rhs 得到本容器清空后的哨兵与节点缓存
+    clear();
+    release_nodes();
+    Mystl::swap(node_, rhs.node_);
+    Mystl::swap(size_, rhs.size_);
+    swap_free_nodes(rhs);
+    copy_alloc(rhs, pocma());
+    return;
+  }
+
+  // 旧哨兵只能由旧的 allocator 释放, 先为 rhs 申请新的哨兵
+  base_ptr node = rhs.base_alloc().allocate(1);
+  node->unlink();
+  clear();
+  release_nodes();
+  base_alloc().deallocate(node_);
+  copy_alloc(rhs, pocma());
+  node_     = rhs.node_;
+  size_     = rhs.size_;
+  rhs.node_ = node;
+  rhs.size_ = 0;
+  swap_free_nodes(rhs);
+}
+
+/**
+ * @brief 移动赋值, allocator 不相等时只能逐个移动元素
+ * @tparam T
+ * @param  rhs              My Pan doc
+ * */
+template <class T, class Alloc>
+void list<T, Alloc>::move_assign(list &rhs, m_false_type) {
+  if (alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+
+  auto f1 = begin();
+  auto l1 = end();
+  auto f2 = rhs.begin();
+  auto l2 = rhs.end();
+  for (; f1 != l1 && f2 != l2; ++f1, ++f2) {
+    *f1 = Mystl::move(*f2);
+  }
+  erase(f1, l1);
+  for (; f2 != l2; ++f2) {
+    emplace_back(Mystl::move(*f2));
+  }
+  rhs.clear();
+}
+
 /**
  * @brief 删除pos处的元素
  * @tparam T
  * @param  pos              My Pan doc
- * @return list<T>::iterator
+ * @return list<T, Alloc>::iterator
  * */
-template <class T>
-typename list<T>::iterator list<T>::erase(const_iterator pos) {
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator list<T, Alloc>::erase(const_iterator pos) {
   MYSTL_DEBUG(pos != cend());
   auto n    = pos.node_;
   auto next = n->next;
@@ -617,11 +1191,11 @@ typename list<T>::iterator list<T>::erase(const_iterator pos) {
  * @tparam T
  * @param  first            My Pan doc
  * @param  last             My Pan doc
- * @return list<T>::iterator
+ * @return list<T, Alloc>::iterator
  * */
-template <class T>
-typename list<T>::iterator list<T>::erase(const_iterator first,
-                                          const_iterator last) {
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator list<T, Alloc>::erase(const_iterator first,
+                                                        const_iterator last) {
   if (first != last) {
     unlink_nodes(first.node_, last.node_->prev);
     while (first != last) {
@@ -638,13 +1212,17 @@ typename list<T>::iterator list<T>::erase(const_iterator first,
  * @brief 清空list
  * @tparam T
  * */
-template <class T>
-void list<T>::clear() {
+template <class T, class Alloc>
+void list<T, Alloc>::clear() {
   if (0 != size_) {
-    auto cur = node_->next;
-    for (base_ptr next = cur->next; cur != node_;
-         cur = next, next = cur->next) {
-      destroy_node(cur->as_node());
+    if (std::is_trivially_destructible<T>::value &&
+        free_count_ + size_ <= node_reserve_) {
+      // 元素无需析构且缓存放得下时, 整条链一次归还给缓存
+      node_->prev->next = free_;
+      free_             = node_->next;
+      free_count_ += size_;
+    } else {
+      destroy_chain(node_->next, node_->prev);
     }
     node_->unlink();
     size_ = 0;
@@ -655,8 +1233,8 @@ void list<T>::clear() {
  * @brief 重置容器大小
  * @tparam T
  * */
-template <class T>
-void list<T>::resize(size_type new_size, const value_type &value) {
+template <class T, class Alloc>
+void list<T, Alloc>::resize(size_type new_size, const value_type &value) {
   auto      i   = begin();
   size_type len = 0;
   while (i != end() && len < new_size) {
@@ -676,9 +1254,10 @@ void list<T>::resize(size_type new_size, const value_type &value) {
  * @param  pos              My Pan doc
  * @param  x                My Pan doc
  * */
-template <class T>
-void list<T>::splice(const_iterator pos, list &x) {
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list &x) {
   MYSTL_DEBUG(this != &x);
+  MYSTL_DEBUG(alloc_traits::equal(get_alloc(), x.get_alloc()));
   if (!x.empty()) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - x.size_,
                           "list<T>'s size too bug");
@@ -700,8 +1279,9 @@ void list<T>::splice(const_iterator pos, list &x) {
  * @param  x                My Pan doc
  * @param  it               My Pan doc
  * */
-template <class T>
-void list<T>::splice(const_iterator pos, list &x, const_iterator it) {
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list &x, const_iterator it) {
+  MYSTL_DEBUG(alloc_traits::equal(get_alloc(), x.get_alloc()));
   if (pos.node_ != it.node_ && pos.node_ != it.node_->next) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "list<T>'s size too big");
     auto f = it.node_;
@@ -721,11 +1301,12 @@ void list<T>::splice(const_iterator pos, list &x, const_iterator it) {
  * @param  first            My Pan doc
  * @param  last             My Pan doc
  * */
-template <class T>
-void list<T>::splice(const_iterator pos,
-                     list &         x,
-                     const_iterator first,
-                     const_iterator last) {
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos,
+                            list &         x,
+                            const_iterator first,
+                            const_iterator last) {
+  MYSTL_DEBUG(alloc_traits::equal(get_alloc(), x.get_alloc()));
   if (first != last && this != &x) {
     size_type n = Mystl::distance(first, last);
     THROW_LENGTH_ERROR_IF(size_ > max_size() - n, "lsit<T>'s size too big");
@@ -745,9 +1326,9 @@ void list<T>::splice(const_iterator pos,
  * @tparam UnaryPredicate
  * @param  pred             My Pan doc
  * */
-template <class T>
+template <class T, class Alloc>
 template <class UnaryPredicate>
-void list<T>::remove_if(UnaryPredicate pred) {
+void list<T, Alloc>::remove_if(UnaryPredicate pred) {
   auto f = begin();
   auto l = end();
   for (auto next = f; f != l; f = next) {
@@ -764,9 +1345,9 @@ void list<T>::remove_if(UnaryPredicate pred) {
  * @tparam BinaryPredicate
  * @param  pred             My Pan doc
  * */
-template <class T>
+template <class T, class Alloc>
 template <class BinaryPredicate>
-void list<T>::unique(BinaryPredicate pred) {
+void list<T, Alloc>::unique(BinaryPredicate pred) {
   auto i = begin();
   auto e = end();
   auto j = i;
@@ -789,9 +1370,10 @@ void list<T>::unique(BinaryPredicate pred) {
  * @param  x                My Pan doc
  * @param  comp             My Pan doc
  * */
-template <class T>
+template <class T, class Alloc>
 template <class Compare>
-void list<T>::merge(list &x, Compare comp) {
+void list<T, Alloc>::merge(list &x, Compare comp) {
+  MYSTL_DEBUG(alloc_traits::equal(get_alloc(), x.get_alloc()));
   if (this != &x) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - x.size_,
                           "list<T>'s size too big");
@@ -836,8 +1418,8 @@ void list<T>::merge(list &x, Compare comp) {
  * @brief 链表反转
  * @tparam T
  * */
-template <class T>
-void list<T>::reverse() {
+template <class T, class Alloc>
+void list<T, Alloc>::reverse() {
   if (size_ <= 1) {
     return;
   }
@@ -858,19 +1440,19 @@ void list<T>::reverse() {
  * @tparam T
  * @tparam Args
  * @param  args             My Pan doc
- * @return list<T>::node_ptr
+ * @return list<T, Alloc>::node_ptr
  * */
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-typename list<T>::node_ptr list<T>::create_node(Args &&...args) {
-  node_ptr p = node_allocator::allocate(1);
+typename list<T, Alloc>::node_ptr list<T, Alloc>::create_node(Args &&...args) {
+  node_ptr p = take_free_node();
   try {
-    data_allocator::constuctor(Mystl::address_of(p->value),
+    get_alloc().construct(Mystl::address_of(p->value),
                                Mystl::forward<Args>(args)...);
     p->prev = nullptr;
     p->next = nullptr;
   } catch (...) {
-    node_allocator::deallocate(p);
+    recycle_node(p);
     throw;
   }
   return p;
@@ -881,10 +1463,89 @@ typename list<T>::node_ptr list<T>::create_node(Args &&...args) {
  * @tparam T
  * @param  p                My Pan doc
  * */
-template <class T>
-void list<T>::destroy_node(node_ptr p) {
-  data_allocator::destroy(Mystl::address_of(p->value));
-  node_allocator::deallocate(p);
+template <class T, class Alloc>
+void list<T, Alloc>::destroy_node(node_ptr p) {
+  get_alloc().destroy(Mystl::address_of(p->value));
+  recycle_node(p);
+}
+
+// 归还一个未构造元素的节点, 缓存未满时留作复用
+template <class T, class Alloc>
+void list<T, Alloc>::recycle_node(node_ptr p) noexcept {
+  if (free_count_ < node_reserve_) {
+    p->next = free_;
+    free_   = p->as_base();
+    ++free_count_;
+  } else {
+    node_alloc().deallocate(p);
+  }
+}
+
+// 取一个未构造元素的节点, 缓存为空时才向配置器申请
+template <class T, class Alloc>
+typename list<T, Alloc>::node_ptr list<T, Alloc>::take_free_node() {
+  if (free_ == nullptr) {
+    return node_alloc().allocate(1);
+  }
+  base_ptr p = free_;
+  free_      = p->next;
+  --free_count_;
+  return p->as_node();
+}
+
+// 销毁以 next 相连的 [first, last] 中的节点
+template <class T, class Alloc>
+void list<T, Alloc>::destroy_chain(base_ptr first, base_ptr last) {
+  while (true) {
+    base_ptr next = first->next;
+    destroy_node(first->as_node());
+    if (first == last) {
+      break;
+    }
+    first = next;
+  }
+}
+
+/**
+ * @brief 保留至多 n 个节点的缓存, 并预先申请节点使容器不申请内存即可容纳
+ *        n 个元素
+ * @tparam T
+ * @param  n                My Pan doc
+ * */
+template <class T, class Alloc>
+void list<T, Alloc>::reserve_nodes(size_type n) {
+  THROW_LENGTH_ERROR_IF(n > max_size(), "list<T>'s size too big");
+  if (node_reserve_ < n) {
+    node_reserve_ = n;
+  }
+  while (size_ + free_count_ < n) {
+    base_ptr p = node_alloc().allocate(1);
+    p->next    = free_;
+    free_      = p;
+    ++free_count_;
+  }
+}
+
+template <class T, class Alloc>
+void list<T, Alloc>::release_nodes() noexcept {
+  while (free_ != nullptr) {
+    base_ptr next = free_->next;
+    node_alloc().deallocate(free_->as_node());
+    free_ = next;
+  }
+  free_count_   = 0;
+  node_reserve_ = 0;
+}
+
+// 申请哨兵节点, 初始化为空容器
+template <class T, class Alloc>
+void list<T, Alloc>::init_node() {
+  node_ = base_alloc().allocate(1);
+  node_->unlink();
+  size_         = 0;
+  free_         = nullptr;
+  free_count_   = 0;
+  node_reserve_ = 0;
 }
 
 /**
@@ -893,19 +1554,33 @@ void list<T>::destroy_node(node_ptr p) {
  * @param  n                My Pan doc
  * @param  p                My Pan doc
  * */
-template <class T>
-void list<T>::fill_init(size_type n, const value_type &value) {
-  node_ = base_allocator::allocate(1);
-  node_->unlink();
-  size_ = n;
+template <class T, class Alloc>
+void list<T, Alloc>::fill_init(size_type n, const value_type &value) {
+  init_node();
   try {
-    for (; n > 0; --n) {
-      auto node = create_node(value);
-      link_nodes_at_back(node->as_base(), node->as_base());
-    }
+    fill_insert(cend(), n, value);
   } catch (...) {
-    clear();
-    base_allocator::deallocate(node_);
+    base_alloc().deallocate(node_);
+    node_ = nullptr;
+    throw;
+  }
+}
+
+/**
+ * @brief 以[first, last)初始化容器
+ * @tparam T
+ * @tparam Iter
+ * @param  first            My Pan doc
+ * @param  last             My Pan doc
+ * */
+template <class T, class Alloc>
+template <class Iter>
+void list<T, Alloc>::copy_init(Iter first, Iter last) {
+  init_node();
+  try {
+    copy_insert(cend(), Mystl::distance(first, last), first);
+  } catch (...) {
+    base_alloc().deallocate(node_);
     node_ = nullptr;
     throw;
   }
@@ -916,11 +1591,12 @@ void list<T>::fill_init(size_type n, const value_type &value) {
  * @tparam T
  * @param  pos              My Pan doc
  * @param  link_node        My Pan doc
- * @return list<T>::iterator
+ * @return list<T, Alloc>::iterator
  * */
-template <class T>
-typename list<T>::iterator list<T>::link_iter_node(const_iterator pos,
-                                                   base_ptr       link_node) {
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator list<T, Alloc>::link_iter_node(
+    const_iterator pos,
+    base_ptr       link_node) {
   if (pos == node_->next) {
     link_nodes_at_front(link_node, link_node);
   } else if (pos == node_) {
@@ -939,9 +1615,9 @@ typename list<T>::iterator list<T>::link_iter_node(const_iterator pos,
  * @param  first            My Pan doc
  * @param  last             My Pan doc
  * */
-template <class T>
-void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) {
-  pos->prev->nexr = first;
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) {
+  pos->prev->next = first;
   first->prev     = pos->prev;
   pos->prev       = last;
   last->next      = pos;
@@ -953,11 +1629,11 @@ void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) {
  * @param  first            My Pan doc
  * @param  last             My Pan doc
  * */
-template <class T>
-void list<T>::link_nodes_at_front(base_ptr first, base_ptr last) {
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes_at_front(base_ptr first, base_ptr last) {
   first->prev      = node_;
   last->next       = node_->next;
-  last->next->next = last;
+  last->next->prev = last;
   node_->next      = first;
 }
 
@@ -967,8 +1643,8 @@ void list<T>::link_nodes_at_front(base_ptr first, base_ptr last) {
  * @param  first            My Pan doc
  * @param  last             My Pan doc
  * */
-template <class T>
-void list<T>::link_nodes_at_back(base_ptr first, base_ptr last) {
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes_at_back(base_ptr first, base_ptr last) {
   last->next        = node_;
   first->prev       = node_->prev;
   first->prev->next = first;
@@ -981,14 +1657,14 @@ void list<T>::link_nodes_at_back(base_ptr first, base_ptr last) {
  * @param  first            My Pan doc
  * @param  last             My Pan doc
  * */
-template <class T>
-void list<T>::unlink_nodes(base_ptr first, base_ptr last) {
+template <class T, class Alloc>
+void list<T, Alloc>::unlink_nodes(base_ptr first, base_ptr last) {
   first->prev->next = last->next;
   last->next->prev  = first->prev;
 }
 
-template <class T>
-void list<T>::fill_assign(size_type n, const value_type &value) {
+template <class T, class Alloc>
+void list<T, Alloc>::fill_assign(size_type n, const value_type &value) {
   auto i = begin();
   auto e = end();
   for (; n > 0 && i != e; --n, ++i) {
@@ -1008,9 +1684,9 @@ void list<T>::fill_assign(size_type n, const value_type &value) {
  * @param  f2               My Pan doc
  * @param  l2               My Pan doc
  * */
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-void list<T>::copy_assign(Iter f2, Iter l2) {
+void list<T, Alloc>::copy_assign(Iter f2, Iter l2) {
   auto f1 = begin();
   auto l1 = end();
   for (; f1 != l1 && f2 != l2; ++f1, ++f2) {
@@ -1029,40 +1705,14 @@ void list<T>::copy_assign(Iter f2, Iter l2) {
  * @param  pos              My Pan doc
  * @param  n                My Pan doc
  * @param  value            My Pan doc
- * @return list<T>::iterator
+ * @return list<T, Alloc>::iterator
  * */
-template <class T>
-typename list<T>::iterator list<T>::fill_insert(const_iterator    pos,
-                                                size_type         n,
-                                                const value_type &value) {
-  iterator r(pos.node_);
-  if (n != 0) {
-    const auto add_size = n;
-    auto       node     = create_node(value);
-    node->prev          = nullptr;
-    r                   = iterator(node);
-    iterator end        = r;
-    try {
-      for (--n; n > 0; --n, ++end) {
-        auto next       = create_node(value);
-        end.node_->next = next->as_base();
-        next->prev      = end.node_;
-      }
-      size_ += add_size;
-    } catch (...) {
-      auto enode = end.node_;
-      while (true) {
-        auto prev = enode->prev;
-        destroy_node(enode->as_node());
-        if (prev == nullptr) break;
-        enode = prev;
-      }
-      throw;
-    }
-    link_nodes(pos.node_, r.node_, end.node_);
-  }
-
-  return r;
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator list<T, Alloc>::fill_insert(
+    const_iterator    pos,
+    size_type         n,
+    const value_type &value) {
+  return chain_insert(pos, n, [this, &value]() { return create_node(value); });
 }
 
 /**
@@ -1072,126 +1722,119 @@ typename list<T>::iterator list<T>::fill_insert(const_iterator    pos,
  * @param  pos              My Pan doc
  * @param  n                My Pan doc
  * @param  first            My Pan doc
- * @return list<T>::iterator
+ * @return list<T, Alloc>::iterator
  * */
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-typename list<T>::iterator list<T>::copy_insert(const_iterator pos,
-                                                size_type      n,
-                                                Iter           first) {
-  iterator r(pos.node_);
-  if (n != 0) {
-    const auto add_size = n;
-    auto       node     = create_node(*first);
-    node->prev          = nullptr;
-    r                   = iterator(node);
-    iterator end        = r;
-    try {
-      for (--n, ++first; n > 0; --n, ++first, ++end) {
-        auto next       = create_node(*first);
-        end.node_->next = next->as_base();
-        next->prev      = end.node_;
-      }
-      size_ += add_size;
-    } catch (...) {
-      auto enode = end.node_;
-      while (true) {
-        auto prev = enode->prev;
-        destroy_node(enode->as_node());
-        if (prev == nullptr) {
-          break;
-        }
-        enode = prev;
-      }
-      throw;
-    }
+typename list<T, Alloc>::iterator list<T, Alloc>::copy_insert(
+    const_iterator pos,
+    size_type      n,
+    Iter           first) {
+  return chain_insert(pos, n, [this, &first]() {
+    auto node = create_node(*first);
+    ++first;
+    return node;
+  });
+}
 
-    link_nodes(pos.node_, r.node_, end.node_);
+/**
+ * @brief 在pos处插入make依次创建的n个节点。节点先连成一条独立的链, 全部
+ *        构造成功后一次链入容器; 构造抛出异常时已创建的节点整体归还, 容器
+ *        不变
+ * @tparam T
+ * @tparam MakeNode
+ * @param  pos              My Pan doc
+ * @param  n                My Pan doc
+ * @param  make             My Pan doc
+ * @return list<T, Alloc>::iterator 指向第一个插入的元素
+ * */
+template <class T, class Alloc>
+template <class MakeNode>
+typename list<T, Alloc>::iterator list<T, Alloc>::chain_insert(
+    const_iterator pos,
+    size_type      n,
+    MakeNode       make) {
+  if (n == 0) {
+    return iterator(pos.node_);
+  }
+  base_ptr first = make()->as_base();
+  base_ptr last  = first;
+  try {
+    for (size_type i = 1; i < n; ++i) {
+      base_ptr next = make()->as_base();
+      last->next    = next;
+      next->prev    = last;
+      last          = next;
+    }
+  } catch (...) {
+    destroy_chain(first, last);
+    throw;
   }
-
-  return r;
+  link_nodes(pos.node_, first, last);
+  size_ += n;
+  return iterator(first);
 }
 
 /**
- * @brief 对list 进行归并排序，返回一个迭代器指向区间最小元素的位置
+ * @brief 把元素和节点指针复制到连续缓冲区中排序, 再按顺序一次性重新链接
+ *        节点。比较只访问缓冲区, 不再在节点间跳转; 复制时顺便检查, 已有序
+ *        则直接返回, 严格降序则反向链接。排序中 comp 抛出异常时链表不变
  * @tparam T
- * @tparam Compared
- * @param  f1               My Pan doc
- * @param  l2               My Pan doc
- * @param  n                My Pan doc
+ * @tparam Compare
  * @param  comp             My Pan doc
- * @return list<T>::iterator
+ * @return true             已排好序
+ * @return false            申请不到足够的缓冲区, 链表不变
  * */
-template <class T>
-template <class Compared>
-typename list<T>::iterator list<T>::list_sort(iterator  f1,
-                                              iterator  l2,
-                                              size_type n,
-                                              Compared  comp) {
-  if (n < 2) {
-    return f1;
-  }
-  if (n == 2) {
-    if (comp(*--l2, *f1)) {
-      auto ln = l2.node_;
-      unlink_nodes(ln, ln);
-      link_nodes(f1.node_, ln, ln);
-      return l2;
-    }
-    return f1;
-  }
-
-  auto n2 = n / 2;
-  auto l1 = f1;
-  Mystl::advance(l1, n2);
-  auto result = f1 = list_sort(f1, l1, n2, comp);  // 前半段最小位置
-  auto f2 = l1 = list_sort(l1, l2, n - n2, comp);  // 后半段最小位置
-
-  // 把较小的一段区间移到前面
-  if (comp(*f2, *f1)) {
-    auto m = f2;
-    ++m;
-    for (; m != l2 && comp(*m, *f1); ++m)
-      ;
-    auto f = f2.node_;
-    auto l = m.node_->prev;
-    result = f2;
-    l1 = f2 = m;
-    unlink_nodes(f, l);
-    m = f1;
-    ++m;
-    link_nodes(f1.node_, f, l);
-    f1 = m;
-  } else {
-    ++f1;
-  }
-
-  // 合并两段有序区间
-  while (f1 != l1 && f2 != l2) {
-    if (comp(*f1, *f2)) {
-      auto m = f2;
-      ++m;
-      for (; m != l2 && comp(*m, *f1); ++m) {
-        auto m = f2;
-        ++m;
-        for (; m != l2 && comp(*m, *f1); ++m)
-          ;
-        auto f = f2.node_;
-        auto l = m.node_->prev;
-        if (l1 == l2) l1 = m;
-        f2 = m;
-        unlink_nodes(f, l);
-        m = f1;
-        ++m;
-        link_nodes(f1.node_, f, l);
-        f1 = m;
+template <class T, class Alloc>
+template <class Compare>
+bool list<T, Alloc>::copy_sort(Compare comp) {
+  typedef list_sort_entry<T> entry;
+  const ptrdiff_t            n      = static_cast<ptrdiff_t>(size_);
+  pair<entry *, ptrdiff_t>   buffer = get_temporary_buffer<entry>(2 * n);
+  if (buffer.second < 2 * n) {
+    release_temporary_buffer(buffer.first);
+    return false;
+  }
+
+  entry *data       = buffer.first;
+  bool   sorted     = true;
+  bool   descending = true;
+  try {
+    entry   *e = data;
+    base_ptr p = node_->next;
+    for (; p != node_; p = p->next, ++e) {
+      e->value = p->as_node()->value;
+      e->node  = p;
+      if (e != data && (sorted || descending)) {
+        if (comp(e->value, (e - 1)->value)) {
+          sorted = false;
+        } else {
+          descending = false;
+        }
       }
-    } else {
-      ++f1;
     }
+    if (!sorted && !descending) {
+      data = list_entry_sort(data, data + n, static_cast<size_t>(n), comp);
+    }
+  } catch (...) {
+    release_temporary_buffer(buffer.first);
+    throw;
   }
 
-  return result;
+  if (!sorted) {
+    const ptrdiff_t step = descending ? -1 : 1;
+    base_ptr        prev = node_;
+    for (ptrdiff_t i = descending ? n - 1 : 0; i >= 0 && i < n; i += step) {
+      base_ptr p = data[i].node;
+      p->prev    = prev;
+      prev->next = p;
+      prev       = p;
+    }
+    prev->next  = node_;
+    node_->prev = prev;
+  }
+  release_temporary_buffer(buffer.first);
+  return true;
 }
 
 /**
@@ -1202,8 +1845,8 @@ typename list<T>::iterator list<T>::list_sort(iterator  f1,
  * @return true
  * @return false
  * */
-template <class T>
-bool operator==(const list<T> &lhs, const list<T> &rhs) {
+template <class T, class Alloc>
+bool operator==(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs) {
   auto f1 = lhs.cbegin();
   auto f2 = rhs.cbegin();
   auto l1 = lhs.cend();
@@ -1214,40 +1857,46 @@ bool operator==(const list<T> &lhs, const list<T> &rhs) {
   return f1 == l1 && f2 == l2;
 }
 
-template <class T>
-bool operator<(const list<T> &lhs, const list<T> &rhs) {
+template <class T, class Alloc>
+bool operator<(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs) {
   return Mystl::lexicographical_compare(lhs.cbegin(),
                                         lhs.cend(),
                                         rhs.cbegin(),
                                         rhs.cend());
 }
 
-template <class T>
-bool operator!=(const list<T> &lhs, const list<T> &rhs) {
+template <class T, class Alloc>
+bool operator!=(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs) {
   return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const list<T> &lhs, const list<T> &rhs) {
+template <class T, class Alloc>
+bool operator>(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs) {
   return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const list<T> &lhs, const list<T> &rhs) {
+template <class T, class Alloc>
+bool operator<=(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs) {
   return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const list<T> &lhs, const list<T> &rhs) {
+template <class T, class Alloc>
+bool operator>=(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs) {
   return !(lhs < rhs);
 }
 
 // 重载 swap
-template <class T>
-void swap(list<T> &lhs, list<T> &rhs) noexcept {
+template <class T, class Alloc>
+void swap(list<T, Alloc> &lhs, list<T, Alloc> &rhs) noexcept {
   lhs.swap(rhs);
 }
 
+// 哨兵节点在堆上, 节点也不指回 list 对象, 因此只要 allocator 可以平凡
+// 重定位, list 整体也可以按字节搬移
+template <class T, class Alloc>
+struct is_trivially_relocatable<list<T, Alloc>>
+    : m_bool_constant<is_trivially_relocatable<Alloc>::value> {};
+
 }  // namespace Mystl
 
 #endif /* __LIST_H__ */
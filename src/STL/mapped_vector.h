@@ -0,0 +1,568 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file mapped_vector.h
+ * @brief 以 mmap 文件为存储的 vector, 可直接持久化与零拷贝加载
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-23 15:05:26
+ *
+ * mapped_vector<T> 把元素直接保存在一个以 MAP_SHARED 映射的文件中, T 必须
+ * 可平凡复制。文件由 MAPPED_HEADER_BYTES 字节的文件头和紧随其后的元素
+ * 组成, 文件头记录魔数、sizeof(T) 与元素个数。
+ *
+ *   - 写入: 容量不足时先 ftruncate 扩大文件, 再以 mremap 扩大映射, 已有
+ *     元素不经过用户态复制;
+ *   - 读取: 以 mapped_read_only 打开已有文件只做一次 mmap, 元素按页缺页
+ *     载入, 没有解析与复制。映射不可写, 此时只能通过 const 引用访问元素,
+ *     非 const 的 data()、begin()、operator[] 等抛出 std::runtime_error;
+ *   - 落盘: 元素个数只在 flush() 与 close() 时写回文件头。flush() 先以
+ *     msync 同步元素, 再写回并同步文件头, 因此崩溃后文件中总是最近一次
+ *     flush() 时的完整内容。
+ *
+ * 只支持 Linux, 其他平台上 open() 抛出 std::runtime_error。
+ *
+ * */
+
+#ifndef __MAPPED_VECTOR_H__
+#define __MAPPED_VECTOR_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // __linux__
+
+#include "algobase.h"
+#include "allocator.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "vector_growth.h"
+
+namespace Mystl {
+
+// 文件头占用的字节数, 元素从该偏移开始
+enum { MAPPED_HEADER_BYTES = 64 };
+
+// 打开文件的方式
+enum mapped_mode {
+  mapped_read_only  = 0,  // 只读打开已有文件, 零拷贝
+  mapped_read_write = 1,  // 读写打开, 文件不存在时创建
+  mapped_truncate   = 2   // 读写打开并清空已有内容
+};
+
+/**
+ * @brief 文件头, 位于文件开头
+ * */
+struct mapped_vector_header {
+  char     magic[8];   // "MYSTLMV1"
+  uint64_t elem_size;  // sizeof(T)
+  uint64_t size;       // 最近一次 flush() 或 close() 时的元素个数
+};
+
+/**
+ * @brief 以 mmap 文件为存储的 vector
+ * @tparam T                必须可平凡复制
+ * */
+template <class T>
+class mapped_vector {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "mapped_vector<T> requires a trivially copyable T");
+  static_assert(alignof(T) <= MAPPED_HEADER_BYTES, "T is over-aligned");
+
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  typedef value_type*                             iterator;
+  typedef const value_type*                       const_iterator;
+  typedef Mystl::reverse_iterator<iterator>       reverse_iterator;
+  typedef Mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  mapped_vector() noexcept
+      : fd_(-1),
+        base_(nullptr),
+        mapped_bytes_(0),
+        size_(0),
+        cap_(0),
+        read_only_(true) {
+  }
+
+  mapped_vector(const char* path, mapped_mode mode) : mapped_vector() {
+    open(path, mode);
+  }
+
+  mapped_vector(const mapped_vector&)            = delete;
+  mapped_vector& operator=(const mapped_vector&) = delete;
+
+  mapped_vector(mapped_vector&& rhs) noexcept : mapped_vector() {
+    swap(rhs);
+  }
+
+  mapped_vector& operator=(mapped_vector&& rhs) noexcept {
+    if (this != &rhs) {
+      close();
+      swap(rhs);
+    }
+    return *this;
+  }
+
+  ~mapped_vector() {
+    close();
+  }
+
+  // 文件相关操作
+  void open(const char* path, mapped_mode mode);
+
+  // 写回元素个数并解除映射, 可写时把文件裁剪到恰好容纳全部元素
+  void close() noexcept;
+
+  // 同步元素与文件头到磁盘; 返回后文件中是当前的全部元素
+  void flush();
+
+  bool is_open() const noexcept {
+    return base_ != nullptr;
+  }
+
+  bool read_only() const noexcept {
+    return read_only_;
+  }
+
+  // 迭代器相关操作
+  iterator begin() {
+    return data();
+  }
+
+  const_iterator begin() const noexcept {
+    return data();
+  }
+
+  iterator end() {
+    return data() + size_;
+  }
+
+  const_iterator end() const noexcept {
+    return data() + size_;
+  }
+
+  reverse_iterator rbegin() {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const noexcept {
+    return begin();
+  }
+
+  const_iterator cend() const noexcept {
+    return end();
+  }
+
+  // 容量相关
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  size_type size() const noexcept {
+    return size_;
+  }
+
+  size_type max_size() const noexcept {
+    return (static_cast<size_type>(-1) - MAPPED_HEADER_BYTES) / sizeof(T);
+  }
+
+  size_type capacity() const noexcept {
+    return cap_;
+  }
+
+  void reserve(size_type n);
+
+  // 把文件裁剪到恰好容纳全部元素
+  void shrink_to_fit();
+
+  // 访问元素相关操作, 只读打开时非 const 版本抛出异常
+  reference operator[](size_type n) {
+    MYSTL_DEBUG(n < size_);
+    return data()[n];
+  }
+
+  const_reference operator[](size_type n) const {
+    MYSTL_DEBUG(n < size_);
+    return data()[n];
+  }
+
+  reference at(size_type n) {
+    THROW_OUT_OF_RANGE_IF(!(n < size_),
+                          "mapped_vector<T>::at() subscript out of range");
+    return data()[n];
+  }
+
+  const_reference at(size_type n) const {
+    THROW_OUT_OF_RANGE_IF(!(n < size_),
+                          "mapped_vector<T>::at() subscript out of range");
+    return data()[n];
+  }
+
+  reference front() {
+    MYSTL_DEBUG(!empty());
+    return data()[0];
+  }
+
+  const_reference front() const {
+    MYSTL_DEBUG(!empty());
+    return data()[0];
+  }
+
+  reference back() {
+    MYSTL_DEBUG(!empty());
+    return data()[size_ - 1];
+  }
+
+  const_reference back() const {
+    MYSTL_DEBUG(!empty());
+    return data()[size_ - 1];
+  }
+
+  // 未打开时为 nullptr; 只读映射写入会触发 SIGSEGV, 因此不给出可写指针
+  pointer data() {
+    THROW_RUNTIME_ERROR_IF(is_open() && read_only_,
+                           "mapped_vector<T> is opened read-only");
+    return base_ == nullptr
+               ? nullptr
+               : reinterpret_cast<pointer>(base_ + MAPPED_HEADER_BYTES);
+  }
+
+  const_pointer data() const noexcept {
+    return base_ == nullptr
+               ? nullptr
+               : reinterpret_cast<const_pointer>(base_ + MAPPED_HEADER_BYTES);
+  }
+
+  // 修改容器相关操作
+  // 先复制 value, 扩大映射可能使 value 所引用的元素失效
+  void push_back(const value_type& value) {
+    if (size_ == cap_) {
+      const value_type tmp = value;
+      reserve_more(1);
+      data()[size_++] = tmp;
+    } else {
+      data()[size_++] = value;
+    }
+  }
+
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    push_back(value_type(Mystl::forward<Args>(args)...));
+  }
+
+  void pop_back() {
+    MYSTL_DEBUG(!empty());
+    --size_;
+  }
+
+  // 在尾部追加 [first, last), 不能来自本容器
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  void append_range(Iter first, Iter last) {
+    range_append(first, last, iterator_category(first));
+  }
+
+  void clear() noexcept {
+    size_ = 0;
+  }
+
+  void resize(size_type new_size) {
+    resize(new_size, value_type());
+  }
+
+  void resize(size_type new_size, const value_type& value);
+
+  void swap(mapped_vector& rhs) noexcept {
+    Mystl::swap(fd_, rhs.fd_);
+    Mystl::swap(base_, rhs.base_);
+    Mystl::swap(mapped_bytes_, rhs.mapped_bytes_);
+    Mystl::swap(size_, rhs.size_);
+    Mystl::swap(cap_, rhs.cap_);
+    Mystl::swap(read_only_, rhs.read_only_);
+  }
+
+private:
+  // helper function
+  mapped_vector_header* header() const noexcept {
+    return reinterpret_cast<mapped_vector_header*>(base_);
+  }
+
+  static size_t file_bytes(size_type n) noexcept {
+    return MAPPED_HEADER_BYTES + n * sizeof(T);
+  }
+
+  // 按扩容策略为再追加 n 个元素预留空间
+  void reserve_more(size_type n);
+
+  // 把文件与映射调整为恰好容纳 new_cap 个元素
+  void remap(size_type new_cap);
+
+  template <class IIter>
+  void range_append(IIter first, IIter last, input_iterator_tag) {
+    for (; first != last; ++first) {
+      push_back(*first);
+    }
+  }
+
+  template <class FIter>
+  void range_append(FIter first, FIter last, forward_iterator_tag) {
+    const size_type n = Mystl::distance(first, last);
+    if (cap_ - size_ < n) {
+      reserve_more(n);
+    }
+    Mystl::uninitialized_copy(first, last, data() + size_);
+    size_ += n;
+  }
+
+  int       fd_;            // 只读打开时映射后即关闭, 为 -1
+  char*     base_;          // 映射的起始地址, 即文件头
+  size_t    mapped_bytes_;  // 映射的字节数, 等于文件长度
+  size_type size_;          // 元素个数
+  size_type cap_;           // 文件中能容纳的元素个数
+  bool      read_only_;     // 是否只读
+};
+
+/*****************************************************************************************/
+
+static const char MAPPED_MAGIC[8] = {'M', 'Y', 'S', 'T', 'L', 'M', 'V', '1'};
+
+/**
+ * @brief 打开 path 并映射到内存, 已打开时先关闭
+ * @param  path             My Pan doc
+ * @param  mode             My Pan doc
+ * */
+template <class T>
+void mapped_vector<T>::open(const char* path, mapped_mode mode) {
+  close();
+#if defined(__linux__)
+  const bool writable = mode != mapped_read_only;
+  int        flags    = writable ? O_RDWR | O_CREAT : O_RDONLY;
+  if (mode == mapped_truncate) {
+    flags |= O_TRUNC;
+  }
+  const int fd = ::open(path, flags | O_CLOEXEC, 0644);
+  THROW_RUNTIME_ERROR_IF(fd < 0, "mapped_vector<T>: can not open file");
+
+  struct stat st;
+  size_t      bytes = 0;
+  bool        fresh = false;
+  if (::fstat(fd, &st) == 0) {
+    bytes = static_cast<size_t>(st.st_size);
+    // 空文件按新建处理
+    if (bytes == 0 && writable && ::ftruncate(fd, MAPPED_HEADER_BYTES) == 0) {
+      bytes = MAPPED_HEADER_BYTES;
+      fresh = true;
+    }
+  }
+  void* p = bytes < MAPPED_HEADER_BYTES
+                ? MAP_FAILED
+                : ::mmap(nullptr, bytes,
+                         writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    ::close(fd);
+    throw std::runtime_error("mapped_vector<T>: can not map file");
+  }
+
+  mapped_vector_header* h = static_cast<mapped_vector_header*>(p);
+  if (fresh) {
+    std::memcpy(h->magic, MAPPED_MAGIC, sizeof(MAPPED_MAGIC));
+    h->elem_size = sizeof(T);
+    h->size      = 0;
+  }
+  const size_type cap = (bytes - MAPPED_HEADER_BYTES) / sizeof(T);
+  if (std::memcmp(h->magic, MAPPED_MAGIC, sizeof(MAPPED_MAGIC)) != 0 ||
+      h->elem_size != sizeof(T) || h->size > cap) {
+    ::munmap(p, bytes);
+    ::close(fd);
+    throw std::runtime_error("mapped_vector<T>: not a valid file for T");
+  }
+
+  // 只读映射不需要保留文件描述符
+  if (!writable) {
+    ::close(fd);
+  }
+  // 只读时没有可写的容量, 追加元素会在 remap 中抛出异常
+  fd_           = writable ? fd : -1;
+  base_         = static_cast<char*>(p);
+  mapped_bytes_ = bytes;
+  size_         = h->size;
+  cap_          = writable ? cap : h->size;
+  read_only_    = !writable;
+#else
+  (void)path;
+  (void)mode;
+  throw std::runtime_error("mapped_vector<T> requires Linux");
+#endif  // __linux__
+}
+
+template <class T>
+void mapped_vector<T>::close() noexcept {
+  if (base_ == nullptr) {
+    return;
+  }
+#if defined(__linux__)
+  if (!read_only_) {
+    header()->size = size_;
+  }
+  ::munmap(base_, mapped_bytes_);
+  if (fd_ >= 0) {
+    // 裁剪失败时文件只是多出未使用的容量
+    const int rc = ::ftruncate(fd_, static_cast<off_t>(file_bytes(size_)));
+    (void)rc;
+    ::close(fd_);
+  }
+#endif  // __linux__
+  fd_           = -1;
+  base_         = nullptr;
+  mapped_bytes_ = 0;
+  size_         = 0;
+  cap_          = 0;
+  read_only_    = true;
+}
+
+/**
+ * @brief 先同步元素再写回并同步文件头, 文件头中的个数不会超前于已落盘
+ *        的元素
+ * */
+template <class T>
+void mapped_vector<T>::flush() {
+  if (base_ == nullptr || read_only_) {
+    return;
+  }
+#if defined(__linux__)
+  THROW_RUNTIME_ERROR_IF(::msync(base_, file_bytes(size_), MS_SYNC) != 0,
+                         "mapped_vector<T>: msync failed");
+  header()->size = size_;
+  THROW_RUNTIME_ERROR_IF(::msync(base_, MAPPED_HEADER_BYTES, MS_SYNC) != 0,
+                         "mapped_vector<T>: msync failed");
+#endif  // __linux__
+}
+
+template <class T>
+void mapped_vector<T>::reserve(size_type n) {
+  if (cap_ < n) {
+    THROW_LENGTH_ERROR_IF(
+        n > max_size(),
+        "n can not larger than max_size() in mapped_vector<T>::reserve");
+    remap(n);
+  }
+}
+
+template <class T>
+void mapped_vector<T>::shrink_to_fit() {
+  if (base_ != nullptr && !read_only_ && cap_ != size_) {
+    remap(size_);
+  }
+}
+
+template <class T>
+void mapped_vector<T>::resize(size_type new_size, const value_type& value) {
+  if (new_size > size_) {
+    const value_type tmp = value;
+    reserve(new_size);
+    Mystl::uninitialized_fill_n(data() + size_, new_size - size_, tmp);
+  }
+  size_ = new_size;
+}
+
+// helper function
+
+template <class T>
+void mapped_vector<T>::reserve_more(size_type n) {
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - n,
+                        "mapped_vector<T>'s size too big");
+  const size_type required = size_ + n;
+  const size_type new_cap  = vector_default_growth::next_capacity(
+      Mystl::allocator<T>(), cap_, required);
+  remap(new_cap < required || new_cap > max_size() ? required : new_cap);
+}
+
+/**
+ * @brief 文件先变长后变短: 扩大时先 ftruncate 再 mremap, 缩小时先 mremap
+ *        再 ftruncate, 映射范围始终在文件之内。失败时容器不变
+ * @param  new_cap          My Pan doc
+ * */
+template <class T>
+void mapped_vector<T>::remap(size_type new_cap) {
+  THROW_RUNTIME_ERROR_IF(base_ == nullptr || read_only_,
+                         "mapped_vector<T> is not open for writing");
+#if defined(__linux__)
+  const size_t new_bytes = file_bytes(new_cap);
+  const bool   grow      = new_bytes > mapped_bytes_;
+  if (grow) {
+    THROW_RUNTIME_ERROR_IF(
+        ::ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0,
+        "mapped_vector<T>: can not extend file");
+  }
+  void* p = ::mremap(base_, mapped_bytes_, new_bytes, MREMAP_MAYMOVE);
+  if (p == MAP_FAILED) {
+    if (grow) {
+      const int rc = ::ftruncate(fd_, static_cast<off_t>(mapped_bytes_));
+      (void)rc;
+    }
+    throw std::bad_alloc();
+  }
+  if (!grow) {
+    const int rc = ::ftruncate(fd_, static_cast<off_t>(new_bytes));
+    (void)rc;
+  }
+  base_         = static_cast<char*>(p);
+  mapped_bytes_ = new_bytes;
+  cap_          = new_cap;
+#else
+  (void)new_cap;
+#endif  // __linux__
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+template <class T>
+bool operator==(const mapped_vector<T>& lhs, const mapped_vector<T>& rhs) {
+  return lhs.size() == rhs.size() &&
+         Mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T>
+bool operator!=(const mapped_vector<T>& lhs, const mapped_vector<T>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <class T>
+void swap(mapped_vector<T>& lhs, mapped_vector<T>& rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+}  // namespace Mystl
+
+#endif /* __MAPPED_VECTOR_H__ */
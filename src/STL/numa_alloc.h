@@ -0,0 +1,333 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file numa_alloc.h
+ * @brief 按 NUMA 策略放置内存的 allocator
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-18 10:05:26
+ *
+ * numa_allocator<T> 对不小于 NUMA_MIN_BYTES 的请求直接 mmap 匿名内存,
+ * 并通过 mbind 系统调用把它绑定到指定节点或在多个节点间交错分布; 小请求
+ * 仍交给 Mystl::allocator。直接使用系统调用, 不依赖 libnuma。内核不支持
+ * NUMA、节点不存在或非 Linux 平台时, 策略设置失败被忽略, 内存按默认的
+ * first-touch 策略放置, 因此在单节点机器上也可以正常使用。
+ *
+ * */
+
+#ifndef __NUMA_ALLOC_H__
+#define __NUMA_ALLOC_H__
+
+#include <cstddef>
+#include <fstream>
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // __linux__
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+namespace Mystl {
+
+// 小于该值的请求不单独映射, 也不设置策略
+enum { NUMA_MIN_BYTES = 64 * 1024 };
+
+// 与内核 MPOL_* 的取值一致
+enum numa_mode {
+  numa_default    = 0,  // 使用线程的策略, 通常是 first-touch
+  numa_preferred  = 1,  // 优先使用指定节点
+  numa_bind       = 2,  // 只使用指定节点
+  numa_interleave = 3   // 在指定节点间按页交错
+};
+
+/**
+ * @brief 内存放置策略, nodemask 的第 i 位表示节点 i
+ * */
+struct numa_policy {
+  numa_mode     mode;
+  unsigned long nodemask;
+
+  numa_policy() : mode(numa_default), nodemask(0) {
+  }
+
+  numa_policy(numa_mode m, unsigned long mask) : mode(m), nodemask(mask) {
+  }
+
+  // node 超出 nodemask 的位数时与节点不存在一样, 退回默认策略
+  static numa_policy bind_to(int node) {
+    return single_node(numa_bind, node);
+  }
+
+  static numa_policy preferred(int node) {
+    return single_node(numa_preferred, node);
+  }
+
+  static numa_policy interleave(unsigned long mask) {
+    return numa_policy(numa_interleave, mask);
+  }
+
+  // 在全部在线节点间交错
+  static numa_policy interleave_all();
+
+private:
+  static numa_policy single_node(numa_mode m, int node) {
+    if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8)) {
+      return numa_policy();
+    }
+    return numa_policy(m, 1UL << node);
+  }
+};
+
+/**
+ * @brief 读取 /sys 中在线节点的掩码, 无法读取时视为只有节点 0
+ * @return unsigned long
+ * */
+inline unsigned long numa_online_nodes() {
+  std::ifstream in("/sys/devices/system/node/online");
+  std::string   list;
+  if (!(in >> list)) {
+    return 1UL;
+  }
+
+  // 格式形如 "0" 或 "0-1,4-5"
+  unsigned long mask = 0;
+  size_t        pos  = 0;
+  while (pos < list.size()) {
+    size_t len   = 0;
+    int    first = std::stoi(list.substr(pos), &len);
+    int    last  = first;
+    pos += len;
+    if (pos < list.size() && list[pos] == '-') {
+      last = std::stoi(list.substr(pos + 1), &len);
+      pos += 1 + len;
+    }
+    for (int node = first; node <= last; ++node) {
+      if (node < static_cast<int>(sizeof(unsigned long) * 8)) {
+        mask |= 1UL << node;
+      }
+    }
+    if (pos < list.size() && list[pos] == ',') {
+      ++pos;
+    }
+  }
+  return mask == 0 ? 1UL : mask;
+}
+
+inline numa_policy numa_policy::interleave_all() {
+  return numa_policy(numa_interleave, numa_online_nodes());
+}
+
+/**
+ * @brief 以 mbind 为 [addr, addr + len) 设置策略, addr 必须按页对齐
+ * @param  addr             My Pan doc
+ * @param  len              My Pan doc
+ * @param  policy           My Pan doc
+ * @return bool             系统不支持或参数无效时返回 false
+ * */
+inline bool numa_apply(void* addr, size_t len, const numa_policy& policy) {
+#if defined(__linux__) && defined(SYS_mbind)
+  if (policy.mode == numa_default) {
+    return true;
+  }
+  // 内核只读取 maxnode - 1 位
+  const unsigned long maxnode = sizeof(unsigned long) * 8 + 1;
+  return ::syscall(SYS_mbind, addr, len, static_cast<int>(policy.mode),
+                   &policy.nodemask, maxnode, 0) == 0;
+#else
+  (void)addr;
+  (void)len;
+  return policy.mode == numa_default;
+#endif  // __linux__ && SYS_mbind
+}
+
+/**
+ * @brief 以 set_mempolicy 设置当前线程之后分配内存的策略
+ * @param  policy           My Pan doc
+ * @return bool             系统不支持或参数无效时返回 false
+ * */
+inline bool numa_set_thread_policy(const numa_policy& policy) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  const unsigned long  maxnode = sizeof(unsigned long) * 8 + 1;
+  const unsigned long* mask =
+      policy.mode == numa_default ? nullptr : &policy.nodemask;
+  return ::syscall(SYS_set_mempolicy, static_cast<int>(policy.mode), mask,
+                   policy.mode == numa_default ? 0UL : maxnode) == 0;
+#else
+  return policy.mode == numa_default;
+#endif  // __linux__ && SYS_set_mempolicy
+}
+
+/**
+ * @brief 查询 addr 所在页实际分配在哪个节点上, 页必须已被访问过
+ * @param  addr             My Pan doc
+ * @return int              无法查询时返回 -1
+ * */
+inline int numa_node_of(const void* addr) {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+  // MPOL_F_NODE | MPOL_F_ADDR
+  const unsigned long flags = 1UL | 2UL;
+  int                 node  = -1;
+  if (::syscall(SYS_get_mempolicy, &node, nullptr, 0UL, addr, flags) != 0) {
+    return -1;
+  }
+  return node;
+#else
+  (void)addr;
+  return -1;
+#endif  // __linux__ && SYS_get_mempolicy
+}
+
+/**
+ * @brief 按 NUMA 策略放置大块内存的 allocator。任意两个实例分配的内存都可以
+ *        互相释放, 因此视为总是相等; 策略不随容器赋值或交换传播
+ * @tparam T
+ * */
+template <class T>
+class numa_allocator {
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  typedef m_true_type is_always_equal;
+
+  template <class U>
+  struct rebind {
+    typedef numa_allocator<U> other;
+  };
+
+  numa_allocator() noexcept : policy_() {
+  }
+
+  numa_allocator(const numa_policy& policy) noexcept : policy_(policy) {
+  }
+
+  template <class U>
+  numa_allocator(const numa_allocator<U>& rhs) noexcept
+      : policy_(rhs.policy()) {
+  }
+
+  const numa_policy& policy() const noexcept {
+    return policy_;
+  }
+
+  T* allocate() {
+    return Mystl::allocator<T>::allocate();
+  }
+
+  T* allocate(size_type n) {
+    if (0 == n) {
+      return nullptr;
+    }
+    if (!is_large(n)) {
+      return Mystl::allocator<T>::allocate(n);
+    }
+    const size_t bytes = round_up(n * sizeof(T));
+#if defined(__linux__)
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#else
+    void* p = aligned_allocate(bytes, page_size());
+#endif  // __linux__
+    // 策略设置失败时退化为默认的 first-touch 放置
+    numa_apply(p, bytes, policy_);
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* ptr) {
+    Mystl::allocator<T>::deallocate(ptr);
+  }
+
+  void deallocate(T* ptr, size_type n) {
+    if (nullptr == ptr) return;
+    if (!is_large(n)) {
+      Mystl::allocator<T>::deallocate(ptr, n);
+      return;
+    }
+#if defined(__linux__)
+    ::munmap(ptr, round_up(n * sizeof(T)));
+#else
+    aligned_deallocate(ptr);
+#endif  // __linux__
+  }
+
+  // 大块请求按整页计算
+  static size_type good_size(size_type n) {
+    if (!is_large(n)) {
+      return Mystl::allocator<T>::good_size(n);
+    }
+    return round_up(n * sizeof(T)) / sizeof(T);
+  }
+
+  static void construct(T* ptr) {
+    Mystl::construct(ptr);
+  }
+
+  static void construct(T* ptr, const T& value) {
+    Mystl::construct(ptr, value);
+  }
+
+  static void construct(T* ptr, T&& value) {
+    Mystl::construct(ptr, Mystl::move(value));
+  }
+
+  template <class... Args>
+  static void construct(T* ptr, Args&&... args) {
+    Mystl::construct(ptr, Mystl::forward<Args>(args)...);
+  }
+
+  static void destroy(T* ptr) {
+    Mystl::destroy(ptr);
+  }
+
+  static void destroy(T* first, T* last) {
+    Mystl::destroy(first, last);
+  }
+
+private:
+  static bool is_large(size_type n) {
+    return n * sizeof(T) >= static_cast<size_t>(NUMA_MIN_BYTES);
+  }
+
+  static size_t page_size() {
+#if defined(__linux__)
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif  // __linux__
+  }
+
+  static size_t round_up(size_t bytes) {
+    const size_t page = page_size();
+    return (bytes + page - 1) / page * page;
+  }
+
+  numa_policy policy_;  // 大块内存的放置策略
+};
+
+template <class T, class U>
+bool operator==(const numa_allocator<T>&, const numa_allocator<U>&) {
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const numa_allocator<T>&, const numa_allocator<U>&) {
+  return false;
+}
+
+}  // namespace Mystl
+
+#endif /* __NUMA_ALLOC_H__ */
@@ -0,0 +1,826 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file segmented_vector.h
+ * @brief 分段存储、扩容时不搬移元素的 vector
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-23 10:05:37
+ *
+ * segmented_vector<T, ChunkSize> 把元素保存在若干个大小相同的分段中, 每段
+ * ChunkSize 个元素, ChunkSize 必须是 2 的幂。容量不足时只追加一个新分段,
+ * 已有元素从不搬移, 因此:
+ *
+ *   - 扩容时不需要同时持有新旧两份空间, 峰值内存只比元素多出不到一个分段;
+ *   - 元素的引用与指针在整个生命周期内保持有效 (被删除的元素除外);
+ *   - 下标访问是一次移位、一次掩码与两次读内存, 仍为 O(1)。
+ *
+ * 分段表本身是一个 Mystl::vector<T*>, 使用由 Alloc 重新绑定得到的
+ * allocator。追加分段时分段表可能重新分配, 因此
+ * push_back 会使迭代器失效, 但不会使引用失效。chunk_begin() / chunk_end()
+ * 按分段遍历, 每个分段以 span 的形式给出, 适合批量处理。
+ *
+ * */
+
+#ifndef __SEGMENTED_VECTOR_H__
+#define __SEGMENTED_VECTOR_H__
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "memory.h"
+#include "span.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "vector.h"
+
+namespace Mystl {
+
+// 默认每个分段占用的字节数, 可以在包含本文件之前定义
+// MYSTL_SEGMENT_BYTES 修改
+#if !defined(MYSTL_SEGMENT_BYTES)
+#define MYSTL_SEGMENT_BYTES (256 * 1024)
+#endif  // MYSTL_SEGMENT_BYTES
+
+enum { SEGMENT_BYTES = MYSTL_SEGMENT_BYTES };
+
+// 不大于 n 的最大的 2 的幂, n 为 0 时为 1
+constexpr size_t floor_power_of_two(size_t n) {
+  return n < 2 ? 1 : 2 * floor_power_of_two(n / 2);
+}
+
+// 默认的分段大小: 不超过 SEGMENT_BYTES 的最多元素个数, 取 2 的幂
+template <class T>
+struct segment_default_size
+    : m_integral_constant<size_t,
+                          floor_power_of_two(SEGMENT_BYTES / sizeof(T))> {};
+
+/**
+ * @brief segmented_vector 的迭代器, 保存分段表与下标
+ * @tparam T
+ * @tparam Ref
+ * @tparam Ptr
+ * @tparam ChunkSize
+ * */
+template <class T, class Ref, class Ptr, size_t ChunkSize>
+struct segmented_iterator
+    : public Mystl::iterator<Mystl::random_access_iterator_tag,
+                             T,
+                             ptrdiff_t,
+                             Ptr,
+                             Ref> {
+  typedef Ref                                         reference;
+  typedef Ptr                                         pointer;
+  typedef ptrdiff_t                                   difference_type;
+  typedef T* const*                                   map_pointer;
+  typedef segmented_iterator<T, Ref, Ptr, ChunkSize> self;
+
+  map_pointer map_;    // 分段表
+  size_t      index_;  // 元素的下标
+
+  segmented_iterator() noexcept : map_(nullptr), index_(0) {
+  }
+
+  segmented_iterator(map_pointer map, size_t index) noexcept
+      : map_(map), index_(index) {
+  }
+
+  // iterator 可以转换为 const_iterator
+  template <class R, class P>
+  segmented_iterator(
+      const segmented_iterator<T, R, P, ChunkSize>& rhs) noexcept
+      : map_(rhs.map_), index_(rhs.index_) {
+  }
+
+  // 重载操作符
+  reference operator*() const {
+    return map_[index_ / ChunkSize][index_ % ChunkSize];
+  }
+
+  pointer operator->() const {
+    return &(operator*());
+  }
+
+  reference operator[](difference_type n) const {
+    return *(*this + n);
+  }
+
+  self& operator++() {
+    ++index_;
+    return *this;
+  }
+
+  self operator++(int) {
+    self tmp = *this;
+    ++index_;
+    return tmp;
+  }
+
+  self& operator--() {
+    --index_;
+    return *this;
+  }
+
+  self operator--(int) {
+    self tmp = *this;
+    --index_;
+    return tmp;
+  }
+
+  self& operator+=(difference_type n) {
+    index_ += n;
+    return *this;
+  }
+
+  self& operator-=(difference_type n) {
+    index_ -= n;
+    return *this;
+  }
+
+  self operator+(difference_type n) const {
+    return self(map_, index_ + n);
+  }
+
+  self operator-(difference_type n) const {
+    return self(map_, index_ - n);
+  }
+
+  difference_type operator-(const self& rhs) const {
+    return static_cast<difference_type>(index_) -
+           static_cast<difference_type>(rhs.index_);
+  }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const {
+    return index_ == rhs.index_;
+  }
+
+  bool operator!=(const self& rhs) const {
+    return index_ != rhs.index_;
+  }
+
+  bool operator<(const self& rhs) const {
+    return index_ < rhs.index_;
+  }
+
+  bool operator>(const self& rhs) const {
+    return rhs < *this;
+  }
+
+  bool operator<=(const self& rhs) const {
+    return !(rhs < *this);
+  }
+
+  bool operator>=(const self& rhs) const {
+    return !(*this < rhs);
+  }
+};
+
+/**
+ * @brief 按分段遍历的迭代器, 解引用得到一个分段中全部元素的 span
+ * @tparam T                元素类型, 只读遍历时为 const T
+ * @tparam ChunkSize
+ * */
+template <class T, size_t ChunkSize>
+struct segmented_chunk_iterator
+    : public Mystl::iterator<Mystl::random_access_iterator_tag,
+                             span<T>,
+                             ptrdiff_t,
+                             void,
+                             span<T>> {
+  typedef span<T>                               reference;
+  typedef ptrdiff_t                             difference_type;
+  typedef typename std::remove_const<T>::type*  value_pointer;
+  typedef value_pointer const*                  map_pointer;
+  typedef segmented_chunk_iterator<T, ChunkSize> self;
+
+  map_pointer map_;    // 分段表
+  size_t      chunk_;  // 分段的序号
+  size_t      size_;   // 容器的元素个数
+
+  segmented_chunk_iterator() noexcept : map_(nullptr), chunk_(0), size_(0) {
+  }
+
+  segmented_chunk_iterator(map_pointer map, size_t chunk, size_t size) noexcept
+      : map_(map), chunk_(chunk), size_(size) {
+  }
+
+  // 最后一个分段可能没有装满
+  reference operator*() const {
+    const size_t first = chunk_ * ChunkSize;
+    const size_t n     = size_ - first < ChunkSize ? size_ - first : ChunkSize;
+    return reference(map_[chunk_], n);
+  }
+
+  self& operator++() {
+    ++chunk_;
+    return *this;
+  }
+
+  self operator++(int) {
+    self tmp = *this;
+    ++chunk_;
+    return tmp;
+  }
+
+  self& operator--() {
+    --chunk_;
+    return *this;
+  }
+
+  self operator--(int) {
+    self tmp = *this;
+    --chunk_;
+    return tmp;
+  }
+
+  self& operator+=(difference_type n) {
+    chunk_ += n;
+    return *this;
+  }
+
+  self operator+(difference_type n) const {
+    return self(map_, chunk_ + n, size_);
+  }
+
+  difference_type operator-(const self& rhs) const {
+    return static_cast<difference_type>(chunk_) -
+           static_cast<difference_type>(rhs.chunk_);
+  }
+
+  bool operator==(const self& rhs) const {
+    return chunk_ == rhs.chunk_;
+  }
+
+  bool operator!=(const self& rhs) const {
+    return chunk_ != rhs.chunk_;
+  }
+
+  bool operator<(const self& rhs) const {
+    return chunk_ < rhs.chunk_;
+  }
+};
+
+/**
+ * @brief 分段存储的 vector
+ * @tparam T
+ * @tparam ChunkSize        每个分段的元素个数, 必须是 2 的幂
+ * @tparam Alloc            分段的 allocator
+ * */
+template <class T,
+          size_t ChunkSize = segment_default_size<T>::value,
+          class Alloc      = Mystl::allocator<T>>
+class segmented_vector : private Mystl::alloc_holder<Alloc> {
+  static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0,
+                "segmented_vector chunk size must be a power of two");
+  static_assert(!std::is_same<bool, T>::value,
+                "segmented_vector<bool> is abandoned in Mystl");
+
+public:
+  typedef Alloc                          allocator_type;
+  typedef Mystl::allocator_traits<Alloc> alloc_traits;
+  typedef Mystl::alloc_holder<Alloc>     alloc_base;
+
+  typedef typename allocator_type::value_type      value_type;
+  typedef typename allocator_type::pointer         pointer;
+  typedef typename allocator_type::const_pointer   const_pointer;
+  typedef typename allocator_type::reference       reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::size_type       size_type;
+  typedef typename allocator_type::difference_type difference_type;
+
+  typedef segmented_iterator<T, T&, T*, ChunkSize> iterator;
+  typedef segmented_iterator<T, const T&, const T*, ChunkSize>
+                                                  const_iterator;
+  typedef Mystl::reverse_iterator<iterator>       reverse_iterator;
+  typedef Mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  typedef segmented_chunk_iterator<T, ChunkSize>       chunk_iterator;
+  typedef segmented_chunk_iterator<const T, ChunkSize> const_chunk_iterator;
+
+private:
+  // 分段表与元素使用同一个 allocator 的不同绑定
+  typedef typename alloc_traits::template rebind_alloc<T*> map_allocator;
+  typedef Mystl::vector<T*, map_allocator>                 chunk_table;
+
+public:
+
+  // 每个分段的元素个数
+  enum { chunk_size = ChunkSize };
+
+  allocator_type get_allocator() const {
+    return get_alloc();
+  }
+
+  segmented_vector() noexcept : chunks_(), size_(0) {
+  }
+
+  explicit segmented_vector(const allocator_type& alloc) noexcept
+      : alloc_base(alloc), chunks_(map_allocator(alloc)), size_(0) {
+  }
+
+  explicit segmented_vector(size_type             n,
+                            const allocator_type& alloc = allocator_type())
+      : alloc_base(alloc), chunks_(map_allocator(alloc)), size_(0) {
+    guarded_init([this, n]() { resize(n); });
+  }
+
+  segmented_vector(size_type             n,
+                   const value_type&     value,
+                   const allocator_type& alloc = allocator_type())
+      : alloc_base(alloc), chunks_(map_allocator(alloc)), size_(0) {
+    guarded_init([this, n, &value]() { resize(n, value); });
+  }
+
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  segmented_vector(Iter                  first,
+                   Iter                  last,
+                   const allocator_type& alloc = allocator_type())
+      : alloc_base(alloc), chunks_(map_allocator(alloc)), size_(0) {
+    guarded_init([this, first, last]() { append_range(first, last); });
+  }
+
+  segmented_vector(std::initializer_list<value_type> ilist,
+                   const allocator_type&             alloc = allocator_type())
+      : alloc_base(alloc), chunks_(map_allocator(alloc)), size_(0) {
+    guarded_init(
+        [this, &ilist]() { append_range(ilist.begin(), ilist.end()); });
+  }
+
+  segmented_vector(const segmented_vector& rhs)
+      : alloc_base(alloc_traits::select_on_container_copy_construction(
+            rhs.get_alloc())),
+        chunks_(map_allocator(get_alloc())),
+        size_(0) {
+    guarded_init([this, &rhs]() { append_range(rhs.begin(), rhs.end()); });
+  }
+
+  segmented_vector(segmented_vector&& rhs) noexcept
+      : alloc_base(Mystl::move(rhs.get_alloc())),
+        chunks_(Mystl::move(rhs.chunks_)),
+        size_(rhs.size_) {
+    rhs.size_ = 0;
+  }
+
+  // allocator 不变时复用已有的分段
+  segmented_vector& operator=(const segmented_vector& rhs) {
+    if (this != &rhs) {
+      typedef typename alloc_traits::propagate_on_container_copy_assignment
+          pocca;
+      if (pocca::value && !alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+        // 旧的分段与分段表只能由旧的 allocator 释放
+        tidy();
+        // 复制赋值一个空表, 让分段表也换用 rhs 的 allocator
+        const chunk_table empty(map_allocator(rhs.get_alloc()));
+        chunks_ = empty;
+      }
+      copy_alloc(rhs, pocca());
+      clear();
+      append_range(rhs.begin(), rhs.end());
+    }
+    return *this;
+  }
+
+  segmented_vector& operator=(segmented_vector&& rhs) {
+    if (this != &rhs) {
+      move_assign(
+          rhs,
+          m_bool_constant<
+              alloc_traits::propagate_on_container_move_assignment::value ||
+              alloc_traits::is_always_equal::value>());
+    }
+    return *this;
+  }
+
+  ~segmented_vector() {
+    tidy();
+  }
+
+  // 迭代器相关操作
+  iterator begin() noexcept {
+    return iterator(chunks_.data(), 0);
+  }
+
+  const_iterator begin() const noexcept {
+    return const_iterator(chunks_.data(), 0);
+  }
+
+  iterator end() noexcept {
+    return iterator(chunks_.data(), size_);
+  }
+
+  const_iterator end() const noexcept {
+    return const_iterator(chunks_.data(), size_);
+  }
+
+  reverse_iterator rbegin() noexcept {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() noexcept {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const noexcept {
+    return begin();
+  }
+
+  const_iterator cend() const noexcept {
+    return end();
+  }
+
+  // 按分段遍历
+  chunk_iterator chunk_begin() noexcept {
+    return chunk_iterator(chunks_.data(), 0, size_);
+  }
+
+  const_chunk_iterator chunk_begin() const noexcept {
+    return const_chunk_iterator(chunks_.data(), 0, size_);
+  }
+
+  chunk_iterator chunk_end() noexcept {
+    return chunk_iterator(chunks_.data(), chunk_count(), size_);
+  }
+
+  const_chunk_iterator chunk_end() const noexcept {
+    return const_chunk_iterator(chunks_.data(), chunk_count(), size_);
+  }
+
+  // 容量相关
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  size_type size() const noexcept {
+    return size_;
+  }
+
+  size_type max_size() const noexcept {
+    return static_cast<size_type>(-1) / sizeof(T);
+  }
+
+  size_type capacity() const noexcept {
+    return chunks_.size() * ChunkSize;
+  }
+
+  // 含有元素的分段数
+  size_type chunk_count() const noexcept {
+    return (size_ + ChunkSize - 1) / ChunkSize;
+  }
+
+  void reserve(size_type n);
+
+  // 释放没有元素的分段
+  void shrink_to_fit();
+
+  // 访问元素相关操作
+  reference operator[](size_type n) {
+    MYSTL_DEBUG(n < size_);
+    return chunks_[n / ChunkSize][n % ChunkSize];
+  }
+
+  const_reference operator[](size_type n) const {
+    MYSTL_DEBUG(n < size_);
+    return chunks_[n / ChunkSize][n % ChunkSize];
+  }
+
+  reference at(size_type n) {
+    THROW_OUT_OF_RANGE_IF(!(n < size_),
+                          "segmented_vector<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  const_reference at(size_type n) const {
+    THROW_OUT_OF_RANGE_IF(!(n < size_),
+                          "segmented_vector<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference front() {
+    MYSTL_DEBUG(!empty());
+    return (*this)[0];
+  }
+
+  const_reference front() const {
+    MYSTL_DEBUG(!empty());
+    return (*this)[0];
+  }
+
+  reference back() {
+    MYSTL_DEBUG(!empty());
+    return (*this)[size_ - 1];
+  }
+
+  const_reference back() const {
+    MYSTL_DEBUG(!empty());
+    return (*this)[size_ - 1];
+  }
+
+  // 第 k 个分段中的元素
+  span<T> chunk(size_type k) {
+    MYSTL_DEBUG(k < chunk_count());
+    return *(chunk_begin() + k);
+  }
+
+  span<const T> chunk(size_type k) const {
+    MYSTL_DEBUG(k < chunk_count());
+    return *(chunk_begin() + k);
+  }
+
+  // 修改容器相关操作
+  // 新元素所在的分段已存在时只构造元素, 否则先追加一个分段; 已有元素
+  // 不会移动, 因此 args 可以引用本容器中的元素
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    if (size_ == capacity()) {
+      add_chunk();
+    }
+    get_alloc().construct(slot(size_), Mystl::forward<Args>(args)...);
+    ++size_;
+  }
+
+  void push_back(const value_type& value) {
+    emplace_back(value);
+  }
+
+  void push_back(value_type&& value) {
+    emplace_back(Mystl::move(value));
+  }
+
+  void pop_back() {
+    MYSTL_DEBUG(!empty());
+    --size_;
+    get_alloc().destroy(slot(size_));
+  }
+
+  // 在尾部追加一段元素, 逐个分段地批量复制
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  void append_range(Iter first, Iter last) {
+    range_append(first, last, iterator_category(first));
+  }
+
+  // 销毁全部元素, 保留分段
+  void clear() noexcept {
+    destroy_from(0);
+  }
+
+  void resize(size_type new_size) {
+    resize_with(new_size, [this]() { emplace_back(); });
+  }
+
+  void resize(size_type new_size, const value_type& value) {
+    resize_with(new_size, [this, &value]() { emplace_back(value); });
+  }
+
+  void swap(segmented_vector& rhs) noexcept;
+
+private:
+  using alloc_base::get_alloc;
+
+  // helper function
+  // 下标 n 处元素的地址, n 可以等于 size()
+  pointer slot(size_type n) const noexcept {
+    return chunks_[n / ChunkSize] + n % ChunkSize;
+  }
+
+  // 在分段表末尾追加一个分段
+  void add_chunk();
+
+  // 销毁下标不小于 n 的元素
+  void destroy_from(size_type n) noexcept;
+
+  // 销毁全部元素并释放所有分段
+  void tidy() noexcept;
+
+  // 构造函数中出错时释放已申请的分段
+  template <class F>
+  void guarded_init(F init) {
+    try {
+      init();
+    } catch (...) {
+      tidy();
+      throw;
+    }
+  }
+
+  template <class F>
+  void resize_with(size_type new_size, F append_one) {
+    if (new_size < size_) {
+      destroy_from(new_size);
+    } else {
+      reserve(new_size);
+      while (size_ < new_size) {
+        append_one();
+      }
+    }
+  }
+
+  template <class IIter>
+  void range_append(IIter first, IIter last, input_iterator_tag);
+
+  template <class FIter>
+  void range_append(FIter first, FIter last, forward_iterator_tag);
+
+  void move_assign(segmented_vector& rhs, m_true_type);
+  void move_assign(segmented_vector& rhs, m_false_type);
+
+  void copy_alloc(const segmented_vector& rhs, m_true_type) {
+    get_alloc() = rhs.get_alloc();
+  }
+
+  void copy_alloc(const segmented_vector&, m_false_type) {
+  }
+
+  void swap_alloc(segmented_vector& rhs, m_true_type) {
+    Mystl::swap(get_alloc(), rhs.get_alloc());
+  }
+
+  void swap_alloc(segmented_vector&, m_false_type) {
+  }
+
+  chunk_table chunks_;  // 分段表, 每个分段 ChunkSize 个元素
+  size_type   size_;    // 元素个数
+};
+
+/*****************************************************************************************/
+
+// 预留空间大小, 按分段追加, 已有元素不动
+template <class T, size_t ChunkSize, class Alloc>
+void segmented_vector<T, ChunkSize, Alloc>::reserve(size_type n) {
+  if (capacity() < n) {
+    THROW_LENGTH_ERROR_IF(
+        n > max_size(),
+        "n can not larger than max_size() in segmented_vector<T>::reserve");
+    chunks_.reserve((n + ChunkSize - 1) / ChunkSize);
+    while (capacity() < n) {
+      add_chunk();
+    }
+  }
+}
+
+template <class T, size_t ChunkSize, class Alloc>
+void segmented_vector<T, ChunkSize, Alloc>::shrink_to_fit() {
+  const size_type used = chunk_count();
+  while (chunks_.size() > used) {
+    get_alloc().deallocate(chunks_.back(), ChunkSize);
+    chunks_.pop_back();
+  }
+  chunks_.shrink_to_fit();
+}
+
+/**
+ * @brief 与另一个 segmented_vector 交换
+ * @param  rhs              My Pan doc
+ * */
+template <class T, size_t ChunkSize, class Alloc>
+void segmented_vector<T, ChunkSize, Alloc>::swap(
+    segmented_vector& rhs) noexcept {
+  if (this != &rhs) {
+    // 不传播 allocator 时, 两者必须相等
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                alloc_traits::equal(get_alloc(), rhs.get_alloc()));
+    chunks_.swap(rhs.chunks_);
+    Mystl::swap(size_, rhs.size_);
+    swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+  }
+}
+
+// helper function
+
+// 先在分段表中占位, 申请分段失败时再去掉, 不会泄漏
+template <class T, size_t ChunkSize, class Alloc>
+void segmented_vector<T, ChunkSize, Alloc>::add_chunk() {
+  chunks_.push_back(nullptr);
+  try {
+    chunks_.back() = get_alloc().allocate(ChunkSize);
+  } catch (...) {
+    chunks_.pop_back();
+    throw;
+  }
+}
+
+template <class T, size_t ChunkSize, class Alloc>
+void segmented_vector<T, ChunkSize, Alloc>::destroy_from(
+    size_type n) noexcept {
+  for (size_type i = n; i < size_;) {
+    T*              chunk = chunks_[i / ChunkSize];
+    const size_type first = i % ChunkSize;
+    const size_type last =
+        size_ - (i - first) < ChunkSize ? size_ - (i - first) : ChunkSize;
+    get_alloc().destroy(chunk + first, chunk + last);
+    i += last - first;
+  }
+  size_ = n;
+}
+
+template <class T, size_t ChunkSize, class Alloc>
+void segmented_vector<T, ChunkSize, Alloc>::tidy() noexcept {
+  destroy_from(0);
+  for (size_type k = 0; k < chunks_.size(); ++k) {
+    get_alloc().deallocate(chunks_[k], ChunkSize);
+  }
+  chunks_.clear();
+}
+
+template <class T, size_t ChunkSize, class Alloc>
+template <class IIter>
+void segmented_vector<T, ChunkSize, Alloc>::range_append(IIter first,
+                                                         IIter last,
+                                                         input_iterator_tag) {
+  for (; first != last; ++first) {
+    emplace_back(*first);
+  }
+}
+
+/**
+ * @brief 先按总长度补齐分段, 再逐个分段调用 uninitialized_copy_n_pair,
+ *        从上一段复制结束的位置继续, 不再重复遍历已复制的元素。
+ *        中途失败时已复制的元素保留在容器中
+ * */
+template <class T, size_t ChunkSize, class Alloc>
+template <class FIter>
+void segmented_vector<T, ChunkSize, Alloc>::range_append(
+    FIter first,
+    FIter last,
+    forward_iterator_tag) {
+  size_type n = Mystl::distance(first, last);
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - n,
+                        "segmented_vector<T>'s size too big");
+  reserve(size_ + n);
+  while (n != 0) {
+    const size_type offset = size_ % ChunkSize;
+    const size_type count  = ChunkSize - offset < n ? ChunkSize - offset : n;
+    first = Mystl::uninitialized_copy_n_pair(first, count, slot(size_)).first;
+    size_ += count;
+    n -= count;
+  }
+}
+
+// 可以直接接管 rhs 的分段
+template <class T, size_t ChunkSize, class Alloc>
+void segmented_vector<T, ChunkSize, Alloc>::move_assign(segmented_vector& rhs,
+                                                        m_true_type) {
+  tidy();
+  copy_alloc(rhs,
+             typename alloc_traits::propagate_on_container_move_assignment());
+  chunks_   = Mystl::move(rhs.chunks_);
+  size_     = rhs.size_;
+  rhs.size_ = 0;
+}
+
+// allocator 不相等时 rhs 的分段不能由本容器释放, 只能逐个移动元素
+template <class T, size_t ChunkSize, class Alloc>
+void segmented_vector<T, ChunkSize, Alloc>::move_assign(segmented_vector& rhs,
+                                                        m_false_type) {
+  if (alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  clear();
+  reserve(rhs.size_);
+  for (size_type i = 0; i < rhs.size_; ++i) {
+    emplace_back(Mystl::move(rhs[i]));
+  }
+  rhs.clear();
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+template <class T, size_t ChunkSize, class Alloc>
+bool operator==(const segmented_vector<T, ChunkSize, Alloc>& lhs,
+                const segmented_vector<T, ChunkSize, Alloc>& rhs) {
+  return lhs.size() == rhs.size() &&
+         Mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t ChunkSize, class Alloc>
+bool operator!=(const segmented_vector<T, ChunkSize, Alloc>& lhs,
+                const segmented_vector<T, ChunkSize, Alloc>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <class T, size_t ChunkSize, class Alloc>
+void swap(segmented_vector<T, ChunkSize, Alloc>& lhs,
+          segmented_vector<T, ChunkSize, Alloc>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace Mystl
+
+#endif /* __SEGMENTED_VECTOR_H__ */
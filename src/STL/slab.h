@@ -0,0 +1,238 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file slab.h
+ * @brief 固定大小对象的 slab 配置器, 用于 list 节点
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-15 10:05:12
+ *
+ * 每个 (大小, 对齐) 组合对应一个 slab_pool。slab_pool 向系统申请按 cache
+ * line 对齐的页, 在页内按地址递增的顺序切出对象, 因此连续申请的节点在
+ * 内存中也是连续的, 遍历新建的 list 时可以顺序访问 cache line。释放的对象
+ * 挂在侵入式的自由链表上, 下次申请时优先复用。页在进程生命周期内不会
+ * 归还给系统。
+ *
+ * */
+
+#ifndef __SLAB_H__
+#define __SLAB_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include "construct.h"
+#include "util.h"
+
+namespace Mystl {
+
+// cache line 大小, slab 页按该值对齐
+enum { SLAB_CACHE_LINE = 64 };
+// 每页的最小字节数
+enum { SLAB_PAGE_SIZE = 4096 };
+// 每页至少容纳的对象个数
+enum { SLAB_MIN_OBJS = 16 };
+
+/**
+ * @brief 固定大小对象的内存池
+ * @tparam Size             对象大小
+ * @tparam Align            对象对齐
+ * @tparam threads          是否需要加锁
+ * */
+template <size_t Size, size_t Align, bool threads>
+class slab_pool {
+public:
+  static void* allocate();
+  static void  deallocate(void* p) noexcept;
+
+private:
+  struct slot {
+    slot* next;
+  };
+
+  // 页的头部, 串起全部页, 位于每页原始内存的起始处
+  struct page_header {
+    page_header* next;
+  };
+
+  enum {
+    SLOT_ALIGN = Align > alignof(slot) ? Align : alignof(slot),
+    SLOT_RAW   = Size > sizeof(slot) ? Size : sizeof(slot),
+    SLOT_SIZE  = (SLOT_RAW + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN,
+    PAGE_ALIGN = SLOT_ALIGN > SLAB_CACHE_LINE
+                     ? static_cast<size_t>(SLOT_ALIGN)
+                     : static_cast<size_t>(SLAB_CACHE_LINE),
+    PAGE_SIZE  = SLOT_SIZE * SLAB_MIN_OBJS > SLAB_PAGE_SIZE
+                     ? static_cast<size_t>(SLOT_SIZE * SLAB_MIN_OBJS)
+                     : static_cast<size_t>(SLAB_PAGE_SIZE)
+  };
+
+  struct lock {
+    lock() {
+      if (threads) mutex_.lock();
+    }
+    ~lock() {
+      if (threads) mutex_.unlock();
+    }
+  };
+
+  static void new_page();
+
+  static slot*        free_list_;  // 已释放对象的链表
+  static char*        cur_;        // 当前页中下一个可用位置
+  static char*        end_;        // 当前页的结束位置
+  static page_header* pages_;      // 已申请的页
+  static std::mutex   mutex_;
+};
+
+template <size_t Size, size_t Align, bool threads>
+typename slab_pool<Size, Align, threads>::slot*
+    slab_pool<Size, Align, threads>::free_list_ = nullptr;
+
+template <size_t Size, size_t Align, bool threads>
+char* slab_pool<Size, Align, threads>::cur_ = nullptr;
+
+template <size_t Size, size_t Align, bool threads>
+char* slab_pool<Size, Align, threads>::end_ = nullptr;
+
+template <size_t Size, size_t Align, bool threads>
+typename slab_pool<Size, Align, threads>::page_header*
+    slab_pool<Size, Align, threads>::pages_ = nullptr;
+
+template <size_t Size, size_t Align, bool threads>
+std::mutex slab_pool<Size, Align, threads>::mutex_;
+
+/**
+ * @brief 取出一个对象, 优先复用自由链表, 否则从当前页顺序切出
+ * @return void*
+ * */
+template <size_t Size, size_t Align, bool threads>
+void* slab_pool<Size, Align, threads>::allocate() {
+  lock guard;
+  if (free_list_ != nullptr) {
+    slot* result = free_list_;
+    free_list_   = result->next;
+    return result;
+  }
+  if (cur_ == end_) {
+    new_page();
+  }
+  void* result = cur_;
+  cur_ += SLOT_SIZE;
+  return result;
+}
+
+template <size_t Size, size_t Align, bool threads>
+void slab_pool<Size, Align, threads>::deallocate(void* p) noexcept {
+  lock  guard;
+  slot* q    = static_cast<slot*>(p);
+  q->next    = free_list_;
+  free_list_ = q;
+}
+
+/**
+ * @brief 申请新的一页, 页头之后按 PAGE_ALIGN 对齐, 调用者已持有锁
+ * */
+template <size_t Size, size_t Align, bool threads>
+void slab_pool<Size, Align, threads>::new_page() {
+  const size_t raw_size = sizeof(page_header) + PAGE_ALIGN + PAGE_SIZE;
+  char*        raw      = static_cast<char*>(::operator new(raw_size));
+  page_header* header   = reinterpret_cast<page_header*>(raw);
+  header->next          = pages_;
+  pages_                = header;
+
+  const uintptr_t v = reinterpret_cast<uintptr_t>(raw + sizeof(page_header));
+  cur_ = reinterpret_cast<char*>((v + PAGE_ALIGN - 1) &
+                                 ~static_cast<uintptr_t>(PAGE_ALIGN - 1));
+  end_ = cur_ + PAGE_SIZE / SLOT_SIZE * SLOT_SIZE;
+}
+
+/**
+ * @brief 以 slab_pool 为后端的 allocator, 单个对象从 slab 分配,
+ *        一次申请多个对象时交给 ::operator new
+ * @tparam T
+ * @tparam threads          是否需要加锁, 默认线程安全
+ * */
+template <class T, bool threads = true>
+class slab_allocator {
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  typedef slab_pool<sizeof(T), alignof(T), threads> pool;
+
+  template <class U>
+  struct rebind {
+    typedef slab_allocator<U, threads> other;
+  };
+
+  slab_allocator() noexcept {
+  }
+
+  template <class U>
+  slab_allocator(const slab_allocator<U, threads>&) noexcept {
+  }
+
+  static T* allocate() {
+    return static_cast<T*>(pool::allocate());
+  }
+
+  static T* allocate(size_type n) {
+    if (0 == n) {
+      return nullptr;
+    }
+    if (1 == n) {
+      return allocate();
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  static void deallocate(T* ptr) {
+    if (nullptr == ptr) return;
+    pool::deallocate(ptr);
+  }
+
+  static void deallocate(T* ptr, size_type n) {
+    if (nullptr == ptr) return;
+    if (1 == n) {
+      pool::deallocate(ptr);
+    } else {
+      ::operator delete(ptr);
+    }
+  }
+
+  static void construct(T* ptr) {
+    Mystl::construct(ptr);
+  }
+
+  static void construct(T* ptr, const T& value) {
+    Mystl::construct(ptr, value);
+  }
+
+  static void construct(T* ptr, T&& value) {
+    Mystl::construct(ptr, Mystl::move(value));
+  }
+
+  template <class... Args>
+  static void construct(T* ptr, Args&&... args) {
+    Mystl::construct(ptr, Mystl::forward<Args>(args)...);
+  }
+
+  static void destroy(T* ptr) {
+    Mystl::destroy(ptr);
+  }
+
+  static void destroy(T* first, T* last) {
+    Mystl::destroy(first, last);
+  }
+};
+
+}  // namespace Mystl
+
+#endif /* __SLAB_H__ */
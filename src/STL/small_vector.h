@@ -0,0 +1,915 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file small_vector.h
+ * @brief 带内联缓冲区的 vector
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-19 10:05:21
+ *
+ * small_vector<T, N> 的前 N 个元素保存在对象内部的缓冲区中, 不申请堆内存;
+ * 元素超过 N 个时才像 vector 一样向 allocator 申请空间, 之后按 1.5 倍增长。
+ * 扩容、插入与删除与 vector 共用 vector_ops.h 中的搬移操作: 先在新位置
+ * 构造新元素, 再把原有元素搬到它两侧, 元素可平凡重定位时直接按字节搬移。
+ *
+ * 内联元素位于对象内部, 移动或交换内联状态的 small_vector 需要逐个搬移
+ * 元素, 并且会使迭代器失效; small_vector 本身不可平凡重定位。
+ *
+ * */
+
+#ifndef __SMALL_VECTOR_H__
+#define __SMALL_VECTOR_H__
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "memory.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "vector_growth.h"
+#include "vector_ops.h"
+
+namespace Mystl {
+
+/**
+ * @brief 前 N 个元素内联存储的 vector
+ * @tparam T
+ * @tparam N                内联缓冲区可以容纳的元素个数
+ * @tparam Alloc            超过 N 个元素后使用的 allocator
+ * */
+template <class T, size_t N, class Alloc = Mystl::allocator<T>>
+class small_vector : private Mystl::alloc_holder<Alloc> {
+  static_assert(N > 0, "small_vector needs at least one inline element");
+  static_assert(!std::is_same<bool, T>::value,
+                "small_vector<bool> is abandoned in Mystl");
+
+public:
+  typedef Alloc                          allocator_type;
+  typedef Mystl::allocator_traits<Alloc> alloc_traits;
+  typedef Mystl::alloc_holder<Alloc>     alloc_base;
+
+  typedef typename allocator_type::value_type      value_type;
+  typedef typename allocator_type::pointer         pointer;
+  typedef typename allocator_type::const_pointer   const_pointer;
+  typedef typename allocator_type::reference       reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::size_type       size_type;
+  typedef typename allocator_type::difference_type difference_type;
+
+  typedef value_type *                            iterator;
+  typedef const value_type *                      const_iterator;
+  typedef Mystl::reverse_iterator<iterator>       reverse_iterator;
+  typedef Mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  // 内联缓冲区的容量
+  enum { inline_capacity = N };
+
+  allocator_type get_allocator() const {
+    return get_alloc();
+  }
+
+  small_vector() noexcept {
+    reset_inline();
+  }
+
+  explicit small_vector(const allocator_type &alloc) noexcept
+      : alloc_base(alloc) {
+    reset_inline();
+  }
+
+  explicit small_vector(size_type             n,
+                        const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
+    reset_inline();
+    fill_insert(end_, n, value_type());
+  }
+
+  small_vector(size_type             n,
+               const value_type &    value,
+               const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
+    reset_inline();
+    fill_insert(end_, n, value);
+  }
+
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  small_vector(Iter                  first,
+               Iter                  last,
+               const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
+    reset_inline();
+    range_insert(end_, first, last, iterator_category(first));
+  }
+
+  small_vector(const small_vector &rhs)
+      : alloc_base(alloc_traits::select_on_container_copy_construction(
+            rhs.get_alloc())) {
+    reset_inline();
+    copy_insert(end_, rhs.begin_, rhs.end_);
+  }
+
+  small_vector(small_vector &&rhs) noexcept(
+      std::is_nothrow_move_constructible<T>::value)
+      : alloc_base(Mystl::move(rhs.get_alloc())) {
+    reset_inline();
+    take(rhs);
+  }
+
+  small_vector(std::initializer_list<value_type> ilist,
+               const allocator_type &            alloc = allocator_type())
+      : alloc_base(alloc) {
+    reset_inline();
+    copy_insert(end_, ilist.begin(), ilist.end());
+  }
+
+  small_vector &operator=(const small_vector &rhs);
+
+  small_vector &operator=(small_vector &&rhs);
+
+  small_vector &operator=(std::initializer_list<value_type> ilist) {
+    copy_assign(ilist.begin(), ilist.end(), Mystl::forward_iterator_tag{});
+    return *this;
+  }
+
+  ~small_vector() {
+    release_storage();
+  }
+
+  // 迭代器相关操作
+  iterator begin() noexcept {
+    return begin_;
+  }
+
+  const_iterator begin() const noexcept {
+    return begin_;
+  }
+
+  iterator end() noexcept {
+    return end_;
+  }
+
+  const_iterator end() const noexcept {
+    return end_;
+  }
+
+  reverse_iterator rbegin() noexcept {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() noexcept {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const noexcept {
+    return begin();
+  }
+
+  const_iterator cend() const noexcept {
+    return end();
+  }
+
+  const_reverse_iterator crbegin() const noexcept {
+    return rbegin();
+  }
+
+  const_reverse_iterator crend() const noexcept {
+    return rend();
+  }
+
+  // 容量相关
+  bool empty() const noexcept {
+    return begin_ == end_;
+  }
+
+  size_type size() const noexcept {
+    return static_cast<size_type>(end_ - begin_);
+  }
+
+  size_type max_size() const noexcept {
+    return static_cast<size_type>(-1) / sizeof(T);
+  }
+
+  size_type capacity() const noexcept {
+    return static_cast<size_type>(cap_ - begin_);
+  }
+
+  // 元素是否仍保存在内联缓冲区中
+  bool is_inline() const noexcept {
+    return begin_ == inline_begin();
+  }
+
+  void reserve(size_type n);
+
+  void shrink_to_fit();
+
+  // 访问元素相关操作
+  reference operator[](size_type n) {
+    MYSTL_DEBUG(n < size());
+    return *(begin_ + n);
+  }
+
+  const_reference operator[](size_type n) const {
+    MYSTL_DEBUG(n < size());
+    return *(begin_ + n);
+  }
+
+  reference at(size_type n) {
+    THROW_OUT_OF_RANGE_IF(!(n < size()),
+                          "small_vector<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  const_reference at(size_type n) const {
+    THROW_OUT_OF_RANGE_IF(!(n < size()),
+                          "small_vector<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference front() {
+    MYSTL_DEBUG(!empty());
+    return *begin_;
+  }
+
+  const_reference front() const {
+    MYSTL_DEBUG(!empty());
+    return *begin_;
+  }
+
+  reference back() {
+    MYSTL_DEBUG(!empty());
+    return *(end_ - 1);
+  }
+
+  const_reference back() const {
+    MYSTL_DEBUG(!empty());
+    return *(end_ - 1);
+  }
+
+  pointer data() noexcept {
+    return begin_;
+  }
+
+  const_pointer data() const noexcept {
+    return begin_;
+  }
+
+  // 修改容器相关操作
+  // assign
+  void assign(size_type n, const value_type &value);
+
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  void assign(Iter first, Iter last) {
+    copy_assign(first, last, iterator_category(first));
+  }
+
+  void assign(std::initializer_list<value_type> ilist) {
+    copy_assign(ilist.begin(), ilist.end(), Mystl::forward_iterator_tag{});
+  }
+
+  // emplace / emplace back
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args &&...args);
+
+  template <class... Args>
+  void emplace_back(Args &&...args) {
+    if (end_ < cap_) {
+      get_alloc().construct(Mystl::address_of(*end_),
+                            Mystl::forward<Args>(args)...);
+      ++end_;
+    } else {
+      reallocate_emplace(end_, Mystl::forward<Args>(args)...);
+    }
+  }
+
+  // push_back / pop_back
+  void push_back(const value_type &value) {
+    emplace_back(value);
+  }
+
+  void push_back(value_type &&value) {
+    emplace_back(Mystl::move(value));
+  }
+
+  void pop_back() {
+    MYSTL_DEBUG(!empty());
+    get_alloc().destroy(end_ - 1);
+    --end_;
+  }
+
+  // insert
+  iterator insert(const_iterator pos, const value_type &value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, value_type &&value) {
+    return emplace(pos, Mystl::move(value));
+  }
+
+  iterator insert(const_iterator pos, size_type n, const value_type &value) {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    return fill_insert(const_cast<iterator>(pos), n, value);
+  }
+
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  void insert(const_iterator pos, Iter first, Iter last) {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    range_insert(const_cast<iterator>(pos), first, last,
+                 iterator_category(first));
+  }
+
+  void insert(const_iterator pos, std::initializer_list<value_type> ilist) {
+    insert(pos, ilist.begin(), ilist.end());
+  }
+
+  // erase / clear
+  iterator erase(const_iterator pos) {
+    MYSTL_DEBUG(pos >= begin() && pos < end());
+    return erase(pos, pos + 1);
+  }
+
+  iterator erase(const_iterator first, const_iterator last);
+
+  void clear() noexcept {
+    get_alloc().destroy(begin_, end_);
+    end_ = begin_;
+  }
+
+  // resize
+  void resize(size_type new_size) {
+    resize(new_size, value_type());
+  }
+
+  void resize(size_type new_size, const value_type &value) {
+    if (new_size < size()) {
+      erase(begin() + new_size, end());
+    } else {
+      insert(end(), new_size - size(), value);
+    }
+  }
+
+  // swap
+  void swap(small_vector &rhs);
+
+private:
+  using alloc_base::get_alloc;
+
+  // 元素可平凡重定位时, 扩容以及插入删除时的平移直接搬移字节
+  typedef is_trivially_relocatable<T> relocate_tag;
+
+  // helper function
+  // storage
+  iterator inline_begin() noexcept {
+    return reinterpret_cast<iterator>(&buf_);
+  }
+
+  const_iterator inline_begin() const noexcept {
+    return reinterpret_cast<const_iterator>(&buf_);
+  }
+
+  void reset_inline() noexcept {
+    begin_ = end_ = inline_begin();
+    cap_          = begin_ + N;
+  }
+
+  void release_storage() noexcept;
+
+  void take(small_vector &rhs);
+
+  // calculate the growth size
+  size_type get_new_cap(size_type add_size) const;
+
+  // relocate
+  void release_old(m_true_type) noexcept;
+  void release_old(m_false_type) noexcept;
+
+  void relocate_around(iterator  pos,
+                       size_type n,
+                       iterator  new_begin,
+                       size_type new_cap);
+
+  void release_new(iterator new_begin, size_type new_cap) noexcept;
+
+  // assign
+  template <class IIter>
+  void copy_assign(IIter first, IIter last, input_iterator_tag);
+
+  template <class FIter>
+  void copy_assign(FIter first, FIter last, forward_iterator_tag);
+
+  // insert
+  template <class... Args>
+  void reallocate_emplace(iterator pos, Args &&...args);
+
+  iterator fill_insert(iterator pos, size_type n, const value_type &value);
+
+  template <class FIter>
+  void copy_insert(iterator pos, FIter first, FIter last);
+
+  template <class IIter>
+  void range_insert(iterator pos, IIter first, IIter last, input_iterator_tag);
+
+  template <class FIter>
+  void range_insert(iterator pos,
+                    FIter    first,
+                    FIter    last,
+                    forward_iterator_tag);
+
+  // move assign
+  void move_assign(small_vector &rhs, m_true_type);
+  void move_assign(small_vector &rhs, m_false_type);
+
+  // propagate allocator
+  void copy_alloc(const small_vector &rhs, m_true_type) {
+    get_alloc() = rhs.get_alloc();
+  }
+  void copy_alloc(const small_vector &, m_false_type) {
+  }
+
+  void swap_alloc(small_vector &rhs, m_true_type) {
+    Mystl::swap(get_alloc(), rhs.get_alloc());
+  }
+  void swap_alloc(small_vector &, m_false_type) {
+  }
+
+private:
+  iterator begin_;  // 表示目前使用空间的头部
+  iterator end_;    // 表示目前使用空间的尾部
+  iterator cap_;    // 表示目前存储空间的尾部
+
+  // 内联缓冲区, 元素不超过 N 个时 begin_ 指向这里
+  typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+};
+
+/*****************************************************************************************/
+
+// 复制赋值操作符, allocator 传播且不相等时旧空间先由旧的 allocator 释放
+template <class T, size_t N, class Alloc>
+small_vector<T, N, Alloc> &small_vector<T, N, Alloc>::operator=(
+    const small_vector &rhs) {
+  if (this != &rhs) {
+    typedef typename alloc_traits::propagate_on_container_copy_assignment pocca;
+    if (pocca::value && !alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+      release_storage();
+      reset_inline();
+    }
+    copy_alloc(rhs, pocca());
+    copy_assign(rhs.begin_, rhs.end_, Mystl::forward_iterator_tag{});
+  }
+  return *this;
+}
+
+// 移动赋值操作符, 与 vector 相同按 allocator 能否传播或总是相等分派
+template <class T, size_t N, class Alloc>
+small_vector<T, N, Alloc> &small_vector<T, N, Alloc>::operator=(
+    small_vector &&rhs) {
+  if (this != &rhs) {
+    move_assign(
+        rhs,
+        m_bool_constant<
+            alloc_traits::propagate_on_container_move_assignment::value ||
+            alloc_traits::is_always_equal::value>());
+  }
+  return *this;
+}
+
+// 预留空间大小, 当原容量小于要求大小时, 才会重新分配
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::reserve(size_type n) {
+  if (capacity() < n) {
+    THROW_LENGTH_ERROR_IF(
+        n > max_size(),
+        "n can not larger than max_size() in small_vector<T>::reserve");
+    relocate_around(end_, 0, get_alloc().allocate(n), n);
+  }
+}
+
+// 放弃多余容量, 元素个数不超过 N 时搬回内联缓冲区
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::shrink_to_fit() {
+  if (is_inline() || end_ == cap_) {
+    return;
+  }
+  if (size() <= N) {
+    relocate_around(end_, 0, inline_begin(), N);
+  } else {
+    relocate_around(end_, 0, get_alloc().allocate(size()), size());
+  }
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::assign(size_type n, const value_type &value) {
+  if (n > capacity()) {
+    // value 可能引用本容器中的元素, 先构造好新的内容
+    *this = small_vector(n, value, get_alloc());
+  } else if (n > size()) {
+    Mystl::fill(begin_, end_, value);
+    end_ = Mystl::uninitialized_fill_n(end_, n - size(), value);
+  } else {
+    erase(Mystl::fill_n(begin_, n, value), end_);
+  }
+}
+
+template <class T, size_t N, class Alloc>
+template <class... Args>
+typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::emplace(
+    const_iterator pos,
+    Args &&...args) {
+  MYSTL_DEBUG(pos >= begin() && pos <= end());
+  iterator        xpos = const_cast<iterator>(pos);
+  const size_type n    = xpos - begin_;
+  if (end_ != cap_ && xpos == end_) {
+    get_alloc().construct(Mystl::address_of(*end_),
+                          Mystl::forward<Args>(args)...);
+    ++end_;
+  } else if (end_ != cap_) {
+    Mystl::vector_emplace_in_place(get_alloc(), xpos, end_, relocate_tag(),
+                                   Mystl::forward<Args>(args)...);
+  } else {
+    reallocate_emplace(xpos, Mystl::forward<Args>(args)...);
+  }
+
+  return begin_ + n;
+}
+
+// 删除[first, last)上的元素
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::erase(
+    const_iterator first,
+    const_iterator last) {
+  MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+  iterator xfirst = begin_ + (first - begin());
+  if (first != last) {
+    Mystl::vector_erase_shift(get_alloc(), xfirst, begin_ + (last - begin()),
+                              end_, relocate_tag());
+  }
+  return xfirst;
+}
+
+/**
+ * @brief 与另一个 small_vector 交换。经由 take 互换内容: 在堆上时只交换
+ *        指针, 内联时逐个搬移元素; 之后按 propagate_on_container_swap
+ *        交换 allocator, 使每块堆空间仍由申请它的 allocator 释放
+ * @param  rhs              My Pan doc
+ * */
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::swap(small_vector &rhs) {
+  if (this == &rhs) {
+    return;
+  }
+  // 不传播 allocator 时, 两者必须相等
+  MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+              alloc_traits::equal(get_alloc(), rhs.get_alloc()));
+  small_vector tmp(rhs.get_alloc());
+  tmp.take(rhs);
+  rhs.take(*this);
+  take(tmp);
+  swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+}
+
+// helper function
+
+// 销毁全部元素, 释放堆上的空间
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::release_storage() noexcept {
+  get_alloc().destroy(begin_, end_);
+  if (!is_inline()) {
+    get_alloc().deallocate(begin_, capacity());
+  }
+}
+
+/**
+ * @brief 从 rhs 取得全部元素, 调用前本对象必须是空的内联状态。rhs 在堆上
+ *        时直接接管空间, 否则逐个搬移内联元素; rhs 最终为空
+ * @param  rhs              My Pan doc
+ * */
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::take(small_vector &rhs) {
+  if (rhs.is_inline()) {
+    end_     = Mystl::uninitialized_relocate(rhs.begin_, rhs.end_, begin_);
+    rhs.end_ = rhs.begin_;
+  } else {
+    begin_ = rhs.begin_;
+    end_   = rhs.end_;
+    cap_   = rhs.cap_;
+    rhs.reset_inline();
+  }
+}
+
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::size_type
+small_vector<T, N, Alloc>::get_new_cap(size_type add_size) const {
+  THROW_LENGTH_ERROR_IF(size() > max_size() - add_size,
+                        "small_vector<T>'s size too big");
+  const size_type required = size() + add_size;
+  const size_type new_cap  = vector_default_growth::next_capacity(
+      get_alloc(), capacity(), required);
+  return new_cap < required || new_cap > max_size() ? required : new_cap;
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::release_old(m_true_type) noexcept {
+  if (!is_inline()) {
+    get_alloc().deallocate(begin_, capacity());
+  }
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::release_old(m_false_type) noexcept {
+  release_storage();
+}
+
+// 新空间是内联缓冲区时不需要释放
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::release_new(iterator  new_begin,
+                                            size_type new_cap) noexcept {
+  if (new_begin != inline_begin()) {
+    get_alloc().deallocate(new_begin, new_cap);
+  }
+}
+
+/**
+ * @brief 把原有元素搬到新空间, 在 pos 对应的位置留出 n 个空位, 然后释放
+ *        旧空间。新空间可以是内联缓冲区; 搬移失败时销毁空位中的新元素并
+ *        释放新空间, 原容器不变
+ * @param  pos              My Pan doc
+ * @param  n                My Pan doc
+ * @param  new_begin        My Pan doc
+ * @param  new_cap          My Pan doc
+ * */
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::relocate_around(iterator  pos,
+                                                size_type n,
+                                                iterator  new_begin,
+                                                size_type new_cap) {
+  iterator new_end;
+  try {
+    new_end = Mystl::vector_relocate_around(get_alloc(), begin_, pos, end_, n,
+                                            new_begin, relocate_tag());
+  } catch (...) {
+    release_new(new_begin, new_cap);
+    throw;
+  }
+
+  release_old(relocate_tag());
+  begin_ = new_begin;
+  end_   = new_end;
+  cap_   = new_begin + new_cap;
+}
+
+template <class T, size_t N, class Alloc>
+template <class IIter>
+void small_vector<T, N, Alloc>::copy_assign(IIter first,
+                                            IIter last,
+                                            input_iterator_tag) {
+  auto cur = begin_;
+  for (; first != last && cur != end_; ++first, ++cur) {
+    *cur = *first;
+  }
+  if (first == last) {
+    erase(cur, end_);
+  } else {
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  }
+}
+
+template <class T, size_t N, class Alloc>
+template <class FIter>
+void small_vector<T, N, Alloc>::copy_assign(FIter first,
+                                            FIter last,
+                                            forward_iterator_tag) {
+  const size_type len = Mystl::distance(first, last);
+  if (len > capacity()) {
+    auto new_begin = get_alloc().allocate(len);
+    try {
+      Mystl::uninitialized_copy(first, last, new_begin);
+    } catch (...) {
+      get_alloc().deallocate(new_begin, len);
+      throw;
+    }
+    release_storage();
+    begin_ = new_begin;
+    end_   = new_begin + len;
+    cap_   = new_begin + len;
+  } else if (size() >= len) {
+    auto new_end = Mystl::copy(first, last, begin_);
+    get_alloc().destroy(new_end, end_);
+    end_ = new_end;
+  } else {
+    auto mid = first;
+    Mystl::advance(mid, size());
+    Mystl::copy(first, mid, begin_);
+    end_ = Mystl::uninitialized_copy(mid, last, end_);
+  }
+}
+
+/**
+ * @brief 申请新空间, 先在新空间中构造新元素, 再把原有元素搬到它两侧。
+ *        args 可能引用本容器中的元素, 因此必须先构造
+ * */
+template <class T, size_t N, class Alloc>
+template <class... Args>
+void small_vector<T, N, Alloc>::reallocate_emplace(iterator pos,
+                                                   Args &&...args) {
+  const size_type new_cap   = get_new_cap(1);
+  auto            new_begin = get_alloc().allocate(new_cap);
+  try {
+    get_alloc().construct(Mystl::address_of(*(new_begin + (pos - begin_))),
+                          Mystl::forward<Args>(args)...);
+  } catch (...) {
+    get_alloc().deallocate(new_begin, new_cap);
+    throw;
+  }
+  relocate_around(pos, 1, new_begin, new_cap);
+}
+
+// 从 pos 开始插入 n 个元素
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::fill_insert(iterator          pos,
+                                       size_type         n,
+                                       const value_type &value) {
+  if (n == 0) {
+    return pos;
+  }
+
+  const size_type  xpos       = pos - begin_;
+  const value_type value_copy = value;  // value 可能引用本容器中的元素
+  if (static_cast<size_type>(cap_ - end_) >= n) {
+    Mystl::vector_fill_in_place(get_alloc(), pos, end_, n, value_copy,
+                                relocate_tag());
+  } else {
+    const auto new_cap   = get_new_cap(n);
+    auto       new_begin = get_alloc().allocate(new_cap);
+    try {
+      Mystl::uninitialized_fill_n(new_begin + xpos, n, value_copy);
+    } catch (...) {
+      get_alloc().deallocate(new_begin, new_cap);
+      throw;
+    }
+    relocate_around(pos, n, new_begin, new_cap);
+  }
+
+  return begin_ + xpos;
+}
+
+// 在 pos 处插入 [first, last) 上的元素
+template <class T, size_t N, class Alloc>
+template <class FIter>
+void small_vector<T, N, Alloc>::copy_insert(iterator pos,
+                                            FIter    first,
+                                            FIter    last) {
+  if (first == last) {
+    return;
+  }
+
+  const size_type n = Mystl::distance(first, last);
+  if (static_cast<size_type>(cap_ - end_) >= n) {
+    Mystl::vector_copy_in_place(get_alloc(), pos, end_, first, last, n,
+                                relocate_tag());
+  } else {
+    const auto new_cap   = get_new_cap(n);
+    auto       new_begin = get_alloc().allocate(new_cap);
+    try {
+      Mystl::uninitialized_copy(first, last, new_begin + (pos - begin_));
+    } catch (...) {
+      get_alloc().deallocate(new_begin, new_cap);
+      throw;
+    }
+    relocate_around(pos, n, new_begin, new_cap);
+  }
+}
+
+/**
+ * @brief 输入迭代器只能遍历一次, 无法预先得知长度: 在尾部时逐个追加,
+ *        否则先收集到临时 small_vector 中再一次插入
+ * */
+template <class T, size_t N, class Alloc>
+template <class IIter>
+void small_vector<T, N, Alloc>::range_insert(iterator pos,
+                                             IIter    first,
+                                             IIter    last,
+                                             input_iterator_tag) {
+  if (pos == end_) {
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  } else {
+    small_vector tmp(get_alloc());
+    for (; first != last; ++first) {
+      tmp.emplace_back(*first);
+    }
+    copy_insert(pos, tmp.begin_, tmp.end_);
+  }
+}
+
+template <class T, size_t N, class Alloc>
+template <class FIter>
+void small_vector<T, N, Alloc>::range_insert(iterator pos,
+                                             FIter    first,
+                                             FIter    last,
+                                             forward_iterator_tag) {
+  copy_insert(pos, first, last);
+}
+
+/**
+ * @brief 移动赋值, allocator 可以传播或总是相等时释放本容器的空间后接管
+ *        rhs 的全部元素: rhs 在堆上时直接接管空间, 否则逐个搬移内联元素
+ * @param  rhs              My Pan doc
+ * */
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::move_assign(small_vector &rhs, m_true_type) {
+  release_storage();
+  reset_inline();
+  copy_alloc(rhs,
+             typename alloc_traits::propagate_on_container_move_assignment());
+  take(rhs);
+}
+
+/**
+ * @brief 移动赋值, allocator 不相等时 rhs 的空间不能由本容器释放,
+ *        只能逐个移动元素
+ * @param  rhs              My Pan doc
+ * */
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::move_assign(small_vector &rhs, m_false_type) {
+  if (alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+
+  clear();
+  reserve(rhs.size());
+  end_ = Mystl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+  rhs.clear();
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+template <class T, size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc> &lhs,
+                const small_vector<T, N, Alloc> &rhs) {
+  return lhs.size() == rhs.size() &&
+         Mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc> &lhs,
+               const small_vector<T, N, Alloc> &rhs) {
+  return Mystl::lexicographical_compare(lhs.begin(),
+                                        lhs.end(),
+                                        rhs.begin(),
+                                        rhs.end());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc> &lhs,
+                const small_vector<T, N, Alloc> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>(const small_vector<T, N, Alloc> &lhs,
+               const small_vector<T, N, Alloc> &rhs) {
+  return rhs < lhs;
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<=(const small_vector<T, N, Alloc> &lhs,
+                const small_vector<T, N, Alloc> &rhs) {
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>=(const small_vector<T, N, Alloc> &lhs,
+                const small_vector<T, N, Alloc> &rhs) {
+  return !(lhs < rhs);
+}
+
+template <class T, size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc> &lhs, small_vector<T, N, Alloc> &rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace Mystl
+
+#endif /* __SMALL_VECTOR_H__ */
@@ -0,0 +1,824 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file soa_vector.h
+ * @brief 按列存储的 vector (struct of arrays)
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-22 09:05:31
+ *
+ * soa_vector<Fields...> 逻辑上是 vector<tuple<Fields...>>, 但每个字段单独
+ * 保存在一段连续空间中。只访问一两个字段的扫描只读取这些列, 不浪费缓存
+ * 带宽; column<I>() 返回第 I 列的 span, 可以直接交给编译器自动向量化
+ * 的循环。
+ *
+ * 迭代器是随机访问迭代器, 解引用得到由各字段引用组成的 tuple, 不提供
+ * operator->。各列由 Alloc 按字段类型 rebind 后分别申请, 扩容沿用 vector
+ * 默认的扩容策略。字段必须可以无异常地移动构造, 扩容时逐列搬移不会中途
+ * 失败。
+ *
+ * soa_vector<Fields...> 使用 Mystl::allocator, 需要其他 allocator 时使用
+ * basic_soa_vector<Alloc, Fields...>。
+ *
+ * */
+
+#ifndef __SOA_VECTOR_H__
+#define __SOA_VECTOR_H__
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "span.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "vector_growth.h"
+
+namespace Mystl {
+
+/**
+ * @brief soa_vector 的迭代器, 保存容器与下标, 解引用得到代理引用
+ * @tparam Vec              soa_vector 或 const soa_vector
+ * @tparam Ref              reference 或 const_reference
+ * */
+template <class Vec, class Ref>
+struct soa_iterator
+    : public Mystl::iterator<Mystl::random_access_iterator_tag,
+                             typename std::remove_const<Vec>::type::value_type,
+                             ptrdiff_t,
+                             void,
+                             Ref> {
+  typedef Ref                    reference;
+  typedef ptrdiff_t              difference_type;
+  typedef soa_iterator<Vec, Ref> self;
+
+  Vec*   vec_;    // 所属容器
+  size_t index_;  // 所在行
+
+  soa_iterator() noexcept : vec_(nullptr), index_(0) {
+  }
+
+  soa_iterator(Vec* vec, size_t index) noexcept : vec_(vec), index_(index) {
+  }
+
+  // iterator 可以转换为 const_iterator
+  template <class V, class R>
+  soa_iterator(const soa_iterator<V, R>& rhs) noexcept
+      : vec_(rhs.vec_), index_(rhs.index_) {
+  }
+
+  // 重载操作符
+  reference operator*() const {
+    return (*vec_)[index_];
+  }
+
+  reference operator[](difference_type n) const {
+    return (*vec_)[index_ + n];
+  }
+
+  self& operator++() {
+    ++index_;
+    return *this;
+  }
+
+  self operator++(int) {
+    self tmp = *this;
+    ++index_;
+    return tmp;
+  }
+
+  self& operator--() {
+    --index_;
+    return *this;
+  }
+
+  self operator--(int) {
+    self tmp = *this;
+    --index_;
+    return tmp;
+  }
+
+  self& operator+=(difference_type n) {
+    index_ += n;
+    return *this;
+  }
+
+  self& operator-=(difference_type n) {
+    index_ -= n;
+    return *this;
+  }
+
+  self operator+(difference_type n) const {
+    return self(vec_, index_ + n);
+  }
+
+  self operator-(difference_type n) const {
+    return self(vec_, index_ - n);
+  }
+
+  difference_type operator-(const self& rhs) const {
+    return static_cast<difference_type>(index_) -
+           static_cast<difference_type>(rhs.index_);
+  }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const {
+    return index_ == rhs.index_;
+  }
+
+  bool operator!=(const self& rhs) const {
+    return index_ != rhs.index_;
+  }
+
+  bool operator<(const self& rhs) const {
+    return index_ < rhs.index_;
+  }
+
+  bool operator>(const self& rhs) const {
+    return rhs < *this;
+  }
+
+  bool operator<=(const self& rhs) const {
+    return !(rhs < *this);
+  }
+
+  bool operator>=(const self& rhs) const {
+    return !(*this < rhs);
+  }
+};
+
+template <class Vec, class Ref>
+soa_iterator<Vec, Ref> operator+(ptrdiff_t n, const soa_iterator<Vec, Ref>& x) {
+  return x + n;
+}
+
+// 一行所占的字节数
+template <class... Fields>
+struct soa_row_bytes;
+
+template <>
+struct soa_row_bytes<> : m_integral_constant<size_t, 0> {};
+
+template <class F, class... Fields>
+struct soa_row_bytes<F, Fields...>
+    : m_integral_constant<size_t,
+                          sizeof(F) + soa_row_bytes<Fields...>::value> {};
+
+// 各字段是否都可以无异常地移动构造
+template <class... Fields>
+struct soa_nothrow_movable;
+
+template <>
+struct soa_nothrow_movable<> : m_true_type {};
+
+template <class F, class... Fields>
+struct soa_nothrow_movable<F, Fields...>
+    : m_bool_constant<std::is_nothrow_move_constructible<F>::value &&
+                      soa_nothrow_movable<Fields...>::value> {};
+
+/**
+ * @brief 按列存储的 vector
+ * @tparam Alloc            各列的 allocator 由它 rebind 得到
+ * @tparam Fields           各列的类型
+ * */
+template <class Alloc, class... Fields>
+class basic_soa_vector : private Mystl::alloc_holder<Alloc> {
+  static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+  static_assert(soa_nothrow_movable<Fields...>::value,
+                "soa_vector fields must be nothrow move constructible");
+
+public:
+  typedef Alloc                          allocator_type;
+  typedef Mystl::allocator_traits<Alloc> alloc_traits;
+  typedef Mystl::alloc_holder<Alloc>     alloc_base;
+
+  typedef std::tuple<Fields...>        value_type;
+  typedef std::tuple<Fields&...>       reference;
+  typedef std::tuple<const Fields&...> const_reference;
+  typedef size_t                       size_type;
+  typedef ptrdiff_t                    difference_type;
+
+  typedef soa_iterator<basic_soa_vector, reference> iterator;
+  typedef soa_iterator<const basic_soa_vector, const_reference>
+                                                  const_iterator;
+  typedef Mystl::reverse_iterator<iterator>       reverse_iterator;
+  typedef Mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  enum { field_count = sizeof...(Fields) };
+
+  // 第 I 列的类型与 allocator
+  template <size_t I>
+  struct field {
+    typedef typename std::tuple_element<I, value_type>::type   type;
+    typedef typename alloc_traits::template rebind_alloc<type> allocator;
+  };
+
+private:
+  typedef std::tuple<Fields*...>                               columns;
+  typedef typename make_index_sequence<sizeof...(Fields)>::type indices;
+
+  columns   cols_;  // 各列的起始位置
+  size_type size_;  // 行数
+  size_type cap_;   // 每列的容量
+
+public:
+  allocator_type get_allocator() const {
+    return get_alloc();
+  }
+
+  basic_soa_vector() : cols_(), size_(0), cap_(0) {
+  }
+
+  explicit basic_soa_vector(const allocator_type& alloc)
+      : alloc_base(alloc), cols_(), size_(0), cap_(0) {
+  }
+
+  explicit basic_soa_vector(size_type             n,
+                            const allocator_type& alloc = allocator_type())
+      : alloc_base(alloc), cols_(), size_(0), cap_(0) {
+    resize(n);
+  }
+
+  basic_soa_vector(const basic_soa_vector& rhs)
+      : basic_soa_vector(rhs,
+                         alloc_traits::select_on_container_copy_construction(
+                             rhs.get_alloc())) {
+  }
+
+  basic_soa_vector(const basic_soa_vector& rhs, const allocator_type& alloc);
+
+  basic_soa_vector(basic_soa_vector&& rhs) noexcept
+      : alloc_base(Mystl::move(rhs.get_alloc())),
+        cols_(rhs.cols_),
+        size_(rhs.size_),
+        cap_(rhs.cap_) {
+    rhs.cols_ = columns();
+    rhs.size_ = 0;
+    rhs.cap_  = 0;
+  }
+
+  // 复制到新空间后交换, 新空间由 (传播时) rhs 或本容器的 allocator 申请
+  basic_soa_vector& operator=(const basic_soa_vector& rhs) {
+    if (this != &rhs) {
+      typedef
+          typename alloc_traits::propagate_on_container_copy_assignment pocca;
+      basic_soa_vector tmp(rhs, pocca::value ? rhs.get_alloc() : get_alloc());
+      swap_storage(tmp);
+    }
+    return *this;
+  }
+
+  basic_soa_vector& operator=(basic_soa_vector&& rhs) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value) {
+    if (this != &rhs) {
+      move_assign(
+          rhs,
+          m_bool_constant<
+              alloc_traits::propagate_on_container_move_assignment::value ||
+              alloc_traits::is_always_equal::value>());
+    }
+    return *this;
+  }
+
+  ~basic_soa_vector() {
+    destroy_rows(0, size_, indices());
+    deallocate_columns(cols_, cap_, indices());
+  }
+
+  // 迭代器相关操作
+  iterator begin() noexcept {
+    return iterator(this, 0);
+  }
+
+  const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  iterator end() noexcept {
+    return iterator(this, size_);
+  }
+
+  const_iterator end() const noexcept {
+    return const_iterator(this, size_);
+  }
+
+  reverse_iterator rbegin() noexcept {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() noexcept {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const noexcept {
+    return begin();
+  }
+
+  const_iterator cend() const noexcept {
+    return end();
+  }
+
+  // 容量相关
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  size_type size() const noexcept {
+    return size_;
+  }
+
+  size_type max_size() const noexcept {
+    return static_cast<size_type>(-1) / soa_row_bytes<Fields...>::value;
+  }
+
+  size_type capacity() const noexcept {
+    return cap_;
+  }
+
+  void reserve(size_type n);
+
+  // 访问元素相关操作
+  reference operator[](size_type n) {
+    MYSTL_DEBUG(n < size_);
+    return make_reference<reference>(cols_, n, indices());
+  }
+
+  const_reference operator[](size_type n) const {
+    MYSTL_DEBUG(n < size_);
+    return make_reference<const_reference>(cols_, n, indices());
+  }
+
+  reference at(size_type n) {
+    THROW_OUT_OF_RANGE_IF(!(n < size_),
+                          "soa_vector::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  const_reference at(size_type n) const {
+    THROW_OUT_OF_RANGE_IF(!(n < size_),
+                          "soa_vector::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference front() {
+    MYSTL_DEBUG(!empty());
+    return (*this)[0];
+  }
+
+  const_reference front() const {
+    MYSTL_DEBUG(!empty());
+    return (*this)[0];
+  }
+
+  reference back() {
+    MYSTL_DEBUG(!empty());
+    return (*this)[size_ - 1];
+  }
+
+  const_reference back() const {
+    MYSTL_DEBUG(!empty());
+    return (*this)[size_ - 1];
+  }
+
+  // 第 n 行的第 I 个字段
+  template <size_t I>
+  typename field<I>::type& get(size_type n) {
+    MYSTL_DEBUG(n < size_);
+    return std::get<I>(cols_)[n];
+  }
+
+  template <size_t I>
+  const typename field<I>::type& get(size_type n) const {
+    MYSTL_DEBUG(n < size_);
+    return std::get<I>(cols_)[n];
+  }
+
+  // 第 I 列的起始位置
+  template <size_t I>
+  typename field<I>::type* data() noexcept {
+    return std::get<I>(cols_);
+  }
+
+  template <size_t I>
+  const typename field<I>::type* data() const noexcept {
+    return std::get<I>(cols_);
+  }
+
+  // 第 I 列的全部元素
+  template <size_t I>
+  span<typename field<I>::type> column() noexcept {
+    return span<typename field<I>::type>(std::get<I>(cols_), size_);
+  }
+
+  template <size_t I>
+  span<const typename field<I>::type> column() const noexcept {
+    return span<const typename field<I>::type>(std::get<I>(cols_), size_);
+  }
+
+  // 修改容器相关操作
+  // 每个字段一个参数, 分别构造各列的新元素
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    static_assert(sizeof...(Args) == sizeof...(Fields),
+                  "soa_vector::emplace_back needs one argument per field");
+    append_row(std::forward_as_tuple(Mystl::forward<Args>(args)...));
+  }
+
+  void push_back(const value_type& value) {
+    append_row(value);
+  }
+
+  void push_back(value_type&& value) {
+    append_row(Mystl::move(value));
+  }
+
+  void pop_back() {
+    MYSTL_DEBUG(!empty());
+    destroy_rows(size_ - 1, size_, indices());
+    --size_;
+  }
+
+  iterator erase(const_iterator pos) {
+    MYSTL_DEBUG(pos >= begin() && pos < end());
+    return erase(pos, pos + 1);
+  }
+
+  iterator erase(const_iterator first, const_iterator last);
+
+  void clear() noexcept {
+    destroy_rows(0, size_, indices());
+    size_ = 0;
+  }
+
+  // 新增的行中各字段值初始化
+  void resize(size_type new_size);
+
+  void swap(basic_soa_vector& rhs) noexcept {
+    // 不传播 allocator 时, 两者必须相等
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                alloc_traits::equal(get_alloc(), rhs.get_alloc()));
+    Mystl::swap(cols_, rhs.cols_);
+    Mystl::swap(size_, rhs.size_);
+    Mystl::swap(cap_, rhs.cap_);
+    swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+  }
+
+private:
+  using alloc_base::get_alloc;
+
+  // helper function
+  // 连同 allocator 一起交换, 用于赋值时与临时对象交换
+  void swap_storage(basic_soa_vector& rhs) noexcept {
+    Mystl::swap(cols_, rhs.cols_);
+    Mystl::swap(size_, rhs.size_);
+    Mystl::swap(cap_, rhs.cap_);
+    Mystl::swap(get_alloc(), rhs.get_alloc());
+  }
+
+  void swap_alloc(basic_soa_vector& rhs, m_true_type) noexcept {
+    Mystl::swap(get_alloc(), rhs.get_alloc());
+  }
+  void swap_alloc(basic_soa_vector&, m_false_type) noexcept {
+  }
+
+  void move_assign(basic_soa_vector& rhs, m_true_type);
+  void move_assign(basic_soa_vector& rhs, m_false_type);
+
+  size_type get_new_cap(size_type add_size) const;
+
+  void reallocate(size_type new_cap);
+
+  template <class Tuple>
+  void append_row(Tuple&& row);
+
+  template <class Ref, size_t... I>
+  static Ref make_reference(const columns& cols,
+                            size_type      n,
+                            index_sequence<I...>) {
+    return Ref(std::get<I>(cols)[n]...);
+  }
+
+  // 逐列申请空间, 某一列失败时释放之前已申请的列
+  template <size_t I>
+  typename std::enable_if<(I < sizeof...(Fields))>::type allocate_columns(
+      columns&  cols,
+      size_type n) {
+    typename field<I>::allocator alloc(get_alloc());
+    std::get<I>(cols) = alloc.allocate(n);
+    try {
+      allocate_columns<I + 1>(cols, n);
+    } catch (...) {
+      alloc.deallocate(std::get<I>(cols), n);
+      throw;
+    }
+  }
+
+  template <size_t I>
+  typename std::enable_if<(I == sizeof...(Fields))>::type allocate_columns(
+      columns&,
+      size_type) {
+  }
+
+  template <size_t... I>
+  void deallocate_columns(columns&  cols,
+                          size_type n,
+                          index_sequence<I...>) noexcept {
+    int unused[] = {0,
+                    (typename field<I>::allocator(get_alloc())
+                         .deallocate(std::get<I>(cols), n),
+                     0)...};
+    (void)unused;
+  }
+
+  // 逐列把 rhs 的元素移动构造到本容器的空间, 字段可以无异常地移动构造,
+  // 不会失败
+  template <size_t... I>
+  void move_rows(basic_soa_vector& rhs, index_sequence<I...>) noexcept {
+    int unused[] = {0,
+                    (Mystl::uninitialized_move(
+                         std::get<I>(rhs.cols_),
+                         std::get<I>(rhs.cols_) + rhs.size_,
+                         std::get<I>(cols_)),
+                     0)...};
+    (void)unused;
+  }
+
+  // 字段可以无异常地移动构造, 搬移不会失败
+  template <size_t... I>
+  void relocate_columns(columns& new_cols, index_sequence<I...>) noexcept {
+    int unused[] = {0,
+                    (Mystl::uninitialized_relocate(std::get<I>(cols_),
+                                                   std::get<I>(cols_) + size_,
+                                                   std::get<I>(new_cols)),
+                     0)...};
+    (void)unused;
+  }
+
+  template <size_t... I>
+  void destroy_rows(size_type first,
+                    size_type last,
+                    index_sequence<I...>) noexcept {
+    int unused[] = {0,
+                    (Mystl::destroy(std::get<I>(cols_) + first,
+                                    std::get<I>(cols_) + last),
+                     0)...};
+    (void)unused;
+  }
+
+  // 把 [last, size_) 行前移到 first, 再销毁多出的行
+  template <size_t... I>
+  void erase_rows(size_type first, size_type last, index_sequence<I...>) {
+    int unused[] = {0,
+                    (Mystl::destroy(Mystl::move(std::get<I>(cols_) + last,
+                                                std::get<I>(cols_) + size_,
+                                                std::get<I>(cols_) + first),
+                                    std::get<I>(cols_) + size_),
+                     0)...};
+    (void)unused;
+  }
+
+  // 以 row 的第 I 个元素构造第 n 行的第 I 列, 失败时销毁已构造的字段
+  template <size_t I, class Tuple>
+  typename std::enable_if<(I < sizeof...(Fields))>::type construct_row(
+      size_type n,
+      Tuple&&   row) {
+    Mystl::construct(std::get<I>(cols_) + n,
+                     std::get<I>(Mystl::forward<Tuple>(row)));
+    try {
+      construct_row<I + 1>(n, Mystl::forward<Tuple>(row));
+    } catch (...) {
+      Mystl::destroy(std::get<I>(cols_) + n);
+      throw;
+    }
+  }
+
+  template <size_t I, class Tuple>
+  typename std::enable_if<(I == sizeof...(Fields))>::type construct_row(
+      size_type,
+      Tuple&&) {
+  }
+
+  // 在每一列的 [first, first + n) 上值初始化, 失败时销毁已构造的列
+  template <size_t I>
+  typename std::enable_if<(I < sizeof...(Fields))>::type fill_rows(
+      size_type first,
+      size_type n) {
+    typedef typename field<I>::type F;
+    F* col = std::get<I>(cols_) + first;
+    Mystl::uninitialized_fill_n(col, n, F());
+    try {
+      fill_rows<I + 1>(first, n);
+    } catch (...) {
+      Mystl::destroy(col, col + n);
+      throw;
+    }
+  }
+
+  template <size_t I>
+  typename std::enable_if<(I == sizeof...(Fields))>::type fill_rows(
+      size_type,
+      size_type) {
+  }
+
+  // 逐列复制 rhs 的元素, 失败时销毁已复制的列
+  template <size_t I>
+  typename std::enable_if<(I < sizeof...(Fields))>::type copy_rows(
+      const basic_soa_vector& rhs) {
+    const auto* src = std::get<I>(rhs.cols_);
+    auto*       dst = std::get<I>(cols_);
+    Mystl::uninitialized_copy(src, src + rhs.size_, dst);
+    try {
+      copy_rows<I + 1>(rhs);
+    } catch (...) {
+      Mystl::destroy(dst, dst + rhs.size_);
+      throw;
+    }
+  }
+
+  template <size_t I>
+  typename std::enable_if<(I == sizeof...(Fields))>::type copy_rows(
+      const basic_soa_vector&) {
+  }
+};
+
+/*****************************************************************************************/
+
+template <class Alloc, class... Fields>
+basic_soa_vector<Alloc, Fields...>::basic_soa_vector(
+    const basic_soa_vector& rhs,
+    const allocator_type&   alloc)
+    : alloc_base(alloc), cols_(), size_(0), cap_(0) {
+  if (rhs.size_ != 0) {
+    reallocate(rhs.size_);
+    try {
+      copy_rows<0>(rhs);
+    } catch (...) {
+      deallocate_columns(cols_, cap_, indices());
+      throw;
+    }
+    size_ = rhs.size_;
+  }
+}
+
+// 预留空间大小, 当原容量小于要求大小时, 才会重新分配
+template <class Alloc, class... Fields>
+void basic_soa_vector<Alloc, Fields...>::reserve(size_type n) {
+  if (cap_ < n) {
+    THROW_LENGTH_ERROR_IF(
+        n > max_size(),
+        "n can not larger than max_size() in soa_vector::reserve");
+    reallocate(n);
+  }
+}
+
+// 删除 [first, last) 上的行
+template <class Alloc, class... Fields>
+typename basic_soa_vector<Alloc, Fields...>::iterator
+basic_soa_vector<Alloc, Fields...>::erase(const_iterator first,
+                                          const_iterator last) {
+  MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+  if (first != last) {
+    erase_rows(first.index_, last.index_, indices());
+    size_ -= last.index_ - first.index_;
+  }
+  return iterator(this, first.index_);
+}
+
+template <class Alloc, class... Fields>
+void basic_soa_vector<Alloc, Fields...>::resize(size_type new_size) {
+  if (new_size < size_) {
+    destroy_rows(new_size, size_, indices());
+  } else if (new_size > size_) {
+    if (new_size > cap_) {
+      reallocate(get_new_cap(new_size - size_));
+    }
+    fill_rows<0>(size_, new_size - size_);
+  }
+  size_ = new_size;
+}
+
+template <class Alloc, class... Fields>
+typename basic_soa_vector<Alloc, Fields...>::size_type
+basic_soa_vector<Alloc, Fields...>::get_new_cap(size_type add_size) const {
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - add_size,
+                        "soa_vector's size too big");
+  const size_type required = size_ + add_size;
+  const size_type new_cap =
+      vector_default_growth::next_capacity(get_alloc(), cap_, required);
+  return new_cap < required || new_cap > max_size() ? required : new_cap;
+}
+
+/**
+ * @brief 先申请全部新列, 再逐列搬移元素并释放旧列。申请失败时容器不变
+ * @param  new_cap          My Pan doc
+ * */
+template <class Alloc, class... Fields>
+void basic_soa_vector<Alloc, Fields...>::reallocate(size_type new_cap) {
+  columns new_cols;
+  allocate_columns<0>(new_cols, new_cap);
+  relocate_columns(new_cols, indices());
+  deallocate_columns(cols_, cap_, indices());
+  cols_ = new_cols;
+  cap_  = new_cap;
+}
+
+/**
+ * @brief 在尾部追加一行。row 可能引用本容器中的元素, 需要扩容时先复制
+ *        一份再扩容
+ * @param  row              value_type 或由各字段的参数组成的 tuple
+ * */
+template <class Alloc, class... Fields>
+template <class Tuple>
+void basic_soa_vector<Alloc, Fields...>::append_row(Tuple&& row) {
+  if (size_ == cap_) {
+    value_type tmp(Mystl::forward<Tuple>(row));
+    reallocate(get_new_cap(1));
+    construct_row<0>(size_, Mystl::move(tmp));
+  } else {
+    construct_row<0>(size_, Mystl::forward<Tuple>(row));
+  }
+  ++size_;
+}
+
+/**
+ * @brief 移动赋值, allocator 可以传播或总是相等时直接接管 rhs 的各列
+ * @param  rhs              My Pan doc
+ * */
+template <class Alloc, class... Fields>
+void basic_soa_vector<Alloc, Fields...>::move_assign(basic_soa_vector& rhs,
+                                                     m_true_type) {
+  destroy_rows(0, size_, indices());
+  deallocate_columns(cols_, cap_, indices());
+  if (alloc_traits::propagate_on_container_move_assignment::value) {
+    get_alloc() = rhs.get_alloc();
+  }
+  cols_     = rhs.cols_;
+  size_     = rhs.size_;
+  cap_      = rhs.cap_;
+  rhs.cols_ = columns();
+  rhs.size_ = 0;
+  rhs.cap_  = 0;
+}
+
+/**
+ * @brief 移动赋值, allocator 不相等时 rhs 的各列不能由本容器释放,
+ *        只能逐行移动元素
+ * @param  rhs              My Pan doc
+ * */
+template <class Alloc, class... Fields>
+void basic_soa_vector<Alloc, Fields...>::move_assign(basic_soa_vector& rhs,
+                                                     m_false_type) {
+  if (alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+
+  clear();
+  reserve(rhs.size_);
+  move_rows(rhs, indices());
+  size_ = rhs.size_;
+  rhs.clear();
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+template <class Alloc, class... Fields>
+bool operator==(const basic_soa_vector<Alloc, Fields...>& lhs,
+                const basic_soa_vector<Alloc, Fields...>& rhs) {
+  return lhs.size() == rhs.size() &&
+         Mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class Alloc, class... Fields>
+bool operator!=(const basic_soa_vector<Alloc, Fields...>& lhs,
+                const basic_soa_vector<Alloc, Fields...>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <class Alloc, class... Fields>
+void swap(basic_soa_vector<Alloc, Fields...>& lhs,
+          basic_soa_vector<Alloc, Fields...>& rhs) {
+  lhs.swap(rhs);
+}
+
+// 各列使用 Mystl::allocator 的 soa_vector
+template <class... Fields>
+using soa_vector =
+    basic_soa_vector<Mystl::allocator<std::tuple<Fields...>>, Fields...>;
+
+}  // namespace Mystl
+
+#endif /* __SOA_VECTOR_H__ */
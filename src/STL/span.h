@@ -0,0 +1,75 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file span.h
+ * @brief 连续元素的非拥有视图
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-23 09:05:12
+ *
+ * span<T> 只保存起始位置与元素个数, 用于把容器内部的一段连续空间 (如
+ * soa_vector 的一列、segmented_vector 的一个分段) 交给批量处理的循环。
+ *
+ * */
+
+#ifndef __SPAN_H__
+#define __SPAN_H__
+
+#include <cstddef>
+
+#include "exceptdef.h"
+
+namespace Mystl {
+
+/**
+ * @brief 一段连续元素的视图, 不拥有元素
+ * @tparam T
+ * */
+template <class T>
+class span {
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef T&        reference;
+  typedef T*        iterator;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  span() noexcept : data_(nullptr), size_(0) {
+  }
+
+  span(T* data, size_type size) noexcept : data_(data), size_(size) {
+  }
+
+  iterator begin() const noexcept {
+    return data_;
+  }
+
+  iterator end() const noexcept {
+    return data_ + size_;
+  }
+
+  pointer data() const noexcept {
+    return data_;
+  }
+
+  size_type size() const noexcept {
+    return size_;
+  }
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  reference operator[](size_type n) const {
+    MYSTL_DEBUG(n < size_);
+    return data_[n];
+  }
+
+private:
+  T*        data_;
+  size_type size_;
+};
+
+}  // namespace Mystl
+
+#endif /* __SPAN_H__ */
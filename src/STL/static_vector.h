@@ -0,0 +1,668 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file static_vector.h
+ * @brief 容量固定、元素全部内联存储的 vector
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-21 10:05:15
+ *
+ * static_vector<T, N> 的接口与 vector 相同, 但容量在编译期确定, 元素保存在
+ * 对象内部, 从不申请堆内存, 可用于禁止堆分配的热路径。超出容量的插入抛出
+ * std::length_error; push_back_unchecked / emplace_back_unchecked 只在
+ * MYSTL_DEBUG 下检查容量。
+ *
+ * T 为平凡类型时元素存放在普通数组中, static_vector 本身也是可平凡复制、
+ * 可平凡析构的: 复制即按字节复制整个对象, 析构不做任何事。
+ *
+ * */
+
+#ifndef __STATIC_VECTOR_H__
+#define __STATIC_VECTOR_H__
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "memory.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "vector_ops.h"
+
+namespace Mystl {
+
+/**
+ * @brief static_vector 的存储。平凡类型直接使用数组, 复制、移动与析构都由
+ *        编译器生成; 其他类型使用未初始化的缓冲区, 由特化版本管理元素的
+ *        生命周期
+ * @tparam T
+ * @tparam N
+ * */
+template <class T, size_t N, bool = std::is_trivial<T>::value>
+class static_vector_base {
+protected:
+  static_vector_base() noexcept : size_(0) {
+  }
+
+  T* ptr() noexcept {
+    return elems_;
+  }
+
+  const T* ptr() const noexcept {
+    return elems_;
+  }
+
+  T      elems_[N];
+  size_t size_;
+};
+
+template <class T, size_t N>
+class static_vector_base<T, N, false> {
+protected:
+  static_vector_base() noexcept : size_(0) {
+  }
+
+  static_vector_base(const static_vector_base& rhs) : size_(0) {
+    Mystl::uninitialized_copy(rhs.ptr(), rhs.ptr() + rhs.size_, ptr());
+    size_ = rhs.size_;
+  }
+
+  // rhs 中的元素保留为被移动后的状态
+  static_vector_base(static_vector_base&& rhs) noexcept(
+      std::is_nothrow_move_constructible<T>::value)
+      : size_(0) {
+    Mystl::uninitialized_move(rhs.ptr(), rhs.ptr() + rhs.size_, ptr());
+    size_ = rhs.size_;
+  }
+
+  static_vector_base& operator=(const static_vector_base& rhs) {
+    if (this != &rhs) {
+      const T* src = rhs.ptr();
+      if (size_ >= rhs.size_) {
+        shrink_to(Mystl::copy(src, src + rhs.size_, ptr()));
+      } else {
+        Mystl::copy(src, src + size_, ptr());
+        Mystl::uninitialized_copy(src + size_, src + rhs.size_, ptr() + size_);
+        size_ = rhs.size_;
+      }
+    }
+    return *this;
+  }
+
+  static_vector_base& operator=(static_vector_base&& rhs) {
+    if (this != &rhs) {
+      T* src = rhs.ptr();
+      if (size_ >= rhs.size_) {
+        shrink_to(Mystl::move(src, src + rhs.size_, ptr()));
+      } else {
+        Mystl::move(src, src + size_, ptr());
+        Mystl::uninitialized_move(src + size_, src + rhs.size_, ptr() + size_);
+        size_ = rhs.size_;
+      }
+    }
+    return *this;
+  }
+
+  ~static_vector_base() {
+    Mystl::destroy(ptr(), ptr() + size_);
+  }
+
+  T* ptr() noexcept {
+    return reinterpret_cast<T*>(&buf_);
+  }
+
+  const T* ptr() const noexcept {
+    return reinterpret_cast<const T*>(&buf_);
+  }
+
+  typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+  size_t                                                       size_;
+
+private:
+  // 销毁 [last, end) 上的元素
+  void shrink_to(T* last) {
+    Mystl::destroy(last, ptr() + size_);
+    size_ = static_cast<size_t>(last - ptr());
+  }
+};
+
+/**
+ * @brief 容量为 N 的内联 vector
+ * @tparam T
+ * @tparam N
+ * */
+template <class T, size_t N>
+class static_vector : private static_vector_base<T, N> {
+  static_assert(N > 0, "static_vector needs a positive capacity");
+
+  typedef static_vector_base<T, N> base;
+
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  typedef value_type*                             iterator;
+  typedef const value_type*                       const_iterator;
+  typedef Mystl::reverse_iterator<iterator>       reverse_iterator;
+  typedef Mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  static_vector() noexcept {
+  }
+
+  explicit static_vector(size_type n) {
+    resize(n);
+  }
+
+  static_vector(size_type n, const value_type& value) {
+    fill_insert(end(), n, value);
+  }
+
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  static_vector(Iter first, Iter last) {
+    range_insert(end(), first, last, iterator_category(first));
+  }
+
+  static_vector(std::initializer_list<value_type> ilist) {
+    copy_insert(end(), ilist.begin(), ilist.end());
+  }
+
+  static_vector& operator=(std::initializer_list<value_type> ilist) {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  // 迭代器相关操作
+  iterator begin() noexcept {
+    return this->ptr();
+  }
+
+  const_iterator begin() const noexcept {
+    return this->ptr();
+  }
+
+  iterator end() noexcept {
+    return this->ptr() + this->size_;
+  }
+
+  const_iterator end() const noexcept {
+    return this->ptr() + this->size_;
+  }
+
+  reverse_iterator rbegin() noexcept {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() noexcept {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const noexcept {
+    return begin();
+  }
+
+  const_iterator cend() const noexcept {
+    return end();
+  }
+
+  const_reverse_iterator crbegin() const noexcept {
+    return rbegin();
+  }
+
+  const_reverse_iterator crend() const noexcept {
+    return rend();
+  }
+
+  // 容量相关
+  bool empty() const noexcept {
+    return this->size_ == 0;
+  }
+
+  bool full() const noexcept {
+    return this->size_ == N;
+  }
+
+  size_type size() const noexcept {
+    return this->size_;
+  }
+
+  static constexpr size_type capacity() noexcept {
+    return N;
+  }
+
+  static constexpr size_type max_size() noexcept {
+    return N;
+  }
+
+  // 访问元素相关操作
+  reference operator[](size_type n) {
+    MYSTL_DEBUG(n < size());
+    return this->ptr()[n];
+  }
+
+  const_reference operator[](size_type n) const {
+    MYSTL_DEBUG(n < size());
+    return this->ptr()[n];
+  }
+
+  reference at(size_type n) {
+    THROW_OUT_OF_RANGE_IF(!(n < size()),
+                          "static_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  const_reference at(size_type n) const {
+    THROW_OUT_OF_RANGE_IF(!(n < size()),
+                          "static_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference front() {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  const_reference front() const {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  reference back() {
+    MYSTL_DEBUG(!empty());
+    return *(end() - 1);
+  }
+
+  const_reference back() const {
+    MYSTL_DEBUG(!empty());
+    return *(end() - 1);
+  }
+
+  pointer data() noexcept {
+    return this->ptr();
+  }
+
+  const_pointer data() const noexcept {
+    return this->ptr();
+  }
+
+  // 修改容器相关操作
+  // assign
+  void assign(size_type n, const value_type& value);
+
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  void assign(Iter first, Iter last) {
+    clear();
+    range_insert(end(), first, last, iterator_category(first));
+  }
+
+  void assign(std::initializer_list<value_type> ilist) {
+    assign(ilist.begin(), ilist.end());
+  }
+
+  // emplace / emplace back
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N> is full");
+    emplace_back_unchecked(Mystl::forward<Args>(args)...);
+  }
+
+  // 调用者保证容器未满, 省去容量检查
+  template <class... Args>
+  void emplace_back_unchecked(Args&&... args) {
+    MYSTL_DEBUG(!full());
+    Mystl::construct(end(), Mystl::forward<Args>(args)...);
+    ++this->size_;
+  }
+
+  // push_back / pop_back
+  void push_back(const value_type& value) {
+    emplace_back(value);
+  }
+
+  void push_back(value_type&& value) {
+    emplace_back(Mystl::move(value));
+  }
+
+  void push_back_unchecked(const value_type& value) {
+    emplace_back_unchecked(value);
+  }
+
+  void push_back_unchecked(value_type&& value) {
+    emplace_back_unchecked(Mystl::move(value));
+  }
+
+  void pop_back() {
+    MYSTL_DEBUG(!empty());
+    --this->size_;
+    Mystl::destroy(end());
+  }
+
+  // insert
+  iterator insert(const_iterator pos, const value_type& value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, value_type&& value) {
+    return emplace(pos, Mystl::move(value));
+  }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value) {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    return fill_insert(const_cast<iterator>(pos), n, value);
+  }
+
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last) {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    return range_insert(const_cast<iterator>(pos), first, last,
+                        iterator_category(first));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> ilist) {
+    return insert(pos, ilist.begin(), ilist.end());
+  }
+
+  // erase / clear
+  iterator erase(const_iterator pos) {
+    MYSTL_DEBUG(pos >= begin() && pos < end());
+    return erase(pos, pos + 1);
+  }
+
+  iterator erase(const_iterator first, const_iterator last);
+
+  void clear() noexcept {
+    Mystl::destroy(begin(), end());
+    this->size_ = 0;
+  }
+
+  // resize
+  void resize(size_type new_size);
+
+  void resize(size_type new_size, const value_type& value) {
+    if (new_size < size()) {
+      erase(begin() + new_size, end());
+    } else {
+      fill_insert(end(), new_size - size(), value);
+    }
+  }
+
+  // swap
+  void swap(static_vector& rhs);
+
+private:
+  // 元素可平凡重定位时, 插入删除时的平移直接搬移字节
+  typedef is_trivially_relocatable<T> relocate_tag;
+
+  // vector_ops.h 中的搬移操作维护尾指针, 离开作用域时 (包括抛出异常)
+  // 把它写回 size_
+  struct end_guard {
+    explicit end_guard(static_vector& v) noexcept : vec(v), end(v.end()) {
+    }
+
+    ~end_guard() {
+      vec.size_ = static_cast<size_type>(end - vec.begin());
+    }
+
+    Mystl::allocator<T> alloc;
+    static_vector&      vec;
+    iterator            end;
+  };
+
+  // helper function
+  // insert
+  iterator fill_insert(iterator pos, size_type n, const value_type& value);
+
+  template <class FIter>
+  iterator copy_insert(iterator pos, FIter first, FIter last);
+
+  template <class IIter>
+  iterator range_insert(iterator pos,
+                        IIter    first,
+                        IIter    last,
+                        input_iterator_tag);
+
+  template <class FIter>
+  iterator range_insert(iterator pos,
+                        FIter    first,
+                        FIter    last,
+                        forward_iterator_tag);
+};
+
+/*****************************************************************************************/
+
+template <class T, size_t N>
+void static_vector<T, N>::assign(size_type n, const value_type& value) {
+  THROW_LENGTH_ERROR_IF(n > N,
+                        "static_vector<T, N>::assign() exceeds capacity");
+  if (n > size()) {
+    Mystl::fill(begin(), end(), value);
+    Mystl::uninitialized_fill_n(end(), n - size(), value);
+    this->size_ = n;
+  } else {
+    erase(Mystl::fill_n(begin(), n, value), end());
+  }
+}
+
+template <class T, size_t N>
+template <class... Args>
+typename static_vector<T, N>::iterator static_vector<T, N>::emplace(
+    const_iterator pos,
+    Args&&... args) {
+  MYSTL_DEBUG(pos >= begin() && pos <= end());
+  THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N> is full");
+  iterator xpos = const_cast<iterator>(pos);
+  if (xpos == end()) {
+    emplace_back_unchecked(Mystl::forward<Args>(args)...);
+  } else {
+    end_guard guard(*this);
+    Mystl::vector_emplace_in_place(guard.alloc, xpos, guard.end,
+                                   relocate_tag(),
+                                   Mystl::forward<Args>(args)...);
+  }
+  return xpos;
+}
+
+// 删除[first, last)上的元素
+template <class T, size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::erase(
+    const_iterator first,
+    const_iterator last) {
+  MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+  iterator xfirst = const_cast<iterator>(first);
+  if (first != last) {
+    end_guard guard(*this);
+    Mystl::vector_erase_shift(guard.alloc, xfirst, const_cast<iterator>(last),
+                              guard.end, relocate_tag());
+  }
+  return xfirst;
+}
+
+template <class T, size_t N>
+void static_vector<T, N>::resize(size_type new_size) {
+  THROW_LENGTH_ERROR_IF(new_size > N,
+                        "static_vector<T, N>::resize() exceeds capacity");
+  if (new_size < size()) {
+    erase(begin() + new_size, end());
+  } else {
+    for (; size() < new_size; ++this->size_) {
+      Mystl::construct(end());
+    }
+  }
+}
+
+/**
+ * @brief 与另一个 static_vector 交换, 逐个交换共有部分的元素, 再把较长者
+ *        多出的元素移动过去
+ * @param  rhs              My Pan doc
+ * */
+template <class T, size_t N>
+void static_vector<T, N>::swap(static_vector& rhs) {
+  if (this == &rhs) {
+    return;
+  }
+  static_vector* shorter = size() < rhs.size() ? this : &rhs;
+  static_vector* longer  = shorter == this ? &rhs : this;
+  const size_type n      = shorter->size();
+  for (size_type i = 0; i < n; ++i) {
+    Mystl::swap((*shorter)[i], (*longer)[i]);
+  }
+  Mystl::uninitialized_move(longer->begin() + n, longer->end(),
+                            shorter->end());
+  shorter->size_ = longer->size_;
+  longer->erase(longer->begin() + n, longer->end());
+}
+
+// helper function
+
+// 从 pos 开始插入 n 个元素, 超出容量时抛出异常且容器不变
+template <class T, size_t N>
+typename static_vector<T, N>::iterator static_vector<T, N>::fill_insert(
+    iterator          pos,
+    size_type         n,
+    const value_type& value) {
+  THROW_LENGTH_ERROR_IF(n > N - size(),
+                        "static_vector<T, N>::insert() exceeds capacity");
+  if (n != 0) {
+    const value_type value_copy = value;  // value 可能引用本容器中的元素
+    end_guard        guard(*this);
+    Mystl::vector_fill_in_place(guard.alloc, pos, guard.end, n, value_copy,
+                                relocate_tag());
+  }
+  return pos;
+}
+
+// 在 pos 处插入 [first, last) 上的元素, 超出容量时抛出异常且容器不变
+template <class T, size_t N>
+template <class FIter>
+typename static_vector<T, N>::iterator static_vector<T, N>::copy_insert(
+    iterator pos,
+    FIter    first,
+    FIter    last) {
+  const size_type n = Mystl::distance(first, last);
+  THROW_LENGTH_ERROR_IF(n > N - size(),
+                        "static_vector<T, N>::insert() exceeds capacity");
+  if (n != 0) {
+    end_guard guard(*this);
+    Mystl::vector_copy_in_place(guard.alloc, pos, guard.end, first, last, n,
+                                relocate_tag());
+  }
+  return pos;
+}
+
+/**
+ * @brief 输入迭代器只能遍历一次, 无法预先得知长度: 在尾部时逐个追加,
+ *        超出容量时删除已追加的元素; 否则先收集到临时 static_vector 中
+ *        再一次插入
+ * */
+template <class T, size_t N>
+template <class IIter>
+typename static_vector<T, N>::iterator static_vector<T, N>::range_insert(
+    iterator pos,
+    IIter    first,
+    IIter    last,
+    input_iterator_tag) {
+  if (pos == end()) {
+    const size_type old_size = size();
+    try {
+      for (; first != last; ++first) {
+        emplace_back(*first);
+      }
+    } catch (...) {
+      erase(begin() + old_size, end());
+      throw;
+    }
+  } else {
+    static_vector tmp;
+    for (; first != last; ++first) {
+      tmp.emplace_back(*first);
+    }
+    copy_insert(pos, tmp.begin(), tmp.end());
+  }
+  return pos;
+}
+
+template <class T, size_t N>
+template <class FIter>
+typename static_vector<T, N>::iterator static_vector<T, N>::range_insert(
+    iterator pos,
+    FIter    first,
+    FIter    last,
+    forward_iterator_tag) {
+  return copy_insert(pos, first, last);
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+template <class T, size_t N>
+bool operator==(const static_vector<T, N>& lhs,
+                const static_vector<T, N>& rhs) {
+  return lhs.size() == rhs.size() &&
+         Mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N>
+bool operator<(const static_vector<T, N>& lhs,
+               const static_vector<T, N>& rhs) {
+  return Mystl::lexicographical_compare(lhs.begin(),
+                                        lhs.end(),
+                                        rhs.begin(),
+                                        rhs.end());
+}
+
+template <class T, size_t N>
+bool operator!=(const static_vector<T, N>& lhs,
+                const static_vector<T, N>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N>
+bool operator>(const static_vector<T, N>& lhs,
+               const static_vector<T, N>& rhs) {
+  return rhs < lhs;
+}
+
+template <class T, size_t N>
+bool operator<=(const static_vector<T, N>& lhs,
+                const static_vector<T, N>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N>
+bool operator>=(const static_vector<T, N>& lhs,
+                const static_vector<T, N>& rhs) {
+  return !(lhs < rhs);
+}
+
+template <class T, size_t N>
+void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace Mystl
+
+#endif /* __STATIC_VECTOR_H__ */
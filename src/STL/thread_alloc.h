@@ -0,0 +1,272 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file thread_alloc.h
+ * @brief 带线程缓存的小块内存配置器
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-13 10:05:47
+ *
+ * 每个线程为每个 size class 持有一个 magazine(空闲块链表), 分配与释放
+ * 只操作本线程的 magazine, 不需要加锁。magazine 为空时从共享的 depot
+ * 取回一批(THREAD_ALLOC_BATCH 块), depot 也为空时直接向系统申请一批;
+ * magazine 超过 2 * THREAD_ALLOC_BATCH 块时把一批归还 depot。线程退出时
+ * 其 magazine 中的全部空闲块归还 depot。
+ *
+ * 线程缓存是 thread_local 对象, 主线程的线程缓存先于静态对象析构。之后
+ * 仍在分配或释放的静态容器改为在加锁的 depot 上逐块操作。
+ *
+ * 空闲块在同一 size class 内可以互换, 因此一个线程释放另一个线程申请的
+ * 块是合法的, 只会进入释放线程的 magazine。
+ *
+ * */
+
+#ifndef __THREAD_ALLOC_H__
+#define __THREAD_ALLOC_H__
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+#include "alloc.h"
+
+namespace Mystl {
+
+// magazine 与 depot 之间一次搬运的块数
+enum { THREAD_ALLOC_BATCH = 32 };
+
+/**
+ * @brief 带线程缓存的配置器, 与 default_alloc_template 的接口相同
+ * @tparam inst             用于区分不同的内存池实例
+ * */
+template <int inst>
+class thread_alloc_template {
+public:
+  static void* allocate(size_t n);
+  static void  deallocate(void* p, size_t n);
+
+private:
+  // 空闲块; 作为一批的首块时 next_batch 串起 depot 中的各批
+  struct obj {
+    obj* next;
+    obj* next_batch;
+  };
+  static_assert(sizeof(obj) <= ALLOC_ALIGN, "free block too small for obj");
+
+  struct magazine {
+    obj*   head;
+    size_t count;
+  };
+
+  // 线程缓存, 线程退出时把空闲块归还 depot
+  struct thread_cache {
+    magazine mags[ALLOC_NFREELISTS];
+
+    thread_cache() : mags() {
+    }
+
+    ~thread_cache() {
+      cache_destroyed() = true;
+      for (size_t i = 0; i < ALLOC_NFREELISTS; ++i) {
+        if (mags[i].head != nullptr) {
+          push_batch(i, mags[i].head);
+        }
+      }
+    }
+  };
+
+  static size_t freelist_index(size_t bytes) {
+    return (bytes + ALLOC_ALIGN - 1) / ALLOC_ALIGN - 1;
+  }
+
+  static thread_cache& cache() {
+    static thread_local thread_cache c;
+    return c;
+  }
+
+  // 本线程的线程缓存是否已经析构; bool 没有析构函数, 析构阶段仍可访问
+  static bool& cache_destroyed() {
+    static thread_local bool destroyed = false;
+    return destroyed;
+  }
+
+  static void* allocate_locked(size_t index);
+  static void  deallocate_locked(void* p, size_t index);
+
+  static void refill(magazine& mag, size_t index);
+  static void flush(magazine& mag, size_t index);
+  static obj* pop_batch(size_t index);
+  static void push_batch(size_t index, obj* batch);
+  static obj* new_batch(size_t index);
+
+  static obj*       depot_[ALLOC_NFREELISTS];
+  static std::mutex mutex_;
+};
+
+template <int inst>
+typename thread_alloc_template<inst>::obj*
+    thread_alloc_template<inst>::depot_[ALLOC_NFREELISTS] = {};
+
+template <int inst>
+std::mutex thread_alloc_template<inst>::mutex_;
+
+/**
+ * @brief 分配 n 字节, 小块从本线程的 magazine 取出
+ * @param  n                My Pan doc
+ * @return void*
+ * */
+template <int inst>
+void* thread_alloc_template<inst>::allocate(size_t n) {
+  if (n > static_cast<size_t>(ALLOC_MAX_BYTES)) {
+    return ::operator new(n);
+  }
+  if (0 == n) n = 1;
+
+  const size_t index = freelist_index(n);
+  if (cache_destroyed()) {
+    return allocate_locked(index);
+  }
+  magazine& mag = cache().mags[index];
+  if (nullptr == mag.head) {
+    refill(mag, index);
+  }
+  obj* result = mag.head;
+  mag.head    = result->next;
+  --mag.count;
+  return result;
+}
+
+/**
+ * @brief 归还 n 字节, 小块挂回本线程的 magazine
+ * @param  p                My Pan doc
+ * @param  n                My Pan doc
+ * */
+template <int inst>
+void thread_alloc_template<inst>::deallocate(void* p, size_t n) {
+  if (n > static_cast<size_t>(ALLOC_MAX_BYTES)) {
+    ::operator delete(p);
+    return;
+  }
+  if (0 == n) n = 1;
+
+  const size_t index = freelist_index(n);
+  if (cache_destroyed()) {
+    deallocate_locked(p, index);
+    return;
+  }
+  magazine& mag = cache().mags[index];
+  obj*      q   = static_cast<obj*>(p);
+  q->next       = mag.head;
+  mag.head      = q;
+  if (++mag.count >= 2 * THREAD_ALLOC_BATCH) {
+    flush(mag, index);
+  }
+}
+
+/**
+ * @brief 线程缓存析构后的分配: 从 depot 取一批, 留下首块, 其余放回
+ * @param  index            My Pan doc
+ * @return void*
+ * */
+template <int inst>
+void* thread_alloc_template<inst>::allocate_locked(size_t index) {
+  obj* batch = pop_batch(index);
+  if (nullptr == batch) {
+    batch = new_batch(index);
+  }
+  if (batch->next != nullptr) {
+    push_batch(index, batch->next);
+  }
+  return batch;
+}
+
+// 线程缓存析构后的释放: 单个块作为一批放回 depot
+template <int inst>
+void thread_alloc_template<inst>::deallocate_locked(void* p, size_t index) {
+  obj* q  = static_cast<obj*>(p);
+  q->next = nullptr;
+  push_batch(index, q);
+}
+
+/**
+ * @brief magazine 为空时取回一批空闲块
+ * @param  mag              My Pan doc
+ * @param  index            My Pan doc
+ * */
+template <int inst>
+void thread_alloc_template<inst>::refill(magazine& mag, size_t index) {
+  obj* batch = pop_batch(index);
+  if (nullptr == batch) {
+    batch = new_batch(index);
+  }
+
+  size_t count = 0;
+  for (obj* cur = batch; cur != nullptr; cur = cur->next) {
+    ++count;
+  }
+  mag.head  = batch;
+  mag.count = count;
+}
+
+/**
+ * @brief 把 magazine 头部的一批空闲块归还 depot
+ * @param  mag              My Pan doc
+ * @param  index            My Pan doc
+ * */
+template <int inst>
+void thread_alloc_template<inst>::flush(magazine& mag, size_t index) {
+  obj* batch = mag.head;
+  obj* last  = batch;
+  for (int i = 1; i < THREAD_ALLOC_BATCH; ++i) {
+    last = last->next;
+  }
+  mag.head   = last->next;
+  last->next = nullptr;
+  mag.count -= THREAD_ALLOC_BATCH;
+  push_batch(index, batch);
+}
+
+template <int inst>
+typename thread_alloc_template<inst>::obj* thread_alloc_template<
+    inst>::pop_batch(size_t index) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  obj*                        batch = depot_[index];
+  if (batch != nullptr) {
+    depot_[index] = batch->next_batch;
+  }
+  return batch;
+}
+
+template <int inst>
+void thread_alloc_template<inst>::push_batch(size_t index, obj* batch) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  batch->next_batch = depot_[index];
+  depot_[index]     = batch;
+}
+
+/**
+ * @brief 向系统申请一批连续的块并串成链表, 这些块不会归还给系统
+ * @param  index            My Pan doc
+ * @return obj*
+ * */
+template <int inst>
+typename thread_alloc_template<inst>::obj* thread_alloc_template<
+    inst>::new_batch(size_t index) {
+  const size_t size  = (index + 1) * ALLOC_ALIGN;
+  char*        chunk = static_cast<char*>(
+      ::operator new(size * static_cast<size_t>(THREAD_ALLOC_BATCH)));
+  obj* head = reinterpret_cast<obj*>(chunk);
+  obj* cur  = head;
+  for (int i = 1; i < THREAD_ALLOC_BATCH; ++i) {
+    obj* next = reinterpret_cast<obj*>(reinterpret_cast<char*>(cur) + size);
+    cur->next = next;
+    cur       = next;
+  }
+  cur->next = nullptr;
+  return head;
+}
+
+typedef thread_alloc_template<0> thread_alloc;
+
+}  // namespace Mystl
+
+#endif /* __THREAD_ALLOC_H__ */
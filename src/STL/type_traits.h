@@ -36,6 +36,21 @@ struct is_pair : Mystl::m_false_type {};
 template <class T1, class T2>
 struct is_pair<Mystl::pair<T1, T2>> : Mystl::m_true_type {};
 
+/**
+ * @brief T 能否通过按字节复制搬到新地址并直接放弃原对象, 而不调用移动构造
+ *        与析构函数。可平凡复制的类型总是可以; 其他类型(例如只持有堆内存
+ *        指针的容器)可以特化本模板声明自己可平凡重定位
+ * @tparam T
+ * */
+template <class T>
+struct is_trivially_relocatable
+    : m_bool_constant<std::is_trivially_copyable<T>::value> {};
+
+template <class T1, class T2>
+struct is_trivially_relocatable<Mystl::pair<T1, T2>>
+    : m_bool_constant<is_trivially_relocatable<T1>::value &&
+                      is_trivially_relocatable<T2>::value> {};
+
 }  // namespace MyMystl
 
 #endif /* __TYPE_TRAITS_H__ */
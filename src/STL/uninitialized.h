@@ -12,6 +12,10 @@
 #ifndef __UNINITIALIZED_H__
 #define __UNINITIALIZED_H__
 
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <thread>
 #include <type_traits>
 
 #include "algobase.h"
@@ -54,6 +58,7 @@ ForwardIter unchecked_uninit_copy(InputIter   first,
     for (; result != cur; ++result) {
       Mystl::destroy(&*result);
     }
+    throw;
   }
   return cur;
 }
@@ -91,21 +96,23 @@ ForwardIter uninitialized_copy(InputIter   first,
  * @param  first            My Pan doc
  * @param  n                My Pan doc
  * @param  result           My Pan doc
- * @return ForwardIter
+ * @return Mystl::pair<InputIter, ForwardIter> 源区间与目标区间的结束位置
  * */
 template <class InputIter, class Size, class ForwardIter>
-ForwardIter unchecked_uninit_copy_n(InputIter   first,
-                                    Size        n,
-                                    ForwardIter result,
-                                    std::true_type) {
-  return Mystl::copy_n(first, n, result).second;
+Mystl::pair<InputIter, ForwardIter> unchecked_uninit_copy_n(
+    InputIter   first,
+    Size        n,
+    ForwardIter result,
+    std::true_type) {
+  return Mystl::copy_n(first, n, result);
 }
 
 template <class InputIter, class Size, class ForwardIter>
-ForwardIter unchecked_uninit_copy_n(InputIter   first,
-                                    Size        n,
-                                    ForwardIter result,
-                                    std::false_type) {
+Mystl::pair<InputIter, ForwardIter> unchecked_uninit_copy_n(
+    InputIter   first,
+    Size        n,
+    ForwardIter result,
+    std::false_type) {
   auto cur = result;
   try {
     for (; n > 0; --n, ++cur, ++first) {
@@ -115,13 +122,33 @@ ForwardIter unchecked_uninit_copy_n(InputIter   first,
     for (; result != cur; ++result) {
       Mystl::destroy(&*result);
     }
+    throw;
   }
 
-  return cur;
+  return Mystl::pair<InputIter, ForwardIter>(first, cur);
 }
 
 template <class InputIter, class Size, class ForwardIter>
 ForwardIter uninitialized_copy_n(InputIter first, Size n, ForwardIter result) {
+  return Mystl::unchecked_uninit_copy_n(
+             first,
+             n,
+             result,
+             std::is_trivially_copy_assignable<
+                 typename iterator_traits<InputIter>::value_type>{})
+      .second;
+}
+
+/**
+ * @brief 与 uninitialized_copy_n 相同, 同时返回源区间中复制结束的位置,
+ *        调用者可以从那里继续复制, 不必再遍历一次
+ * @return Mystl::pair<InputIter, ForwardIter>
+ * */
+template <class InputIter, class Size, class ForwardIter>
+Mystl::pair<InputIter, ForwardIter> uninitialized_copy_n_pair(
+    InputIter   first,
+    Size        n,
+    ForwardIter result) {
   return Mystl::unchecked_uninit_copy_n(
       first,
       n,
@@ -160,6 +187,7 @@ void unchecked_uninit_fill(ForwardIter first,
     for (; first != cur; ++first) {
       Mystl::destroy(&*first);
     }
+    throw;
   }
 }
 
@@ -200,6 +228,7 @@ ForwardIter unchecked_uninit_fill_n(ForwardIter first,
   } catch (...) {
     for (; first != cur; ++first)
       Mystl::destroy(&*first);
+    throw;
   }
   return cur;
 }
@@ -214,6 +243,120 @@ ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value) {
           typename iterator_traits<ForwardIter>::value_type>{});
 }
 
+/*****************************************************************************************/
+// uninitialized_default_n
+// 从 first 位置开始默认初始化 n 个元素, 返回结束的位置。平凡类型不写入
+// 任何内容, 适合之后整块被覆盖的缓冲区
+/*****************************************************************************************/
+template <class ForwardIter, class Size>
+ForwardIter unchecked_uninit_default_n(ForwardIter first,
+                                       Size        n,
+                                       std::true_type) {
+  Mystl::advance(first, n);
+  return first;
+}
+
+template <class ForwardIter, class Size>
+ForwardIter unchecked_uninit_default_n(ForwardIter first,
+                                       Size        n,
+                                       std::false_type) {
+  auto cur = first;
+  try {
+    for (; n > 0; --n, ++cur) {
+      Mystl::default_construct(&*cur);
+    }
+  } catch (...) {
+    for (; first != cur; ++first)
+      Mystl::destroy(&*first);
+    throw;
+  }
+  return cur;
+}
+
+template <class ForwardIter, class Size>
+ForwardIter uninitialized_default_n(ForwardIter first, Size n) {
+  return Mystl::unchecked_uninit_default_n(
+      first,
+      n,
+      std::is_trivially_default_constructible<
+          typename iterator_traits<ForwardIter>::value_type>{});
+}
+
+// 每个线程至少负责的字节数, 更小的任务不值得启动线程
+enum { PARALLEL_INIT_MIN_BYTES = 1024 * 1024 };
+
+/**
+ * @brief 以多个线程并行地在 [first, first + n) 上构造 value 的副本。每个
+ *        线程第一次写入自己负责的一段, 在 first-touch 策略下这段内存的物理
+ *        页分配在该线程所在的 NUMA 节点上
+ * @tparam T
+ * @tparam Size
+ * @param  first            My Pan doc
+ * @param  n                My Pan doc
+ * @param  value            My Pan doc
+ * @param  nthreads         线程数, 0 表示按硬件线程数与 n 的大小决定
+ * @return T*               填充结束的位置; 任一段抛出异常时已构造的元素
+ *                          全部销毁, 异常继续抛出
+ * */
+template <class T, class Size>
+T* parallel_uninitialized_fill_n(T*       first,
+                                 Size     n,
+                                 const T& value,
+                                 size_t   nthreads = 0) {
+  const size_t count = static_cast<size_t>(n);
+  if (0 == nthreads) {
+    nthreads             = std::thread::hardware_concurrency();
+    const size_t by_size = count * sizeof(T) / PARALLEL_INIT_MIN_BYTES;
+    if (nthreads > by_size) nthreads = by_size;
+  }
+  if (nthreads > count) nthreads = count;
+  if (nthreads <= 1) {
+    return Mystl::uninitialized_fill_n(first, count, value);
+  }
+
+  std::unique_ptr<std::exception_ptr[]> errors(
+      new std::exception_ptr[nthreads]);
+  auto fill = [&](size_t i) {
+    const size_t begin = count * i / nthreads;
+    const size_t end   = count * (i + 1) / nthreads;
+    try {
+      Mystl::uninitialized_fill_n(first + begin, end - begin, value);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+
+  // 线程创建失败时剩余的段由当前线程完成
+  std::unique_ptr<std::thread[]> workers(new std::thread[nthreads - 1]);
+  size_t                         started = 1;
+  try {
+    for (; started < nthreads; ++started) {
+      workers[started - 1] = std::thread(fill, started);
+    }
+  } catch (...) {
+  }
+  for (size_t i = started; i < nthreads; ++i) {
+    fill(i);
+  }
+  fill(0);
+  for (size_t i = 1; i < started; ++i) {
+    workers[i - 1].join();
+  }
+
+  for (size_t i = 0; i < nthreads; ++i) {
+    if (!errors[i]) continue;
+    // 失败的段已自行回滚, 销毁其余成功的段
+    for (size_t j = 0; j < nthreads; ++j) {
+      if (!errors[j]) {
+        Mystl::destroy(first + count * j / nthreads,
+                       first + count * (j + 1) / nthreads);
+      }
+    }
+    std::rethrow_exception(errors[i]);
+  }
+  return first + count;
+}
+
 /**
  * @brief 把[first, last)上的内容移动到以 result
  * 为起始处的空间，返回移动结束的位置
@@ -244,6 +387,7 @@ ForwardIter unchecked_uninit_move(InputIter   first,
     }
   } catch (...) {
     Mystl::destroy(result, cur);
+    throw;
   }
   return cur;
 }
@@ -309,6 +453,40 @@ ForwardIter unchecked_uninit_move_n(InputIter   first,
       std::is_trivially_move_assignable<
           typename iterator_traits<InputIter>::value_type>{});
 }
+
+/**
+ * @brief 把 [first, last) 上的元素重定位到以 result 为起始处的未初始化
+ *        空间: 在 result 处得到相同的元素, 原位置的元素结束生命周期,
+ *        返回重定位结束的位置
+ * @tparam T
+ * @param  first            My Pan doc
+ * @param  last             My Pan doc
+ * @param  result           可平凡重定位时允许与 [first, last) 重叠
+ * @return T*
+ * */
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, m_true_type) {
+  const size_t n = static_cast<size_t>(last - first);
+  if (n != 0) {
+    std::memmove(static_cast<void*>(result), static_cast<const void*>(first),
+                 n * sizeof(T));
+  }
+  return result + n;
+}
+
+// 逐个移动构造再销毁原元素, 区间不能重叠; 移动失败时原元素保持不变
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, m_false_type) {
+  T* cur = Mystl::uninitialized_move(first, last, result);
+  Mystl::destroy(first, last);
+  return cur;
+}
+
+template <class T>
+T* uninitialized_relocate(T* first, T* last, T* result) {
+  return Mystl::unchecked_uninit_relocate(first, last, result,
+                                          is_trivially_relocatable<T>());
+}
 }  // namespace Mystl
 
 #endif /* __UNINITIALIZED_H__ */
\ No newline at end of file
@@ -0,0 +1,875 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file unrolled_list.h
+ * @brief 每个节点保存多个元素的双向链表
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-24 15:05:32
+ *
+ * unrolled_list<T, K> 的每个节点内有一个容纳 K 个元素的数组, 元素连续地
+ * 存放在其中的 [first, last) 位置:
+ *
+ *   - 遍历时每 K 个元素才跳转一次节点, 接近 vector 的扫描速度;
+ *   - 两端插入删除只移动 first 或 last, 为 O(1);
+ *   - 在迭代器处插入删除只移动本节点内较短的一侧, 为 O(K); 节点满时
+ *     对半分裂, 删除后与后继节点合计不超过 K / 2 个元素时合并;
+ *   - splice 整个链表时只在 pos 处分裂一个节点, 其余按节点链接。
+ *
+ * 插入与删除会使被移动元素的迭代器和引用失效, 这一点与 list 不同。
+ *
+ * */
+
+#ifndef __UNROLLED_LIST_H__
+#define __UNROLLED_LIST_H__
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+
+namespace Mystl {
+
+// 默认每个节点中元素数组的字节数
+enum { UNROLLED_NODE_BYTES = 256 };
+
+// 默认每个节点的元素个数, 至少为 4
+template <class T>
+struct unrolled_default_size
+    : m_integral_constant<size_t,
+                          (UNROLLED_NODE_BYTES / sizeof(T) > 4
+                               ? UNROLLED_NODE_BYTES / sizeof(T)
+                               : 4)> {};
+
+/**
+ * @brief 节点的链接部分, 链表的哨兵节点只有这一部分, 且 first == last == 0
+ * */
+struct unrolled_node_base {
+  unrolled_node_base* prev;   // 前一个节点
+  unrolled_node_base* next;   // 下一个节点
+  size_t              first;  // 第一个元素的位置
+  size_t              last;   // 最后一个元素的下一个位置
+
+  size_t count() const noexcept {
+    return last - first;
+  }
+};
+
+template <class T, size_t K>
+struct unrolled_node : public unrolled_node_base {
+  typename std::aligned_storage<sizeof(T) * K, alignof(T)>::type buf_;
+
+  T* slot(size_t i) noexcept {
+    return reinterpret_cast<T*>(&buf_) + i;
+  }
+};
+
+/**
+ * @brief unrolled_list 的迭代器, 保存节点与元素在节点中的位置
+ * @tparam T
+ * @tparam K
+ * @tparam Ref
+ * @tparam Ptr
+ * */
+template <class T, size_t K, class Ref, class Ptr>
+struct unrolled_iterator
+    : public Mystl::iterator<Mystl::bidirectional_iterator_tag,
+                             T,
+                             ptrdiff_t,
+                             Ptr,
+                             Ref> {
+  typedef Ref                               reference;
+  typedef Ptr                               pointer;
+  typedef unrolled_node_base*               base_ptr;
+  typedef unrolled_node<T, K>*              node_ptr;
+  typedef unrolled_iterator<T, K, Ref, Ptr> self;
+
+  base_ptr node_;   // 所在节点
+  size_t   index_;  // 在节点中的位置
+
+  unrolled_iterator() noexcept : node_(nullptr), index_(0) {
+  }
+
+  unrolled_iterator(base_ptr node, size_t index) noexcept
+      : node_(node), index_(index) {
+  }
+
+  // iterator 可以转换为 const_iterator
+  template <class R, class P>
+  unrolled_iterator(const unrolled_iterator<T, K, R, P>& rhs) noexcept
+      : node_(rhs.node_), index_(rhs.index_) {
+  }
+
+  // 重载操作符
+  reference operator*() const {
+    return *static_cast<node_ptr>(node_)->slot(index_);
+  }
+
+  pointer operator->() const {
+    return &(operator*());
+  }
+
+  // 走出一个节点时跳到下一个节点的第一个元素, 哨兵节点处即为 end()
+  self& operator++() {
+    if (++index_ == node_->last) {
+      node_  = node_->next;
+      index_ = node_->first;
+    }
+    return *this;
+  }
+
+  self operator++(int) {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  self& operator--() {
+    if (index_ == node_->first) {
+      node_  = node_->prev;
+      index_ = node_->last;
+    }
+    --index_;
+    return *this;
+  }
+
+  self operator--(int) {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const {
+    return node_ == rhs.node_ && index_ == rhs.index_;
+  }
+
+  bool operator!=(const self& rhs) const {
+    return !(*this == rhs);
+  }
+};
+
+/**
+ * @brief 每个节点保存 K 个元素的双向链表
+ * @tparam T
+ * @tparam K                每个节点的元素个数, 至少为 2
+ * @tparam Alloc
+ * */
+template <class T,
+          size_t K    = unrolled_default_size<T>::value,
+          class Alloc = Mystl::allocator<T>>
+class unrolled_list : private Mystl::alloc_holder<Alloc> {
+  static_assert(K >= 2, "unrolled_list needs at least 2 elements per node");
+
+public:
+  typedef Alloc                          allocator_type;
+  typedef Mystl::allocator_traits<Alloc> alloc_traits;
+  typedef Mystl::alloc_holder<Alloc>     alloc_base;
+  typedef typename alloc_traits::template rebind_alloc<unrolled_node<T, K>>
+      node_allocator;
+
+  typedef typename allocator_type::value_type      value_type;
+  typedef typename allocator_type::pointer         pointer;
+  typedef typename allocator_type::const_pointer   const_pointer;
+  typedef typename allocator_type::reference       reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::size_type       size_type;
+  typedef typename allocator_type::difference_type difference_type;
+
+  typedef unrolled_iterator<T, K, T&, T*>             iterator;
+  typedef unrolled_iterator<T, K, const T&, const T*> const_iterator;
+  typedef Mystl::reverse_iterator<iterator>           reverse_iterator;
+  typedef Mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+  typedef unrolled_node_base*  base_ptr;
+  typedef unrolled_node<T, K>* node_ptr;
+
+  // 每个节点的元素个数
+  enum { node_size = K };
+
+  allocator_type get_allocator() const {
+    return get_alloc();
+  }
+
+  unrolled_list() noexcept : size_(0) {
+    reset_head();
+  }
+
+  explicit unrolled_list(const allocator_type& alloc) noexcept
+      : alloc_base(alloc), size_(0) {
+    reset_head();
+  }
+
+  unrolled_list(size_type             n,
+                const value_type&     value,
+                const allocator_type& alloc = allocator_type())
+      : alloc_base(alloc), size_(0) {
+    reset_head();
+    guarded_init([this, n, &value]() {
+      for (size_type i = 0; i < n; ++i) {
+        emplace_back(value);
+      }
+    });
+  }
+
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  unrolled_list(Iter                  first,
+                Iter                  last,
+                const allocator_type& alloc = allocator_type())
+      : alloc_base(alloc), size_(0) {
+    reset_head();
+    guarded_init([this, first, last]() { append(first, last); });
+  }
+
+  unrolled_list(std::initializer_list<value_type> ilist,
+                const allocator_type&             alloc = allocator_type())
+      : alloc_base(alloc), size_(0) {
+    reset_head();
+    guarded_init([this, &ilist]() { append(ilist.begin(), ilist.end()); });
+  }
+
+  unrolled_list(const unrolled_list& rhs)
+      : alloc_base(alloc_traits::select_on_container_copy_construction(
+            rhs.get_alloc())),
+        size_(0) {
+    reset_head();
+    guarded_init([this, &rhs]() { append(rhs.begin(), rhs.end()); });
+  }
+
+  unrolled_list(unrolled_list&& rhs) noexcept
+      : alloc_base(Mystl::move(rhs.get_alloc())), size_(0) {
+    reset_head();
+    take_nodes(rhs);
+  }
+
+  // 旧节点先由旧的 allocator 释放, 再按需换用 rhs 的 allocator
+  unrolled_list& operator=(const unrolled_list& rhs) {
+    if (this != &rhs) {
+      clear();
+      copy_alloc(
+          rhs,
+          typename alloc_traits::propagate_on_container_copy_assignment());
+      append(rhs.begin(), rhs.end());
+    }
+    return *this;
+  }
+
+  unrolled_list& operator=(unrolled_list&& rhs) {
+    if (this != &rhs) {
+      move_assign(
+          rhs,
+          m_bool_constant<
+              alloc_traits::propagate_on_container_move_assignment::value ||
+              alloc_traits::is_always_equal::value>());
+    }
+    return *this;
+  }
+
+  ~unrolled_list() {
+    clear();
+  }
+
+  // 迭代器相关操作
+  iterator begin() noexcept {
+    return iterator(head_.next, head_.next->first);
+  }
+
+  const_iterator begin() const noexcept {
+    return const_iterator(head_.next, head_.next->first);
+  }
+
+  iterator end() noexcept {
+    return iterator(&head_, 0);
+  }
+
+  const_iterator end() const noexcept {
+    return const_iterator(const_cast<base_ptr>(&head_), 0);
+  }
+
+  reverse_iterator rbegin() noexcept {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() noexcept {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const noexcept {
+    return begin();
+  }
+
+  const_iterator cend() const noexcept {
+    return end();
+  }
+
+  // 容量相关
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  size_type size() const noexcept {
+    return size_;
+  }
+
+  size_type max_size() const noexcept {
+    return static_cast<size_type>(-1) / sizeof(unrolled_node<T, K>) * K;
+  }
+
+  // 访问元素相关操作
+  reference front() {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  const_reference front() const {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  reference back() {
+    MYSTL_DEBUG(!empty());
+    return *--end();
+  }
+
+  const_reference back() const {
+    MYSTL_DEBUG(!empty());
+    return *--end();
+  }
+
+  // 修改容器相关操作
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  iterator insert(const_iterator pos, const value_type& value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, value_type&& value) {
+    return emplace(pos, Mystl::move(value));
+  }
+
+  template <class... Args>
+  void emplace_front(Args&&... args) {
+    emplace(begin(), Mystl::forward<Args>(args)...);
+  }
+
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    emplace(end(), Mystl::forward<Args>(args)...);
+  }
+
+  void push_front(const value_type& value) {
+    emplace(begin(), value);
+  }
+
+  void push_front(value_type&& value) {
+    emplace(begin(), Mystl::move(value));
+  }
+
+  void push_back(const value_type& value) {
+    emplace(end(), value);
+  }
+
+  void push_back(value_type&& value) {
+    emplace(end(), Mystl::move(value));
+  }
+
+  void pop_front() {
+    MYSTL_DEBUG(!empty());
+    erase(begin());
+  }
+
+  void pop_back() {
+    MYSTL_DEBUG(!empty());
+    erase(--end());
+  }
+
+  iterator erase(const_iterator pos) {
+    MYSTL_DEBUG(pos != cend());
+    const_iterator next = pos;
+    return erase(pos, ++next);
+  }
+
+  iterator erase(const_iterator first, const_iterator last);
+
+  void clear() noexcept;
+
+  // 把 other 的全部元素移到 pos 之前, 最多分裂一个节点
+  void splice(const_iterator pos, unrolled_list& other);
+
+  void swap(unrolled_list& rhs) noexcept;
+
+  // 节点个数
+  size_type node_count() const noexcept;
+
+private:
+  using alloc_base::get_alloc;
+
+  node_allocator node_alloc() const {
+    return node_allocator(get_alloc());
+  }
+
+  static node_ptr as_node(base_ptr p) noexcept {
+    return static_cast<node_ptr>(p);
+  }
+
+  // helper function
+  void reset_head() noexcept {
+    head_.prev = head_.next = &head_;
+    head_.first = head_.last = 0;
+  }
+
+  // 与 rhs 交换哨兵的链接之后, 让首尾节点指回本容器的哨兵
+  void relink_head(const unrolled_list& rhs) noexcept {
+    if (head_.next == &rhs.head_) {
+      reset_head();
+    } else {
+      head_.next->prev = &head_;
+      head_.prev->next = &head_;
+    }
+  }
+
+  template <class F>
+  void guarded_init(F init) {
+    try {
+      init();
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  template <class Iter>
+  void append(Iter first, Iter last) {
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  }
+
+  // 申请一个空节点并链接在 pos 之前, 元素将从 at 开始存放
+  node_ptr create_node(base_ptr pos, size_t at);
+
+  // 断开并释放一个已经没有元素的节点
+  void free_node(base_ptr p) noexcept;
+
+  // 在未满的节点 n 的位置 i 处构造元素, 移动较短的一侧
+  template <class... Args>
+  iterator emplace_in(node_ptr n, size_t i, Args&&... args);
+
+  // 把节点 n 中 [at, last) 的元素移到链接在 n 之后的新节点中
+  node_ptr split(node_ptr n, size_t at);
+
+  // 删除节点 n 中 [a, b) 位置的元素, 返回原来位于 b 的元素的位置
+  iterator erase_in(node_ptr n, size_t a, size_t b);
+
+  // n 与其后继节点合计不超过 K / 2 个元素时合并, 并修正位置 pos
+  iterator merge_next(node_ptr n, iterator pos);
+
+  // 接管 rhs 的全部节点, 本容器必须为空
+  void take_nodes(unrolled_list& rhs) noexcept;
+
+  void move_assign(unrolled_list& rhs, m_true_type);
+  void move_assign(unrolled_list& rhs, m_false_type);
+
+  void copy_alloc(const unrolled_list& rhs, m_true_type) {
+    get_alloc() = rhs.get_alloc();
+  }
+
+  void copy_alloc(const unrolled_list&, m_false_type) {
+  }
+
+  void swap_alloc(unrolled_list& rhs, m_true_type) {
+    Mystl::swap(get_alloc(), rhs.get_alloc());
+  }
+
+  void swap_alloc(unrolled_list&, m_false_type) {
+  }
+
+  unrolled_node_base head_;  // 哨兵节点
+  size_type          size_;  // 元素个数
+};
+
+/*****************************************************************************************/
+
+/**
+ * @brief 在 pos 之前构造元素。pos 位于节点开头且前一个节点未满时追加到
+ *        前一个节点; pos 所在节点已满时先分裂; 在首尾新建节点时, 元素放在
+ *        便于继续向同一方向增长的一端
+ * @param  pos              My Pan doc
+ * @param  args             My Pan doc
+ * @return iterator         指向新元素
+ * */
+template <class T, size_t K, class Alloc>
+template <class... Args>
+typename unrolled_list<T, K, Alloc>::iterator
+unrolled_list<T, K, Alloc>::emplace(const_iterator pos, Args&&... args) {
+  THROW_LENGTH_ERROR_IF(size_ == max_size(), "unrolled_list<T>'s size too big");
+  base_ptr p = pos.node_;
+  size_t   i = pos.index_;
+  if (i == p->first && p->prev != &head_ && p->prev->count() < K) {
+    node_ptr prev = as_node(p->prev);
+    return emplace_in(prev, prev->last, Mystl::forward<Args>(args)...);
+  }
+  if (p == &head_ || (p->count() == K && i == p->first)) {
+    // 在尾部新建时从 0 开始, 其他位置从 K - 1 开始
+    const size_t at = p == &head_ ? 0 : K - 1;
+    node_ptr     n  = create_node(p, at);
+    try {
+      get_alloc().construct(n->slot(at), Mystl::forward<Args>(args)...);
+    } catch (...) {
+      free_node(n);
+      throw;
+    }
+    ++n->last;
+    ++size_;
+    return iterator(n, at);
+  }
+  node_ptr n = as_node(p);
+  if (n->count() == K) {
+    node_ptr m = split(n, K / 2);
+    if (i > n->last) {
+      i -= n->last - m->first;
+      n = m;
+    }
+  }
+  return emplace_in(n, i, Mystl::forward<Args>(args)...);
+}
+
+/**
+ * @brief 按节点逐段删除 [first, last), 整段覆盖的节点直接释放
+ * @param  first            My Pan doc
+ * @param  last             My Pan doc
+ * @return iterator         指向原来 last 处的元素
+ * */
+template <class T, size_t K, class Alloc>
+typename unrolled_list<T, K, Alloc>::iterator
+unrolled_list<T, K, Alloc>::erase(const_iterator first, const_iterator last) {
+  if (first == last) {
+    return iterator(last.node_, last.index_);
+  }
+  base_ptr p = first.node_;
+  size_t   i = first.index_;
+  while (p != last.node_) {
+    base_ptr next = p->next;
+    erase_in(as_node(p), i, p->last);
+    p = next;
+    i = next->first;
+  }
+  if (p == &head_ || i == last.index_) {
+    return iterator(p, i);
+  }
+  node_ptr n = as_node(p);
+  if (last.index_ - i == n->count()) {
+    return erase_in(n, i, last.index_);
+  }
+  return merge_next(n, erase_in(n, i, last.index_));
+}
+
+template <class T, size_t K, class Alloc>
+void unrolled_list<T, K, Alloc>::clear() noexcept {
+  base_ptr p = head_.next;
+  while (p != &head_) {
+    node_ptr n = as_node(p);
+    p          = p->next;
+    get_alloc().destroy(n->slot(n->first), n->slot(n->last));
+    node_alloc().deallocate(n, 1);
+  }
+  reset_head();
+  size_ = 0;
+}
+
+/**
+ * @brief pos 在节点中间时先把该节点从 pos 处拆成两个, 再把 other 的节点
+ *        整段链接到 pos 之前
+ * @param  pos              My Pan doc
+ * @param  other            My Pan doc
+ * */
+template <class T, size_t K, class Alloc>
+void unrolled_list<T, K, Alloc>::splice(const_iterator pos,
+                                        unrolled_list& other) {
+  MYSTL_DEBUG(alloc_traits::equal(get_alloc(), other.get_alloc()));
+  if (this == &other || other.empty()) {
+    return;
+  }
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - other.size_,
+                        "unrolled_list<T>'s size too big");
+  base_ptr p = pos.node_;
+  if (p != &head_ && pos.index_ != p->first) {
+    p = split(as_node(p), pos.index_);
+  }
+  base_ptr first = other.head_.next;
+  base_ptr last  = other.head_.prev;
+  first->prev    = p->prev;
+  p->prev->next  = first;
+  last->next     = p;
+  p->prev        = last;
+  size_ += other.size_;
+  other.reset_head();
+  other.size_ = 0;
+}
+
+/**
+ * @brief 与另一个 unrolled_list 交换
+ * @param  rhs              My Pan doc
+ * */
+template <class T, size_t K, class Alloc>
+void unrolled_list<T, K, Alloc>::swap(unrolled_list& rhs) noexcept {
+  if (this != &rhs) {
+    // 不传播 allocator 时, 两者必须相等
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                alloc_traits::equal(get_alloc(), rhs.get_alloc()));
+    Mystl::swap(head_.next, rhs.head_.next);
+    Mystl::swap(head_.prev, rhs.head_.prev);
+    Mystl::swap(size_, rhs.size_);
+    relink_head(rhs);
+    rhs.relink_head(*this);
+    swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+  }
+}
+
+template <class T, size_t K, class Alloc>
+typename unrolled_list<T, K, Alloc>::size_type
+unrolled_list<T, K, Alloc>::node_count() const noexcept {
+  size_type n = 0;
+  for (base_ptr p = head_.next; p != &head_; p = p->next) {
+    ++n;
+  }
+  return n;
+}
+
+// helper function
+
+template <class T, size_t K, class Alloc>
+typename unrolled_list<T, K, Alloc>::node_ptr
+unrolled_list<T, K, Alloc>::create_node(base_ptr pos, size_t at) {
+  node_ptr n      = node_alloc().allocate(1);
+  n->first        = at;
+  n->last         = at;
+  n->prev         = pos->prev;
+  n->next         = pos;
+  pos->prev->next = n;
+  pos->prev       = n;
+  return n;
+}
+
+template <class T, size_t K, class Alloc>
+void unrolled_list<T, K, Alloc>::free_node(base_ptr p) noexcept {
+  p->prev->next = p->next;
+  p->next->prev = p->prev;
+  node_alloc().deallocate(as_node(p), 1);
+}
+
+/**
+ * @brief 节点后部有空位时把 [i, last) 后移, 否则把 [first, i) 前移。元素先
+ *        构造到临时对象中, 因此 args 可以引用本容器中的元素
+ * @param  n                My Pan doc
+ * @param  i                My Pan doc
+ * @param  args             My Pan doc
+ * @return iterator
+ * */
+template <class T, size_t K, class Alloc>
+template <class... Args>
+typename unrolled_list<T, K, Alloc>::iterator
+unrolled_list<T, K, Alloc>::emplace_in(node_ptr n, size_t i, Args&&... args) {
+  MYSTL_DEBUG(n->count() < K);
+  if (i == n->last && n->last < K) {
+    get_alloc().construct(n->slot(i), Mystl::forward<Args>(args)...);
+    ++n->last;
+  } else if (i == n->first && n->first > 0) {
+    get_alloc().construct(n->slot(i - 1), Mystl::forward<Args>(args)...);
+    --n->first;
+    --i;
+  } else {
+    value_type tmp(Mystl::forward<Args>(args)...);
+    if (n->last < K) {
+      T* last = n->slot(n->last);
+      get_alloc().construct(last, Mystl::move(*(last - 1)));
+      ++n->last;
+      Mystl::move_backward(n->slot(i), last - 1, last);
+    } else {
+      T* first = n->slot(n->first);
+      get_alloc().construct(first - 1, Mystl::move(*first));
+      --n->first;
+      --i;
+      Mystl::move(first + 1, n->slot(i + 1), first);
+    }
+    *n->slot(i) = Mystl::move(tmp);
+  }
+  ++size_;
+  return iterator(n, i);
+}
+
+template <class T, size_t K, class Alloc>
+typename unrolled_list<T, K, Alloc>::node_ptr
+unrolled_list<T, K, Alloc>::split(node_ptr n, size_t at) {
+  node_ptr m = create_node(n->next, 0);
+  try {
+    Mystl::uninitialized_move(n->slot(at), n->slot(n->last), m->slot(0));
+  } catch (...) {
+    free_node(m);
+    throw;
+  }
+  get_alloc().destroy(n->slot(at), n->slot(n->last));
+  m->last = n->last - at;
+  n->last = at;
+  return m;
+}
+
+/**
+ * @brief 删除后移动较短的一侧补齐空位; 节点为空时释放
+ * @param  n                My Pan doc
+ * @param  a                My Pan doc
+ * @param  b                My Pan doc
+ * @return iterator
+ * */
+template <class T, size_t K, class Alloc>
+typename unrolled_list<T, K, Alloc>::iterator
+unrolled_list<T, K, Alloc>::erase_in(node_ptr n, size_t a, size_t b) {
+  const size_t removed = b - a;
+  size_ -= removed;
+  if (removed == n->count()) {
+    base_ptr next = n->next;
+    get_alloc().destroy(n->slot(a), n->slot(b));
+    free_node(n);
+    return iterator(next, next->first);
+  }
+  if (a - n->first < n->last - b) {
+    // 前一侧较短, 后移前一侧
+    Mystl::move_backward(n->slot(n->first), n->slot(a), n->slot(b));
+    get_alloc().destroy(n->slot(n->first), n->slot(n->first + removed));
+    n->first += removed;
+  } else {
+    Mystl::move(n->slot(b), n->slot(n->last), n->slot(a));
+    get_alloc().destroy(n->slot(n->last - removed), n->slot(n->last));
+    n->last -= removed;
+    if (a == n->last) {
+      return iterator(n->next, n->next->first);
+    }
+    return iterator(n, a);
+  }
+  return b == n->last ? iterator(n->next, n->next->first) : iterator(n, b);
+}
+
+/**
+ * @brief 把后继节点的元素移到 n 的末尾并释放后继节点, 必要时先把 n 的
+ *        元素移到数组开头
+ * @param  n                My Pan doc
+ * @param  pos              位于 n 或其后继节点中, 或为 end()
+ * @return iterator         合并后的 pos
+ * */
+template <class T, size_t K, class Alloc>
+typename unrolled_list<T, K, Alloc>::iterator
+unrolled_list<T, K, Alloc>::merge_next(node_ptr n, iterator pos) {
+  base_ptr next = n->next;
+  if (next == &head_ || n->count() + next->count() > K / 2) {
+    return pos;
+  }
+  node_ptr m = as_node(next);
+  if (n->last + m->count() > K) {
+    // 前移 n 的元素, 目标位置中 [0, first) 尚未构造, 其余已有元素
+    const size_t count = n->count();
+    const size_t shift = n->first;
+    for (size_t j = 0; j < count; ++j) {
+      if (j < shift) {
+        get_alloc().construct(n->slot(j), Mystl::move(*n->slot(j + shift)));
+      } else {
+        *n->slot(j) = Mystl::move(*n->slot(j + shift));
+      }
+    }
+    get_alloc().destroy(n->slot(count > shift ? count : shift),
+                        n->slot(n->last));
+    n->first = 0;
+    n->last  = count;
+    if (pos.node_ == n) {
+      pos.index_ -= shift;
+    }
+  }
+  Mystl::uninitialized_move(m->slot(m->first), m->slot(m->last),
+                            n->slot(n->last));
+  get_alloc().destroy(m->slot(m->first), m->slot(m->last));
+  if (pos.node_ == m) {
+    pos.node_  = n;
+    pos.index_ = n->last + pos.index_ - m->first;
+  }
+  n->last += m->count();
+  free_node(m);
+  return pos;
+}
+
+template <class T, size_t K, class Alloc>
+void unrolled_list<T, K, Alloc>::take_nodes(unrolled_list& rhs) noexcept {
+  MYSTL_DEBUG(empty());
+  if (!rhs.empty()) {
+    head_.next       = rhs.head_.next;
+    head_.prev       = rhs.head_.prev;
+    head_.next->prev = &head_;
+    head_.prev->next = &head_;
+    size_            = rhs.size_;
+    rhs.reset_head();
+    rhs.size_ = 0;
+  }
+}
+
+// 可以直接接管 rhs 的节点
+template <class T, size_t K, class Alloc>
+void unrolled_list<T, K, Alloc>::move_assign(unrolled_list& rhs,
+                                             m_true_type) {
+  clear();
+  copy_alloc(rhs,
+             typename alloc_traits::propagate_on_container_move_assignment());
+  take_nodes(rhs);
+}
+
+// allocator 不相等时只能逐个移动元素
+template <class T, size_t K, class Alloc>
+void unrolled_list<T, K, Alloc>::move_assign(unrolled_list& rhs,
+                                             m_false_type) {
+  if (alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  clear();
+  for (auto it = rhs.begin(); it != rhs.end(); ++it) {
+    emplace_back(Mystl::move(*it));
+  }
+  rhs.clear();
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+template <class T, size_t K, class Alloc>
+bool operator==(const unrolled_list<T, K, Alloc>& lhs,
+                const unrolled_list<T, K, Alloc>& rhs) {
+  return lhs.size() == rhs.size() &&
+         Mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t K, class Alloc>
+bool operator!=(const unrolled_list<T, K, Alloc>& lhs,
+                const unrolled_list<T, K, Alloc>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <class T, size_t K, class Alloc>
+void swap(unrolled_list<T, K, Alloc>& lhs, unrolled_list<T, K, Alloc>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace Mystl
+
+#endif /* __UNROLLED_LIST_H__ */
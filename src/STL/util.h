@@ -58,6 +58,19 @@ void swap(Tp (&a)[N], Tp (&b)[N]) {
   Mystl::swap_range(a, a + N, b);
 }
 
+// index_sequence
+// 编译期下标序列 0, 1, ..., N - 1, 用于逐个展开参数包中的元素
+template <size_t... I>
+struct index_sequence {};
+
+template <size_t N, size_t... I>
+struct make_index_sequence : make_index_sequence<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct make_index_sequence<0, I...> {
+  typedef index_sequence<I...> type;
+};
+
 // pair
 // 结构体模板：pair
 // 两个模板参数分别表示两个数据类型
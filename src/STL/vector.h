@@ -12,6 +12,8 @@
 #ifndef __VECTOR_H__
 #define __VECTOR_H__
 
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 
 #include "algobase.h"
@@ -20,9 +22,44 @@
 #include "memory.h"
 #include "uninitialized.h"
 #include "util.h"
+#include "vector_growth.h"
+#include "vector_ops.h"
+
+#if defined(MYSTL_USE_HUGE_PAGES)
+#include "huge_alloc.h"
+#endif  // MYSTL_USE_HUGE_PAGES
+
+#if defined(MYSTL_ALLOC_STATS)
+#include "alloc_stats.h"
+#endif  // MYSTL_ALLOC_STATS
 
 namespace Mystl {
 
+// vector 默认使用的配置器, 定义 MYSTL_USE_HUGE_PAGES 时大缓冲区使用透明大页
+#if defined(MYSTL_USE_HUGE_PAGES)
+template <class T>
+using vector_backend_alloc = Mystl::huge_page_allocator<T>;
+#else
+template <class T>
+using vector_backend_alloc = Mystl::allocator<T>;
+#endif  // MYSTL_USE_HUGE_PAGES
+
+// 定义 MYSTL_ALLOC_STATS 时记录 vector 的分配统计
+#if defined(MYSTL_ALLOC_STATS)
+struct vector_stats_tag {
+  static const char* name() {
+    return "vector";
+  }
+};
+
+template <class T>
+using vector_default_alloc =
+    Mystl::instrumented_allocator<vector_backend_alloc<T>, vector_stats_tag>;
+#else
+template <class T>
+using vector_default_alloc = vector_backend_alloc<T>;
+#endif  // MYSTL_ALLOC_STATS
+
 #ifdef max
 #pragma message("#undefing macro max")
 #endif  // max
@@ -31,14 +68,23 @@ namespace Mystl {
 #pragma message("#undefing macro min")
 #endif  // min
 
-template <class T>
-class vector {
+// 选择以多个线程并行构造元素的构造函数
+struct parallel_init_t {};
+constexpr parallel_init_t parallel_init{};
+
+// Growth 为扩容策略, 见 vector_growth.h
+template <class T,
+          class Alloc  = vector_default_alloc<T>,
+          class Growth = vector_default_growth>
+class vector : private Mystl::alloc_holder<Alloc> {
   static_assert(!std::is_same<bool, T>::value,
-                "vector<bool> is abandoned in Mystl");
+                "vector<bool> is abandoned in Mystl, use dynamic_bitset");
 
 public:
-  typedef Mystl::allocator<T> allocator_type;
-  typedef Mystl::allocator<T> data_allocator;
+  typedef Alloc                          allocator_type;
+  typedef Alloc                          data_allocator;
+  typedef Mystl::allocator_traits<Alloc> alloc_traits;
+  typedef Mystl::alloc_holder<Alloc>     alloc_base;
 
   typedef typename allocator_type::value_type      value_type;
   typedef typename allocator_type::pointer         pointer;
@@ -53,51 +99,89 @@ public:
   typedef Mystl::reverse_iterator<iterator>       reverse_iterator;
   typedef Mystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-  allocator_type get_allocator() {
-    return data_allocator();
+  allocator_type get_allocator() const {
+    return get_alloc();
   }
 
-  vector() noexcept {
-    try_init();
+  // 默认构造不申请空间, 第一次插入元素时才申请 VECTOR_INIT_CAP 个
+  vector() noexcept : begin_(nullptr), end_(nullptr), cap_(nullptr) {
   }
 
-  explicit vector(size_type n) {
+  explicit vector(const allocator_type &alloc) noexcept
+      : alloc_base(alloc), begin_(nullptr), end_(nullptr), cap_(nullptr) {
+  }
+
+  explicit vector(size_type n, const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
     fill_init(n, value_type());
   }
 
-  vector(size_type n, const value_type &value) {
+  vector(size_type             n,
+         const value_type &    value,
+         const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
     fill_init(n, value);
   }
 
+  // 以多个线程并行构造元素, 大数组的物理页按 first-touch 分布在各线程
+  // 所在的 NUMA 节点上
+  vector(size_type             n,
+         const value_type &    value,
+         parallel_init_t,
+         const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
+    init_space(n, n);
+    try {
+      Mystl::parallel_uninitialized_fill_n(begin_, n, value);
+    } catch (...) {
+      get_alloc().deallocate(begin_, cap_ - begin_);
+      throw;
+    }
+  }
+
   template <class Iter,
             typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
                                     int>::type = 0>
-  vector(Iter first, Iter last) {
+  vector(Iter first, Iter last, const allocator_type &alloc = allocator_type())
+      : alloc_base(alloc) {
     MYSTL_DEBUG(!(last < first));
     range_init(first, last);
   }
 
-  vector(const vector &rhs) {
+  vector(const vector &rhs)
+      : alloc_base(alloc_traits::select_on_container_copy_construction(
+            rhs.get_alloc())) {
+    range_init(rhs.begin_, rhs.end_);
+  }
+
+  vector(const vector &rhs, const allocator_type &alloc) : alloc_base(alloc) {
     range_init(rhs.begin_, rhs.end_);
   }
 
   vector(vector &&rhs) noexcept
-      : begin_(rhs.begin_), end_(rhs.end_), cap_(rhs.cap_) {
+      : alloc_base(Mystl::move(rhs.get_alloc())),
+        begin_(rhs.begin_),
+        end_(rhs.end_),
+        cap_(rhs.cap_) {
     rhs.begin_ = nullptr;
     rhs.end_   = nullptr;
     rhs.cap_   = nullptr;
   }
 
-  vector(std::initializer_list<value_type> ilist) {
+  vector(std::initializer_list<value_type> ilist,
+         const allocator_type &            alloc = allocator_type())
+      : alloc_base(alloc) {
     range_init(ilist.begin(), ilist.end());
   }
 
   vector &operator=(const vector &rhs);
 
-  vector &operator=(vector &&rhs) noexcept;
+  vector &operator=(vector &&rhs) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value);
 
   vector &operator=(std::initializer_list<value_type> ilist) {
-    vector tmp(ilist.begin(), ilist.end());
+    vector tmp(ilist.begin(), ilist.end(), get_alloc());
     swap(tmp);
     return *this;
   }
@@ -253,6 +337,15 @@ public:
   template <class... Args>
   void emplace_back(Args &&...args);
 
+  // 调用者已经 reserve, 保证备用空间足够, 省去容量检查
+  template <class... Args>
+  void emplace_back_unchecked(Args &&...args) {
+    MYSTL_DEBUG(end_ < cap_);
+    get_alloc().construct(Mystl::address_of(*end_),
+                          Mystl::forward<Args>(args)...);
+    ++end_;
+  }
+
   // push_back / pop_back
   void push_back(const value_type &value);
 
@@ -277,7 +370,29 @@ public:
   template <class Iter,
             typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
                                     int>::type = 0>
-  void insert(const_iterator pos, Iter first, Iter laser) {
+  void insert(const_iterator pos, Iter first, Iter last) {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    range_insert(const_cast<iterator>(pos), first, last,
+                 iterator_category(first));
+  }
+
+  // 插入一段元素, 前向迭代器只计算一次长度, 至多重新分配一次。除在尾部
+  // 插入外, [first, last) 不能指向本容器
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  iterator insert_range(const_iterator pos, Iter first, Iter last) {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    return range_insert(const_cast<iterator>(pos), first, last,
+                        iterator_category(first));
+  }
+
+  // 在尾部追加一段元素, 空间不足时先尝试原地扩大
+  template <class Iter,
+            typename std::enable_if<Mystl::is_input_iterator<Iter>::value,
+                                    int>::type = 0>
+  void append_range(Iter first, Iter last) {
+    range_append(first, last, iterator_category(first));
   }
 
   // erase / clear
@@ -296,6 +411,13 @@ public:
 
   void resize(size_type new_size, const value_type &value);
 
+  // 新增的元素只做默认初始化, 平凡类型不清零, 用于随后会被整块覆盖的
+  // 缓冲区
+  void resize_default_init(size_type new_size);
+
+  // 在尾部追加 n 个未写入的元素, 返回指向其中第一个的指针, 由调用者写入
+  pointer append_uninitialized(size_type n);
+
   void reverse() {
     Mystl::reverse(begin(), end());
   }
@@ -304,10 +426,10 @@ public:
   void swap(vector &rhs) noexcept;
 
 private:
+  using alloc_base::get_alloc;
+
   // helper function
   // initialize / destory
-  void try_init() noexcept;
-
   void init_space(size_type size, size_type cap);
 
   void fill_init(size_type n, const value_type &value);
@@ -320,6 +442,9 @@ private:
   // calculate the growth size
   size_type get_new_cap(size_type add_size);
 
+  // 按扩容策略保证至少还有 n 个备用空间
+  void reserve_more(size_type n);
+
   // assign
   void fill_assign(size_type n, const value_type &value);
 
@@ -329,11 +454,42 @@ private:
   template <class FIter>
   void copy_assign(FIter first, FIter last, forward_iterator_tag);
 
+  // relocate
+  // 元素可平凡重定位时, 扩容以及插入删除时的平移直接搬移字节
+  typedef is_trivially_relocatable<T> relocate_tag;
+
+  void release_buffer(m_true_type);
+  void release_buffer(m_false_type);
+
+  void relocate_around(iterator  pos,
+                       size_type n,
+                       iterator  new_begin,
+                       size_type new_cap);
+
   // reallocate
+  // 元素可平凡重定位且 allocator 提供 reallocate 时, 扩容交给 allocator
+  typedef m_bool_constant<relocate_tag::value &&
+                          alloc_traits::has_reallocate::value>
+      realloc_tag;
+
+  bool expand_in_place(size_type new_cap);
+  void reallocate_buffer(size_type new_cap, m_true_type);
+  void reallocate_buffer(size_type new_cap, m_false_type);
+
   template <class... Args>
   void reallocate_emplace(iterator pos, Args &&...args);
 
-  void reallocate_insert(iterator pos, const value_type &value);
+  template <class... Args>
+  void reallocate_emplace(iterator  pos,
+                          size_type new_cap,
+                          m_true_type,
+                          Args &&...args);
+
+  template <class... Args>
+  void reallocate_emplace(iterator  pos,
+                          size_type new_cap,
+                          m_false_type,
+                          Args &&...args);
 
   // insert
   iterator fill_insert(iterator pos, size_type n, const value_type &value);
@@ -341,30 +497,81 @@ private:
   template <class IIter>
   void copy_insert(iterator pos, IIter first, IIter last);
 
+  template <class IIter>
+  iterator range_insert(iterator pos,
+                        IIter    first,
+                        IIter    last,
+                        input_iterator_tag);
+
+  template <class FIter>
+  iterator range_insert(iterator pos,
+                        FIter    first,
+                        FIter    last,
+                        forward_iterator_tag);
+
+  template <class IIter>
+  void range_append(IIter first, IIter last, input_iterator_tag);
+
+  template <class FIter>
+  void range_append(FIter first, FIter last, forward_iterator_tag);
+
+  // [first, last) 是否确定不在本容器的空间中, 只有指针能够判断
+  template <class U>
+  bool is_outside(U *first, U *last) const noexcept {
+    std::less<const void *> less;
+    return !less(first, end_) || !less(begin_, last);
+  }
+
+  template <class Iter>
+  bool is_outside(Iter, Iter) const noexcept {
+    return false;
+  }
+
   // shrink_to_fit
   void reinsert(size_type size);
 
+  // move assign
+  void move_assign(vector &rhs, m_true_type);
+  void move_assign(vector &rhs, m_false_type);
+
+  // propagate / swap allocator
+  void copy_alloc(const vector &rhs, m_true_type);
+  void copy_alloc(const vector &, m_false_type) {
+  }
+  void swap_alloc(vector &rhs, m_true_type);
+  void swap_alloc(vector &, m_false_type) {
+  }
+
   iterator begin_;  // 使用空间的头部
   iterator end_;    // 使用空间的尾部
   iterator cap_;    // 存储空间的尾部
 };
 
 // 复制赋值构造符
-template <class T>
-vector<T> &vector<T>::operator=(const vector<T> &rhs) {
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth> &vector<T, Alloc, Growth>::operator=(
+    const vector &rhs) {
   if (this != &rhs) {
+    typedef typename alloc_traits::propagate_on_container_copy_assignment pocca;
+    if (pocca::value && !alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+      // 旧的空间只能由旧的 allocator 释放
+      destroy_and_recover(begin_, end_, cap_ - begin_);
+      begin_ = end_ = cap_ = nullptr;
+    }
+    copy_alloc(rhs, pocca());
+
     const auto len = rhs.size();
     if (len > capacity()) {
-      vector tmp(rhs.begin(), rhs.end());
+      vector tmp(rhs.begin(), rhs.end(), get_alloc());
       swap(tmp);
     } else if (size() >= len) {
       auto i = Mystl::copy(rhs.begin(), rhs.end(), begin());
-      data_allocator::destroy(i, end_);
+      get_alloc().destroy(i, end_);
       end_ = begin_ + len;
     } else {
       Mystl::copy(rhs.begin(), rhs.begin() + size(), begin_);
       Mystl::uninitialized_copy(rhs.begin() + size(), rhs.end(), end_);
-      cap_ = end_ = begin_ + len;
+      end_ = begin_ + len;
     }
   }
 
@@ -372,61 +579,58 @@ vector<T> &vector<T>::operator=(const vector<T> &rhs) {
 }
 
 // 移动赋值操作符
-template <class T>
-vector<T> &vector<T>::operator=(vector &&rhs) noexcept {
-  destroy_and_recover(begin_, end_, cap_ - begin_);
-  begin_     = rhs.begin_;
-  end_       = rhs.end_;
-  cap_       = rhs.cap_;
-  rhs.begin_ = nullptr;
-  rhs.end_   = nullptr;
-  rhs.cap_   = nullptr;
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth> &vector<T, Alloc, Growth>::operator=(
+    vector &&rhs) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+  if (this != &rhs) {
+    move_assign(
+        rhs,
+        m_bool_constant<
+            alloc_traits::propagate_on_container_move_assignment::value ||
+            alloc_traits::is_always_equal::value>());
+  }
 
   return *this;
 }
 
 // 预留空间大小， 当原容量小于要求大小时，才会重新分配
-template <class T>
-void vector<T>::reserve(size_type n) {
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reserve(size_type n) {
   if (capacity() < n) {
     THROW_LENGTH_ERROR_IF(
         n > max_size(),
         "n can not larger than max_size() in vector<T>::reserve");
-    const auto old_size = size();
-    auto       tmp      = data_allocator::allocate(n);
-    Mystl::uninitialized_move(begin_, end_, tmp);
-    data_allocator::deallocate(begin_, cap_ - begin_);
-    begin_ = tmp;
-    end_   = tmp + old_size;
-    cap_   = begin_ + n;
+    if (!expand_in_place(n)) {
+      reallocate_buffer(n, realloc_tag());
+    }
   }
 }
 
 // 放弃多余容量
-template <class T>
-void vector<T>::shrink_to_fit() {
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::shrink_to_fit() {
   if (end_ < cap_) {
     reinsert(size());
   }
 }
 
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class... Args>
-typename vector<T>::iterator vector<T>::emplace(const_iterator pos,
-                                                Args &&...args) {
+typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::emplace(
+    const_iterator pos,
+    Args &&...args) {
   MYSTL_DEBUG(pos >= begin() && pos <= end());
   iterator        xpos = const_cast<iterator>(pos);
   const size_type n    = xpos - begin_;
   if (end_ != cap_ && xpos == end_) {
-    data_allocator::construct(Mystl::address_of(*end_),
-                              Mystl::forward<Args>(args)...);
+    get_alloc().construct(Mystl::address_of(*end_),
+                          Mystl::forward<Args>(args)...);
     ++end_;
   } else if (end_ != cap_) {
-    auto new_end = end_;
-    data_allocator::construct(Mystl::address_of(*end_), *(end_ - 1));
-    ++new_end;
-    Mystl::copy_backward(xpos, end_ - 1, end_);
-    *xpos = value_type(Mystl::forward<Args>(args)...);
+    Mystl::vector_emplace_in_place(get_alloc(), xpos, end_, relocate_tag(),
+                                   Mystl::forward<Args>(args)...);
   } else {
     reallocate_emplace(xpos, Mystl::forward<Args>(args)...);
   }
@@ -435,12 +639,12 @@ typename vector<T>::iterator vector<T>::emplace(const_iterator pos,
 }
 
 // 在尾部就地构造元素，避免额外的复制或移动开销
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class... Args>
-void vector<T>::emplace_back(Args &&...args) {
+void vector<T, Alloc, Growth>::emplace_back(Args &&...args) {
   if (end_ < cap_) {
-    data_allocator::construct(Mystl::address_of(*end_),
-                              Mystl::forward<Args>(args)...);
+    get_alloc().construct(Mystl::address_of(*end_),
+                          Mystl::forward<Args>(args)...);
     ++end_;
   } else {
     reallocate_emplace(end_, Mystl::forward<Args>(args)...);
@@ -448,10 +652,10 @@ void vector<T>::emplace_back(Args &&...args) {
 }
 
 // 在尾部插入元素
-template <class T>
-void vector<T>::push_back(const value_type &value) {
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::push_back(const value_type &value) {
   if (end_ != cap_) {
-    data_allocator::construct(Mystl::address_of(*end_), value);
+    get_alloc().construct(Mystl::address_of(*end_), value);
     ++end_;
   } else {
     reallocate_emplace(end_, value);
@@ -459,63 +663,48 @@ void vector<T>::push_back(const value_type &value) {
 }
 
 // 弹出尾部元素
-template <class T>
-void vector<T>::pop_back() {
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::pop_back() {
   MYSTL_DEBUG(!empty());
-  data_allocator::destroy(end_ - 1);
+  get_alloc().destroy(end_ - 1);
   --end_;
 }
 
 // 在pos 处插入元素
-template <class T>
-typename vector<T>::iterator vector<T>::insert(const_iterator    pos,
-                                               const value_type &value) {
-  MYSTL_DEBUG(pos >= begin() && pos <= end());
-  iterator        xpos = const_cast<iterator>(pos);
-  const size_type n    = pos - begin_;
-  if (end_ != cap_ && xpos == end_) {
-    data_allocator::construct(Mystl::address_of(*end_), value);
-    ++end_;
-  } else if (end_ != cap_) {
-    auto new_end = end_;
-    data_allocator::construct(Mystl::address_of(*end_), *(end_ - 1));
-    ++new_end;
-    auto value_copy = value;  // 避免元素因以下复制操作改变其值
-    Mystl::copy_backward(xpos, end_ - 1, end_);
-    *xpos = Mystl::move(value_copy);
-    end_  = new_end;
-  } else {
-    reallocate_emplace(xpos, value);
-  }
-
-  return begin_ + n;
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(
+    const_iterator    pos,
+    const value_type &value) {
+  return emplace(pos, value);
 }
 
 // 删除pos位置上的元素
-template <class T>
-typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase(
+    const_iterator pos) {
   MYSTL_DEBUG(pos >= begin() && pos < end());
-  iterator xpos = begin_ + (pos - begin());
-  Mystl::move(xpos + 1, end_, xpos);
-  data_allocator::destroy(end_ - 1);
-  --end_;
-  return xpos;
+  return erase(pos, pos + 1);
 }
 
 // 删除[first, last)上的元素
-template <class T>
-typename vector<T>::iterator vector<T>::erase(const_iterator first,
-                                              const_iterator last) {
-  const auto n = first - begin();
-  iterator   r = begin_ + (first - begin());
-  data_allocator::destroy(Mystl::move(r + (last - first), end_, r), end_);
-  end_ = end_ - (last - first);
-  return begin_ + n;
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase(
+    const_iterator first,
+    const_iterator last) {
+  MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+  iterator xfirst = begin_ + (first - begin());
+  if (first != last) {
+    // 空区间时不能移动, 否则元素会被移动赋值给自身
+    Mystl::vector_erase_shift(get_alloc(), xfirst, begin_ + (last - begin()),
+                              end_, relocate_tag());
+  }
+  return xfirst;
 }
 
 // 重置容器大小
-template <class T>
-void vector<T>::resize(size_type new_size, const value_type &value) {
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize(size_type         new_size,
+                                      const value_type &value) {
   if (new_size < size()) {
     erase(begin() + new_size, end());
   } else {
@@ -523,49 +712,67 @@ void vector<T>::resize(size_type new_size, const value_type &value) {
   }
 }
 
+/**
+ * @brief 重置容器大小, 新增的元素默认初始化
+ * @param  new_size         My Pan doc
+ * */
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize_default_init(size_type new_size) {
+  if (new_size < size()) {
+    erase(begin() + new_size, end());
+  } else {
+    reserve_more(new_size - size());
+    end_ = Mystl::uninitialized_default_n(end_, new_size - size());
+  }
+}
+
+/**
+ * @brief 在尾部追加 n 个未写入的元素。只用于可平凡默认构造的类型, 这些
+ *        元素在写入之前的值不确定
+ * @param  n                My Pan doc
+ * @return pointer          第一个新元素的位置
+ * */
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::pointer
+vector<T, Alloc, Growth>::append_uninitialized(size_type n) {
+  static_assert(std::is_trivially_default_constructible<T>::value,
+                "append_uninitialized needs a trivially constructible type");
+  reserve_more(n);
+  pointer result = end_;
+  end_ += n;
+  return result;
+}
+
 /**
  * @brief 与另一个vector 交换
  * @tparam T
  * @param  rhs              My Pan doc
  * */
-template <class T>
-void vector<T>::swap(vector<T> &rhs) noexcept {
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::swap(vector<T, Alloc, Growth> &rhs) noexcept {
   if (this != &rhs) {
+    // 不传播 allocator 时, 两者必须相等
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                alloc_traits::equal(get_alloc(), rhs.get_alloc()));
     Mystl::swap(begin_, rhs.begin_);
     Mystl::swap(end_, rhs.end_);
     Mystl::swap(cap_, rhs.cap_);
+    swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
   }
 }
 
 // helper function
 
 /**
- * @brief try_init 函数，若分配失败则忽略， 不抛出异常
- * @tparam T
- * */
-template <class T>
-void vector<T>::try_init() noexcept {
-  try {
-    begin_ = data_allocator::allocate(16);
-    end_   = begin_;
-    cap_   = begin_ + 16;
-  } catch (...) {
-    begin_ = nullptr;
-    end_   = nullptr;
-    cap_   = nullptr;
-  }
-}
-
-/**
- * @brief init_space 函数
+ * @brief init_space 函数, cap 为 0 时不申请空间
  * @tparam T
  * @param  size             My Pan doc
  * @param  cap              My Pan doc
  * */
-template <class T>
-void vector<T>::init_space(size_type size, size_type cap) {
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::init_space(size_type size, size_type cap) {
   try {
-    begin_ = data_allocator::allocate(cap);
+    begin_ = cap == 0 ? nullptr : get_alloc().allocate(cap);
     end_   = begin_ + size;
     cap_   = begin_ + cap;
   } catch (...) {
@@ -576,49 +783,66 @@ void vector<T>::init_space(size_type size, size_type cap) {
   }
 }
 
-template <class T>
-void vector<T>::fill_init(size_type n, const value_type &value) {
-  const size_type init_size = Mystl::max(static_cast<size_type>(16), n);
-  init_space(n, init_size);
-  Mystl::uninitialized_fill_n(begin_, n, value);
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::fill_init(size_type n, const value_type &value) {
+  init_space(n, n);
+  try {
+    Mystl::uninitialized_fill_n(begin_, n, value);
+  } catch (...) {
+    get_alloc().deallocate(begin_, n);
+    throw;
+  }
 }
 
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class Iter>
-void vector<T>::range_init(Iter first, Iter last) {
-  const size_type init_size = Mystl::max(static_cast<size_type>(last - first),
-                                         static_cast<size_type>(16));
-  init_space(static_cast<size_type>(last - first), init_size);
-  Mystl::uninitialized_copy(first, last, begin_);
+void vector<T, Alloc, Growth>::range_init(Iter first, Iter last) {
+  const size_type n = Mystl::distance(first, last);
+  init_space(n, n);
+  try {
+    Mystl::uninitialized_copy(first, last, begin_);
+  } catch (...) {
+    get_alloc().deallocate(begin_, n);
+    throw;
+  }
 }
 
-template <class T>
-void vector<T>::destroy_and_recover(iterator  first,
-                                    iterator  last,
-                                    size_type n) {
-  data_allocator::destroy(first, last);
-  data_allocator::deallocate(first, n);
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::destroy_and_recover(iterator  first,
+                                                   iterator  last,
+                                                   size_type n) {
+  get_alloc().destroy(first, last);
+  get_alloc().deallocate(first, n);
 }
 
-template <class T>
-typename vector<T>::size_type vector<T>::get_new_cap(size_type add_size) {
-  const auto old_size = capacity();
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::size_type
+vector<T, Alloc, Growth>::get_new_cap(size_type add_size) {
+  const auto old_size = size();
   THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,
                         "vector<T>'s size too big");
-  if (old_size > max_size() - old_size / 2) {
-    return old_size + add_size > max_size() - 16 ? old_size + add_size
-                                                 : old_size + add_size + 16;
+  const size_type required = old_size + add_size;
+  const size_type new_cap =
+      Growth::next_capacity(get_alloc(), capacity(), required);
+  // 策略的计算溢出或超过上限时, 退回到恰好容纳
+  return new_cap < required || new_cap > max_size() ? required : new_cap;
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reserve_more(size_type n) {
+  if (static_cast<size_type>(cap_ - end_) < n) {
+    const auto new_cap = get_new_cap(n);
+    if (!expand_in_place(new_cap)) {
+      reallocate_buffer(new_cap, realloc_tag());
+    }
   }
-  const size_type new_size =
-      old_size == 0 ? Mystl::max(add_size, static_cast<size_type>(16))
-                    : Mystl::max(old_size + old_size / 2, old_size + add_size);
-  return new_size;
 }
 
-template <class T>
-void vector<T>::fill_assign(size_type n, const value_type &value) {
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::fill_assign(size_type         n,
+                                           const value_type &value) {
   if (n > capacity()) {
-    vector tmp(n, value);
+    vector tmp(n, value, get_alloc());
     swap(tmp);
   } else if (n > size()) {
     Mystl::fill(begin(), end(), value);
@@ -628,9 +852,11 @@ void vector<T>::fill_assign(size_type n, const value_type &value) {
   }
 }
 
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class IIter>
-void vector<T>::copy_assign(IIter first, IIter last, input_iterator_tag) {
+void vector<T, Alloc, Growth>::copy_assign(IIter first,
+                                           IIter last,
+                                           input_iterator_tag) {
   auto cur = begin_;
   for (; first != last && cur != end_; ++first, ++cur) {
     *cur = *first;
@@ -638,20 +864,22 @@ void vector<T>::copy_assign(IIter first, IIter last, input_iterator_tag) {
   if (first == last) {
     erase(cur, end_);
   } else {
-    insert(end_, first, last);
+    range_append(first, last, input_iterator_tag());
   }
 }
 
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class FIter>
-void vector<T>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
+void vector<T, Alloc, Growth>::copy_assign(FIter first,
+                                           FIter last,
+                                           forward_iterator_tag) {
   const size_type len = Mystl::distance(first, last);
   if (len > capacity()) {
-    vector tmp(first, last);
+    vector tmp(first, last, get_alloc());
     swap(tmp);
   } else if (size() >= len) {
     auto new_end = Mystl::copy(first, last, begin_);
-    data_allocator::destroy(new_end, end_);
+    get_alloc().destroy(new_end, end_);
     end_ = new_end;
   } else {
     auto mid = first;
@@ -662,193 +890,392 @@ void vector<T>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
   }
 }
 
-template <class T>
+/**
+ * @brief 通过 allocator 的 try_expand 原地扩大容量, 元素地址不变
+ * @param  new_cap          My Pan doc
+ * @return bool             allocator 不支持或空间不足时返回 false
+ * */
+template <class T, class Alloc, class Growth>
+bool vector<T, Alloc, Growth>::expand_in_place(size_type new_cap) {
+  if (begin_ == nullptr ||
+      !alloc_traits::try_expand(get_alloc(), begin_, capacity(), new_cap)) {
+    return false;
+  }
+  cap_ = begin_ + new_cap;
+  return true;
+}
+
+/**
+ * @brief 以 allocator 的 reallocate 扩容, 元素按字节搬移, 大块内存可以由
+ *        mremap 等方式完成而不复制
+ * @param  new_cap          My Pan doc
+ * */
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reallocate_buffer(size_type new_cap,
+                                                 m_true_type) {
+  const size_type old_size = size();
+  begin_ = get_alloc().reallocate(begin_, capacity(), new_cap);
+  end_   = begin_ + old_size;
+  cap_   = begin_ + new_cap;
+}
+
+// 申请新空间并把元素搬过去
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reallocate_buffer(size_type new_cap,
+                                                 m_false_type) {
+  relocate_around(end_, 0, get_alloc().allocate(new_cap), new_cap);
+}
+
+template <class T, class Alloc, class Growth>
 template <class... Args>
-void vector<T>::reallocate_emplace(iterator pos, Args &&...args) {
-  const auto new_size  = get_new_cap(1);
-  auto       new_begin = data_allocator::allocate(new_size);
-  auto       new_end   = new_begin;
+void vector<T, Alloc, Growth>::reallocate_emplace(iterator pos,
+                                                  Args &&...args) {
+  const auto new_size = get_new_cap(1);
+  if (pos == end_ && expand_in_place(new_size)) {
+    get_alloc().construct(Mystl::address_of(*end_),
+                          Mystl::forward<Args>(args)...);
+    ++end_;
+    return;
+  }
+  reallocate_emplace(pos, new_size, realloc_tag(),
+                     Mystl::forward<Args>(args)...);
+}
+
+/**
+ * @brief 元素可以按字节搬移时, 先构造新元素, 再 reallocate 扩容并以
+ *        uninitialized_relocate 腾出位置。args 可能引用本容器中的元素,
+ *        因此必须在扩容之前构造; 移入失败时把尾部移回
+ * */
+template <class T, class Alloc, class Growth>
+template <class... Args>
+void vector<T, Alloc, Growth>::reallocate_emplace(iterator  pos,
+                                                  size_type new_cap,
+                                                  m_true_type,
+                                                  Args &&...args) {
+  value_type      tmp(Mystl::forward<Args>(args)...);
+  const size_type xpos = pos - begin_;
+  reallocate_buffer(new_cap, m_true_type());
+  pos = begin_ + xpos;
+  Mystl::uninitialized_relocate(pos, end_, pos + 1);
+  try {
+    get_alloc().construct(Mystl::address_of(*pos), Mystl::move(tmp));
+  } catch (...) {
+    Mystl::uninitialized_relocate(pos + 1, end_ + 1, pos);
+    throw;
+  }
+  ++end_;
+}
+
+/**
+ * @brief 申请新空间, 先在新空间中构造新元素, 再把原有元素搬到它两侧。
+ *        args 可能引用本容器中的元素, 因此必须先构造
+ * */
+template <class T, class Alloc, class Growth>
+template <class... Args>
+void vector<T, Alloc, Growth>::reallocate_emplace(iterator  pos,
+                                                  size_type new_cap,
+                                                  m_false_type,
+                                                  Args &&...args) {
+  auto new_begin = get_alloc().allocate(new_cap);
   try {
-    new_end = Mystl::uninitialized_move(begin_, pos, new_begin);
-    data_allocator::constuctor(Mystl::address_of(*new_end),
-                               Mystl::forward<Args>(args)...);
-    ++new_end;
-    new_end = Mystl::uninitialized_move(pos, end_, new_end);
+    get_alloc().construct(Mystl::address_of(*(new_begin + (pos - begin_))),
+                          Mystl::forward<Args>(args)...);
   } catch (...) {
-    data_allocator::deallocate(new_begin, new_size);
+    get_alloc().deallocate(new_begin, new_cap);
     throw;
   }
+  relocate_around(pos, 1, new_begin, new_cap);
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::release_buffer(m_true_type) {
+  get_alloc().deallocate(begin_, cap_ - begin_);
+}
 
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::release_buffer(m_false_type) {
   destroy_and_recover(begin_, end_, cap_ - begin_);
-  begin_ = new_begin;
-  end_   = new_end;
-  cap_   = new_begin + new_size;
 }
 
-template <class T>
-void vector<T>::reallocate_insert(iterator pos, const value_type &value) {
-  const auto        new_size   = get_new_cap(1);
-  auto              new_begin  = data_allocator::construct(new_size);
-  auto              new_end    = new_begin;
-  const value_type &value_copy = value;
+/**
+ * @brief 把原有元素搬到新空间, 在 pos 对应的位置留出 n 个空位, 然后释放
+ *        旧空间。调用者已在空位中构造好新元素; 搬移失败时销毁这些新元素并
+ *        释放新空间, 原容器不变
+ * @param  pos              My Pan doc
+ * @param  n                My Pan doc
+ * @param  new_begin        My Pan doc
+ * @param  new_cap          My Pan doc
+ * */
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::relocate_around(iterator  pos,
+                                               size_type n,
+                                               iterator  new_begin,
+                                               size_type new_cap) {
+  iterator new_end;
   try {
-    new_end = data_allocator::uninitialized_move(begin_, pos, new_begin);
-    data_allocator::construct(Mystl::address_of(*new_end), value_copy);
-    ++new_end;
-    Mystl::uninitialized_move(pos, end_, new_end);
+    new_end = Mystl::vector_relocate_around(get_alloc(), begin_, pos, end_, n,
+                                            new_begin, relocate_tag());
   } catch (...) {
-    data_allocator::destroy(new_begin, new_size);
+    get_alloc().deallocate(new_begin, new_cap);
     throw;
   }
+
+  release_buffer(relocate_tag());
   begin_ = new_begin;
   end_   = new_end;
-  cap_   = new_begin + new_size;
+  cap_   = new_begin + new_cap;
 }
 
-template <class T>
-typename vector<T>::iterator vector<T>::fill_insert(iterator          pos,
-                                                    size_type         n,
-                                                    const value_type &value) {
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::fill_insert(iterator          pos,
+                                      size_type         n,
+                                      const value_type &value) {
   if (0 == n) {
     return pos;
   }
 
   const size_type  xpos       = pos - begin_;
-  const value_type value_copy = value;
+  const value_type value_copy = value;  // value 可能引用本容器中的元素
   if (static_cast<size_type>(cap_ - end_) >= n) {
     // 备用空间大于增加的空间
-    const size_type after_elems = end_ - pos;
-    auto            old_end     = end_;
-    if (after_elems > n) {
-      Mystl::uninitialized_copy(end_ - n, end_, end_);
-      end_ += n;
-      Mystl::move_backward(pos, old_end - n, old_end);
-      Mystl::uninitialized_fill_n(pos, n, value_copy);
-    } else {
-      end_ = Mystl::uninitialized_fill_n(end_, n - after_elems, value_copy);
-      end_ = Mystl::uninitialized_move(pos, old_end, end_);
-      Mystl::uninitialized_fill_n(pos, end_, value_copy);
-    }
+    Mystl::vector_fill_in_place(get_alloc(), pos, end_, n, value_copy,
+                                relocate_tag());
   } else {
     // 备用空间不足
     const auto new_size  = get_new_cap(n);
-    auto       new_begin = data_allocator::allocate(new_size);
-    auto       new_end   = new_begin;
-
+    auto       new_begin = get_alloc().allocate(new_size);
     try {
-      new_end = Mystl::uninitialized_move(begin_, pos, new_begin);
-      new_end = Mystl::uninitialized_fill_n(new_end, n, value);
-      new_end = Mystl::uninitialized_move(pos, end_, new_end);
+      Mystl::uninitialized_fill_n(new_begin + xpos, n, value_copy);
     } catch (...) {
-      destroy_and_recover(new_begin, new_end, new_size);
+      get_alloc().deallocate(new_begin, new_size);
       throw;
     }
-    data_allocator::deallocate(begin_, cap_ - begin_);
-    begin_ = new_begin;
-    end_   = new_end;
-    cap_   = new_begin + new_size;
+    relocate_around(pos, n, new_begin, new_size);
   }
 
   return begin_ + xpos;
 }
 
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class IIter>
-void vector<T>::copy_insert(iterator pos, IIter first, IIter last) {
+void vector<T, Alloc, Growth>::copy_insert(iterator pos,
+                                           IIter    first,
+                                           IIter    last) {
   if (first == last) {
     return;
   }
 
-  const size_type n = Mystl::advance(first, last);
-  if (cap_ - end_ >= n) {
+  const size_type n = Mystl::distance(first, last);
+  if (static_cast<size_type>(cap_ - end_) >= n) {
     // 空间足够
-    const auto after_elems = end_ - pos;
-    auto       old_end     = end_;
-    if (after_elems > n) {
-      end_ = Mystl::uninitialized_copy(end_ - n, end_, end_);
-      Mystl::move_backward(pos, old_end - n, old_end);
-      Mystl::uninitialized_copy(first, last, pos);
-    } else {
-      auto mid = first;
-      Mystl::advance(mid, after_elems);
-      end_ = Mystl::uninitialized_copy(mid, last, end_);
-      end_ = Mystl::uninitialized_move(pos, old_end, end_);
-      Mystl::uninitialized_copy(first, mid, pos);
-    }
+    Mystl::vector_copy_in_place(get_alloc(), pos, end_, first, last, n,
+                                relocate_tag());
   } else {
     // 空间不足
     const auto new_size  = get_new_cap(n);
-    auto       new_begin = data_allocator::allocate(new_size);
-    auto       new_end   = new_begin;
+    auto       new_begin = get_alloc().allocate(new_size);
     try {
-      new_end = Mystl::uninitialized_move(begin_, pos, new_end);
-      new_end = Mystl::uninitialized_copy(first, last, new_end);
-      new_end = Mystl::uninitialized_move(pos, end_, new_end);
+      Mystl::uninitialized_copy(first, last, new_begin + (pos - begin_));
     } catch (...) {
-      destroy_and_recover(new_begin, new_end, new_size);
+      get_alloc().deallocate(new_begin, new_size);
       throw;
     }
-    begin_ = new_begin;
-    end_   = new_end;
-    cap_   = new_begin + new_size;
+    relocate_around(pos, n, new_begin, new_size);
   }
 }
 
-template <class T>
-void vector<T>::reinsert(size_type size) {
-  auto new_begin = data_allocator::allocate(size);
-  try {
-    Mystl::uninitialized_move(begin_, end_, new_begin);
-  } catch (...) {
-    data_allocator::deallocate(new_begin, size);
-    throw;
+/**
+ * @brief 输入迭代器只能遍历一次, 无法预先得知长度: 在尾部时逐个追加,
+ *        否则先收集到临时 vector 中再一次插入
+ * */
+template <class T, class Alloc, class Growth>
+template <class IIter>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::range_insert(iterator pos,
+                                       IIter    first,
+                                       IIter    last,
+                                       input_iterator_tag) {
+  const size_type xpos = pos - begin_;
+  if (pos == end_) {
+    range_append(first, last, input_iterator_tag());
+  } else {
+    vector tmp(get_alloc());
+    tmp.range_append(first, last, input_iterator_tag());
+    copy_insert(pos, tmp.begin_, tmp.end_);
+  }
+  return begin_ + xpos;
+}
+
+template <class T, class Alloc, class Growth>
+template <class FIter>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::range_insert(iterator pos,
+                                       FIter    first,
+                                       FIter    last,
+                                       forward_iterator_tag) {
+  const size_type xpos = pos - begin_;
+  if (pos == end_) {
+    range_append(first, last, forward_iterator_tag());
+  } else {
+    copy_insert(pos, first, last);
   }
+  return begin_ + xpos;
+}
 
-  data_allocator::deallocate(begin_, cap_ - begin_);
-  begin_ = new_begin;
-  end_   = begin_ + size;
-  cap_   = begin_ + size;
+template <class T, class Alloc, class Growth>
+template <class IIter>
+void vector<T, Alloc, Growth>::range_append(IIter first,
+                                            IIter last,
+                                            input_iterator_tag) {
+  for (; first != last; ++first) {
+    emplace_back(*first);
+  }
+}
+
+/**
+ * @brief 计算一次长度后追加。空间不足时先尝试原地扩大; 源区间确定在本
+ *        容器之外时按 reserve 的方式扩容, 可以利用 allocator 的
+ *        reallocate; 否则在新空间中先复制新元素再搬移原有元素, 因此
+ *        [first, last) 可以指向本容器。源区间是指向平凡类型的指针时,
+ *        复制由 memmove 完成
+ * */
+template <class T, class Alloc, class Growth>
+template <class FIter>
+void vector<T, Alloc, Growth>::range_append(FIter first,
+                                            FIter last,
+                                            forward_iterator_tag) {
+  const size_type n = Mystl::distance(first, last);
+  if (static_cast<size_type>(cap_ - end_) < n) {
+    const auto new_cap = get_new_cap(n);
+    if (!expand_in_place(new_cap)) {
+      if (is_outside(first, last)) {
+        reallocate_buffer(new_cap, realloc_tag());
+      } else {
+        auto new_begin = get_alloc().allocate(new_cap);
+        try {
+          Mystl::uninitialized_copy(first, last, new_begin + size());
+        } catch (...) {
+          get_alloc().deallocate(new_begin, new_cap);
+          throw;
+        }
+        relocate_around(end_, n, new_begin, new_cap);
+        return;
+      }
+    }
+  }
+  end_ = Mystl::uninitialized_copy(first, last, end_);
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reinsert(size_type size) {
+  relocate_around(end_, 0, get_alloc().allocate(size), size);
+}
+
+/**
+ * @brief 移动赋值, allocator 可以传播或总是相等时直接接管 rhs 的空间
+ * @param  rhs              My Pan doc
+ * */
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::move_assign(vector &rhs, m_true_type) {
+  destroy_and_recover(begin_, end_, cap_ - begin_);
+  copy_alloc(rhs,
+             typename alloc_traits::propagate_on_container_move_assignment());
+  begin_     = rhs.begin_;
+  end_       = rhs.end_;
+  cap_       = rhs.cap_;
+  rhs.begin_ = nullptr;
+  rhs.end_   = nullptr;
+  rhs.cap_   = nullptr;
+}
+
+/**
+ * @brief 移动赋值, allocator 不相等时 rhs 的空间不能由本容器释放,
+ *        只能逐个移动元素
+ * @param  rhs              My Pan doc
+ * */
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::move_assign(vector &rhs, m_false_type) {
+  if (alloc_traits::equal(get_alloc(), rhs.get_alloc())) {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+
+  const size_type len = rhs.size();
+  if (len > capacity()) {
+    destroy_and_recover(begin_, end_, cap_ - begin_);
+    begin_ = end_ = cap_ = nullptr;
+    init_space(0, len);
+  } else {
+    get_alloc().destroy(begin_, end_);
+    end_ = begin_;
+  }
+  end_ = Mystl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+  rhs.clear();
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::copy_alloc(const vector &rhs, m_true_type) {
+  get_alloc() = rhs.get_alloc();
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::swap_alloc(vector &rhs, m_true_type) {
+  Mystl::swap(get_alloc(), rhs.get_alloc());
 }
 
 // 重载操作比较符
-template <class T>
-bool operator==(const vector<T> &lhs, const vector<T> &rhs) {
+template <class T, class Alloc, class Growth>
+bool operator==(const vector<T, Alloc, Growth> &lhs,
+                const vector<T, Alloc, Growth> &rhs) {
   return lhs.size() == rhs.size() &&
          Mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const vector<T> &lhs, const vector<T> &rhs) {
+template <class T, class Alloc, class Growth>
+bool operator<(const vector<T, Alloc, Growth> &lhs,
+               const vector<T, Alloc, Growth> &rhs) {
   return Mystl::lexicographical_compare(lhs.begin(),
                                         lhs.end(),
                                         rhs.begin(),
                                         rhs.end());
 }
 
-template <class T>
-bool operator!=(const vector<T> &lhs, const vector<T> &rhs) {
+template <class T, class Alloc, class Growth>
+bool operator!=(const vector<T, Alloc, Growth> &lhs,
+                const vector<T, Alloc, Growth> &rhs) {
   return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const vector<T> &lhs, const vector<T> &rhs) {
+template <class T, class Alloc, class Growth>
+bool operator>(const vector<T, Alloc, Growth> &lhs,
+               const vector<T, Alloc, Growth> &rhs) {
   return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const vector<T> &lhs, const vector<T> &rhs) {
+template <class T, class Alloc, class Growth>
+bool operator<=(const vector<T, Alloc, Growth> &lhs,
+                const vector<T, Alloc, Growth> &rhs) {
   return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const vector<T> &lhs, const vector<T> &rhs) {
+template <class T, class Alloc, class Growth>
+bool operator>=(const vector<T, Alloc, Growth> &lhs,
+                const vector<T, Alloc, Growth> &rhs) {
   return !(lhs < rhs);
 }
 
-template <class T>
-void swap(vector<T> &lhs, vector<T> &rhs) {
+template <class T, class Alloc, class Growth>
+void swap(vector<T, Alloc, Growth> &lhs, vector<T, Alloc, Growth> &rhs) {
   lhs.swap(rhs);
 }
+
+// vector 只保存指向堆空间的指针, 因此只要 allocator 可以平凡重定位,
+// vector 整体也可以按字节搬移
+template <class T, class Alloc, class Growth>
+struct is_trivially_relocatable<vector<T, Alloc, Growth>>
+    : m_bool_constant<is_trivially_relocatable<Alloc>::value> {};
+
 }  // namespace Mystl
 
 #endif /*__VECTOR_H__*/
@@ -0,0 +1,110 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file vector_growth.h
+ * @brief vector 的扩容策略
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-20 10:05:37
+ *
+ * 扩容策略是 vector 的第三个模板参数, 提供静态成员函数
+ *
+ *   template <class Alloc>
+ *   static size_t next_capacity(const Alloc& alloc, size_t old_cap,
+ *                               size_t required);
+ *
+ * 返回容量为 old_cap、至少需要容纳 required 个元素时的新容量。返回值
+ * 小于 required 或超过 max_size() 时 vector 退回到恰好容纳 required 个。
+ *
+ *   geometric_growth<Num, Den>  按 Num / Den 倍增长, 默认 1.5 倍
+ *   exact_growth                恰好容纳, 适合一次性装载后不再增长的数据
+ *   power_of_two_growth         按 2 倍增长, 并把字节数上调到 2 的幂
+ *   size_class_growth           按 1.5 倍增长, 再上调到 allocator 实际会
+ *                               给出的大小, 不浪费 size class 的尾部
+ *
+ * */
+
+#ifndef __VECTOR_GROWTH_H__
+#define __VECTOR_GROWTH_H__
+
+#include <cstddef>
+
+#include "allocator.h"
+
+namespace Mystl {
+
+// 空 vector 第一次插入元素时申请的容量, 可以在包含本文件之前定义
+// MYSTL_VECTOR_INIT_CAP 修改
+#if !defined(MYSTL_VECTOR_INIT_CAP)
+#define MYSTL_VECTOR_INIT_CAP 16
+#endif  // MYSTL_VECTOR_INIT_CAP
+
+enum { VECTOR_INIT_CAP = MYSTL_VECTOR_INIT_CAP };
+static_assert(VECTOR_INIT_CAP > 0, "MYSTL_VECTOR_INIT_CAP must be positive");
+
+/**
+ * @brief 按 Num / Den 倍增长, 第一次申请 VECTOR_INIT_CAP 个
+ * @tparam Num
+ * @tparam Den
+ * */
+template <size_t Num = 3, size_t Den = 2>
+struct geometric_growth {
+  static_assert(Num > Den && Den > 0, "growth factor must be above 1");
+
+  template <class Alloc>
+  static size_t next_capacity(const Alloc&, size_t old_cap, size_t required) {
+    if (old_cap == 0) {
+      return required > VECTOR_INIT_CAP ? required
+                                        : static_cast<size_t>(VECTOR_INIT_CAP);
+    }
+    const size_t grown = old_cap + old_cap / Den * (Num - Den);
+    return grown > required ? grown : required;
+  }
+};
+
+// 恰好容纳所需的元素
+struct exact_growth {
+  template <class Alloc>
+  static size_t next_capacity(const Alloc&, size_t, size_t required) {
+    return required;
+  }
+};
+
+// 按 2 倍增长, 字节数上调到 2 的幂
+struct power_of_two_growth {
+  template <class Alloc>
+  static size_t next_capacity(const Alloc& alloc,
+                              size_t       old_cap,
+                              size_t       required) {
+    typedef typename Alloc::value_type T;
+    const size_t want =
+        geometric_growth<2, 1>::next_capacity(alloc, old_cap, required);
+    if (want > static_cast<size_t>(-1) / 2 / sizeof(T)) {
+      return want;
+    }
+    size_t bytes = 1;
+    while (bytes < want * sizeof(T)) {
+      bytes <<= 1;
+    }
+    return bytes / sizeof(T);
+  }
+};
+
+// 按 1.5 倍增长, 再上调到 allocator 实际会给出的对象个数
+struct size_class_growth {
+  template <class Alloc>
+  static size_t next_capacity(const Alloc& alloc,
+                              size_t       old_cap,
+                              size_t       required) {
+    const size_t want =
+        geometric_growth<>::next_capacity(alloc, old_cap, required);
+    const size_t good = allocator_traits<Alloc>::good_size(alloc, want);
+    return good > want ? good : want;
+  }
+};
+
+// vector 默认的扩容策略
+typedef geometric_growth<> vector_default_growth;
+
+}  // namespace Mystl
+
+#endif /* __VECTOR_GROWTH_H__ */
@@ -0,0 +1,218 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file vector_ops.h
+ * @brief 连续存储容器共用的元素搬移操作
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-27 10:05:12
+ *
+ * vector、small_vector 与 static_vector 都把元素保存在 [begin, end) 上,
+ * 扩容、插入与删除时的搬移方式相同。这里的函数只操作元素, 由 end 参数
+ * 维护尾部; 申请与释放空间仍由各容器负责。
+ *
+ * 最后一个参数为 is_trivially_relocatable<T>: 为真时平移直接按字节搬移,
+ * 否则逐个移动构造或移动赋值。
+ *
+ * */
+
+#ifndef __VECTOR_OPS_H__
+#define __VECTOR_OPS_H__
+
+#include <cstddef>
+
+#include "algobase.h"
+#include "iterator.h"
+#include "type_traits.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace Mystl {
+
+// 可平凡重定位时按字节搬移, 原元素随即失效
+template <class T>
+T* vector_transfer(T* first, T* last, T* result, m_true_type) {
+  return Mystl::uninitialized_relocate(first, last, result);
+}
+
+// 逐个移动构造, 原元素仍需由调用者销毁
+template <class T>
+T* vector_transfer(T* first, T* last, T* result, m_false_type) {
+  return Mystl::uninitialized_move(first, last, result);
+}
+
+/**
+ * @brief 把 [begin, end) 搬到 new_begin 开始的新空间, 在 pos 对应的位置留出
+ *        n 个空位。调用者已在空位中构造好新元素; 搬移失败时销毁这些新元素,
+ *        原元素仍在旧空间中, 新空间由调用者释放。不可平凡重定位时原元素
+ *        也由调用者销毁
+ * @param  alloc            My Pan doc
+ * @param  begin            My Pan doc
+ * @param  pos              My Pan doc
+ * @param  end              My Pan doc
+ * @param  n                My Pan doc
+ * @param  new_begin        My Pan doc
+ * @return T*               新空间中元素的尾部
+ * */
+template <class Alloc, class T, class Tag>
+T* vector_relocate_around(Alloc& alloc,
+                          T*     begin,
+                          T*     pos,
+                          T*     end,
+                          size_t n,
+                          T*     new_begin,
+                          Tag    tag) {
+  T* new_pos = new_begin + (pos - begin);
+  T* new_end = new_pos + n;
+  try {
+    Mystl::vector_transfer(begin, pos, new_begin, tag);
+    try {
+      new_end = Mystl::vector_transfer(pos, end, new_end, tag);
+    } catch (...) {
+      alloc.destroy(new_begin, new_pos);
+      throw;
+    }
+  } catch (...) {
+    // 只有逐个移动时会失败, 此时原元素仍在旧空间中
+    alloc.destroy(new_pos, new_pos + n);
+    throw;
+  }
+  return new_end;
+}
+
+/**
+ * @brief 备用空间足够时在 pos 处构造元素: 先构造临时对象, 再把尾部按字节
+ *        后移一位, 最后把临时对象移入空位; 失败时把尾部移回
+ * */
+template <class Alloc, class T, class... Args>
+void vector_emplace_in_place(Alloc& alloc,
+                             T*     pos,
+                             T*&    end,
+                             m_true_type,
+                             Args&&... args) {
+  T tmp(Mystl::forward<Args>(args)...);
+  Mystl::uninitialized_relocate(pos, end, pos + 1);
+  try {
+    alloc.construct(Mystl::address_of(*pos), Mystl::move(tmp));
+  } catch (...) {
+    Mystl::uninitialized_relocate(pos + 1, end + 1, pos);
+    throw;
+  }
+  ++end;
+}
+
+template <class Alloc, class T, class... Args>
+void vector_emplace_in_place(Alloc& alloc,
+                             T*     pos,
+                             T*&    end,
+                             m_false_type,
+                             Args&&... args) {
+  T tmp(Mystl::forward<Args>(args)...);
+  alloc.construct(Mystl::address_of(*end), Mystl::move(*(end - 1)));
+  ++end;
+  Mystl::move_backward(pos, end - 2, end - 1);
+  *pos = Mystl::move(tmp);
+}
+
+// 尾部按字节后移 n 位, 在空位中构造; 构造失败时把尾部移回
+template <class Alloc, class T>
+void vector_fill_in_place(Alloc&,
+                          T*       pos,
+                          T*&      end,
+                          size_t   n,
+                          const T& value,
+                          m_true_type) {
+  Mystl::uninitialized_relocate(pos, end, pos + n);
+  try {
+    Mystl::uninitialized_fill_n(pos, n, value);
+  } catch (...) {
+    Mystl::uninitialized_relocate(pos + n, end + n, pos);
+    throw;
+  }
+  end += n;
+}
+
+template <class Alloc, class T>
+void vector_fill_in_place(Alloc&,
+                          T*       pos,
+                          T*&      end,
+                          size_t   n,
+                          const T& value,
+                          m_false_type) {
+  const size_t after_elems = end - pos;
+  T*           old_end     = end;
+  if (after_elems > n) {
+    end = Mystl::uninitialized_move(old_end - n, old_end, old_end);
+    Mystl::move_backward(pos, old_end - n, old_end);
+    Mystl::fill_n(pos, n, value);
+  } else {
+    end = Mystl::uninitialized_fill_n(old_end, n - after_elems, value);
+    end = Mystl::uninitialized_move(pos, old_end, end);
+    Mystl::fill(pos, old_end, value);
+  }
+}
+
+// 尾部按字节后移 n 位, 在空位中复制; 复制失败时把尾部移回
+template <class Alloc, class T, class FIter>
+void vector_copy_in_place(Alloc&,
+                          T*     pos,
+                          T*&    end,
+                          FIter  first,
+                          FIter  last,
+                          size_t n,
+                          m_true_type) {
+  Mystl::uninitialized_relocate(pos, end, pos + n);
+  try {
+    Mystl::uninitialized_copy(first, last, pos);
+  } catch (...) {
+    Mystl::uninitialized_relocate(pos + n, end + n, pos);
+    throw;
+  }
+  end += n;
+}
+
+// [first, last) 有 n 个元素, 需要遍历两次, 因此至少是前向迭代器
+template <class Alloc, class T, class FIter>
+void vector_copy_in_place(Alloc&,
+                          T*     pos,
+                          T*&    end,
+                          FIter  first,
+                          FIter  last,
+                          size_t n,
+                          m_false_type) {
+  const size_t after_elems = end - pos;
+  T*           old_end     = end;
+  if (after_elems > n) {
+    end = Mystl::uninitialized_move(old_end - n, old_end, old_end);
+    Mystl::move_backward(pos, old_end - n, old_end);
+    Mystl::copy(first, last, pos);
+  } else {
+    auto mid = first;
+    Mystl::advance(mid, after_elems);
+    end = Mystl::uninitialized_copy(mid, last, old_end);
+    end = Mystl::uninitialized_move(pos, old_end, end);
+    Mystl::copy(first, mid, pos);
+  }
+}
+
+// 销毁被删除的元素, 再把尾部整体按字节前移
+template <class Alloc, class T>
+void vector_erase_shift(Alloc& alloc, T* first, T* last, T*& end, m_true_type) {
+  alloc.destroy(first, last);
+  Mystl::uninitialized_relocate(last, end, first);
+  end -= last - first;
+}
+
+// 把尾部移动赋值到前面, 再销毁多出的元素
+template <class Alloc, class T>
+void vector_erase_shift(Alloc& alloc,
+                        T*     first,
+                        T*     last,
+                        T*&    end,
+                        m_false_type) {
+  alloc.destroy(Mystl::move(last, end, first), end);
+  end -= last - first;
+}
+
+}  // namespace Mystl
+
+#endif /* __VECTOR_OPS_H__ */
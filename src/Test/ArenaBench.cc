@@ -0,0 +1,107 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file ArenaBench.cc
+ * @brief 模拟请求处理: 每个请求构建若干 vector 与 list, 请求结束时整体
+ *        丢弃。对比默认 allocator、由 arena_scope 安装的 monotonic_arena
+ *        以及以栈上缓冲区开头的 arena
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-14 15:05:20
+ *
+ * */
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include "../STL/allocator.h"
+#include "../STL/arena.h"
+#include "../STL/list.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const int REQUESTS = 200000;
+const int ITEMS    = 64;  // 每个请求中每个容器的元素个数
+const int BUFFER   = 64 * 1024;
+
+/**
+ * @brief 处理一个请求: 逐个追加构建 vector 与 list, 再遍历求和。容器以
+ *        默认构造的 Alloc 创建, arena_allocator 因此绑定当前线程的 arena
+ * @tparam Alloc
+ * @param  r                请求序号
+ * @return long
+ * */
+template <template <class> class Alloc>
+long HandleRequest(int r) {
+  Mystl::vector<long, Alloc<long>>     ids;
+  Mystl::vector<double, Alloc<double>> prices;
+  Mystl::list<long, Alloc<long>>       pending;
+  for (int i = 0; i < ITEMS; ++i) {
+    ids.push_back(r + i);
+    prices.push_back(i * 0.5);
+    if (i % 2 == 0) {
+      pending.push_back(i);
+    }
+  }
+
+  long sum = 0;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    sum += ids[i] + static_cast<long>(prices[i]);
+  }
+  for (auto it = pending.begin(); it != pending.end(); ++it) {
+    sum += *it;
+  }
+  return sum;
+}
+
+void TestAllocator() {
+  std::cout << "Test requests with allocator" << std::endl;
+
+  long    sum       = 0;
+  clock_t timeStart = std::clock();
+  for (int r = 0; r < REQUESTS; ++r) {
+    sum += HandleRequest<Mystl::allocator>(r);
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+
+// buffer 不为空时 arena 先使用栈上的缓冲区, 请求结束后 release() 不需要
+// 归还任何 chunk
+void TestArena(bool buffer) {
+  std::cout << "Test requests with arena_allocator"
+            << (buffer ? " and a stack buffer" : "") << std::endl;
+
+  char                   stack[BUFFER];
+  Mystl::monotonic_arena heap_arena(BUFFER);
+  Mystl::monotonic_arena buffer_arena(stack, sizeof(stack));
+
+  Mystl::monotonic_arena &arena = buffer ? buffer_arena : heap_arena;
+
+  long    sum       = 0;
+  size_t  reserved  = 0;
+  clock_t timeStart = std::clock();
+  for (int r = 0; r < REQUESTS; ++r) {
+    {
+      Mystl::arena_scope scope(arena);
+      sum += HandleRequest<Mystl::arena_allocator>(r);
+    }
+    reserved += arena.bytes_reserved();
+    arena.release();
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+  std::cout << "heap bytes per request : " << reserved / REQUESTS
+            << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestAllocator();
+  TestSTL::TestArena(false);
+  TestSTL::TestArena(true);
+}
@@ -0,0 +1,76 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file DynamicBitsetBench.cc
+ * @brief 过滤掩码的合并与计数性能测试, 对比 vector<char> 与
+ *        dynamic_bitset
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-22 18:05:20
+ *
+ * */
+
+#include <ctime>
+#include <iostream>
+
+#include "../STL/dynamic_bitset.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const size_t ROWS   = 64 * 1024 * 1024;
+const int    ROUNDS = 20;
+
+// 两个过滤条件的掩码求交后统计命中的行数
+void TestCharMask() {
+  std::cout << "Test vector<char>" << std::endl;
+
+  Mystl::vector<char> lhs(ROWS), rhs(ROWS);
+  for (size_t i = 0; i < ROWS; ++i) {
+    lhs[i] = i % 3 == 0;
+    rhs[i] = i % 5 != 0;
+  }
+
+  size_t  hits      = 0;
+  clock_t timeStart = std::clock();
+  for (int round = 0; round < ROUNDS; ++round) {
+    Mystl::vector<char> mask(lhs);
+    for (size_t i = 0; i < ROWS; ++i) {
+      mask[i] &= rhs[i];
+    }
+    for (size_t i = 0; i < ROWS; ++i) {
+      hits += mask[i];
+    }
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "hits : " << hits << " bytes : " << lhs.size() << std::endl;
+}
+
+void TestBitset() {
+  std::cout << "Test dynamic_bitset" << std::endl;
+
+  Mystl::dynamic_bitset lhs(ROWS), rhs(ROWS);
+  for (size_t i = 0; i < ROWS; ++i) {
+    lhs[i] = i % 3 == 0;
+    rhs[i] = i % 5 != 0;
+  }
+
+  size_t  hits      = 0;
+  clock_t timeStart = std::clock();
+  for (int round = 0; round < ROUNDS; ++round) {
+    Mystl::dynamic_bitset mask(lhs);
+    mask &= rhs;
+    hits += mask.count();
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "hits : " << hits << " bytes : " << lhs.num_words() * 8
+            << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestCharMask();
+  TestSTL::TestBitset();
+}
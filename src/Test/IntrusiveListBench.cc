@@ -0,0 +1,115 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file IntrusiveListBench.cc
+ * @brief LRU 缓存负载下 list 与 intrusive_list 的对比: list 每次未命中都
+ *        要申请节点并复制对象, intrusive_list 直接复用对象池中被淘汰的对象
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-25 11:05:43
+ *
+ * */
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include "../STL/intrusive_list.h"
+#include "../STL/list.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const long CAPACITY = 100000;  // 缓存容量
+const long KEYS     = 400000;  // 键的取值范围
+const long ACCESSES = 20000000;
+
+struct Entry : public Mystl::intrusive_list_hook<> {
+  long key;
+  char payload[48];
+
+  Entry() : key(-1), payload() {
+  }
+
+  explicit Entry(long k) : key(k), payload() {
+    payload[0] = static_cast<char>(k);
+  }
+};
+
+// 访问序列: 一半落在热点键上, 命中率约 60%
+void MakeKeys(Mystl::vector<long> &keys) {
+  std::srand(1);
+  for (long i = 0; i < ACCESSES; ++i) {
+    keys.push_back(i % 2 == 0 ? std::rand() % (CAPACITY / 2)
+                              : std::rand() % KEYS);
+  }
+}
+
+void TestList(const Mystl::vector<long> &keys) {
+  std::cout << "Test list<Entry>" << std::endl;
+
+  typedef Mystl::list<Entry> lru_list;
+  lru_list                   lru;
+  // 键到链表中位置的索引
+  Mystl::vector<lru_list::iterator> index(KEYS, lru.end());
+  long                              hits      = 0;
+  clock_t                           timeStart = std::clock();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const long key = keys[i];
+    if (index[key] != lru.end()) {
+      lru.splice(lru.begin(), lru, index[key]);
+      ++hits;
+      continue;
+    }
+    if (static_cast<long>(lru.size()) == CAPACITY) {
+      index[lru.back().key] = lru.end();
+      lru.pop_back();
+    }
+    lru.push_front(Entry(key));
+    index[key] = lru.begin();
+  }
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "hits : " << hits << std::endl;
+}
+
+void TestIntrusive(const Mystl::vector<long> &keys) {
+  std::cout << "Test intrusive_list<Entry>" << std::endl;
+
+  Mystl::vector<Entry>         pool(CAPACITY);
+  Mystl::intrusive_list<Entry> lru;
+  Mystl::vector<Entry *>       index(KEYS, nullptr);
+  long                         used      = 0;
+  long                         hits      = 0;
+  clock_t                      timeStart = std::clock();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const long key = keys[i];
+    if (index[key] != nullptr) {
+      lru.splice(lru.begin(), lru, lru.iterator_to(*index[key]));
+      ++hits;
+      continue;
+    }
+    Entry *e = nullptr;
+    if (used < CAPACITY) {
+      e = &pool[used++];
+    } else {
+      e = &lru.back();
+      lru.pop_back();
+      index[e->key] = nullptr;
+    }
+    e->key        = key;
+    e->payload[0] = static_cast<char>(key);
+    lru.push_front(*e);
+    index[key] = e;
+  }
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "hits : " << hits << std::endl;
+  lru.clear();
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  Mystl::vector<long> keys;
+  TestSTL::MakeKeys(keys);
+  TestSTL::TestList(keys);
+  TestSTL::TestIntrusive(keys);
+}
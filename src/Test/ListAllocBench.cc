@@ -0,0 +1,106 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file ListAllocBench.cc
+ * @brief list 节点分配与遍历性能测试, 分别以默认 allocator、
+ *        MYSTL_USE_POOL_ALLOC 与 MYSTL_USE_SLAB_ALLOC 编译后对比, 并与
+ *        reserve_nodes 后复用缓存节点对比; 以 MYSTL_ALLOC_STATS 编译时
+ *        输出分配统计
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-12 14:05:10
+ *
+ * */
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include "../STL/list.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const int ROUNDS = 50;
+const int NODES  = 100000;
+const int SCANS  = 200;
+
+const char *AllocName() {
+#if defined(MYSTL_USE_SLAB_ALLOC)
+  return "slab_allocator";
+#elif defined(MYSTL_USE_POOL_ALLOC)
+  return "pool_allocator";
+#else
+  return "allocator";
+#endif  // MYSTL_USE_SLAB_ALLOC
+}
+
+// reserve 为 true 时先保留 NODES 个节点, 之后的删除与插入只在缓存中周转
+void TestListAlloc(bool reserve) {
+  std::cout << "Test list with " << AllocName()
+            << (reserve ? " and reserve_nodes" : "") << std::endl;
+
+  Mystl::list<long> l;
+  long              sum       = 0;
+  clock_t           timeStart = std::clock();
+  if (reserve) {
+    l.reserve_nodes(NODES);
+  }
+
+  for (int r = 0; r < ROUNDS; ++r) {
+    for (int i = 0; i < NODES; ++i) {
+      l.push_back(i);
+    }
+    // 删除一半节点, 再插回去, 模拟节点的反复申请与释放
+    auto it = l.begin();
+    while (it != l.end()) {
+      it = l.erase(it);
+      if (it != l.end()) ++it;
+    }
+    for (int i = 0; i < NODES / 2; ++i) {
+      l.push_front(i);
+    }
+    sum += static_cast<long>(l.size());
+    l.clear();
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "list nodes : " << sum << std::endl;
+}
+// 建表时穿插其他大小相近的堆分配, 再反复遍历, 观察节点的局部性
+void TestListTraverse() {
+  std::cout << "Traverse list with " << AllocName() << std::endl;
+
+  Mystl::list<long>     l;
+  Mystl::vector<char *> noise;
+  for (int i = 0; i < NODES; ++i) {
+    l.push_back(i);
+    noise.push_back(new char[24 + i % 4 * 8]);
+  }
+
+  long    sum       = 0;
+  clock_t timeStart = std::clock();
+  for (int r = 0; r < SCANS; ++r) {
+    for (auto it = l.begin(); it != l.end(); ++it) {
+      sum += *it;
+    }
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+
+  for (size_t i = 0; i < noise.size(); ++i) {
+    delete[] noise[i];
+  }
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  // 先遍历新建的 list, 避免前面的节点反复申请释放打乱自由链表
+  TestSTL::TestListTraverse();
+  TestSTL::TestListAlloc(false);
+  TestSTL::TestListAlloc(true);
+#ifdef MYSTL_ALLOC_STATS
+  Mystl::dump_alloc_stats(std::cout);
+#endif  // MYSTL_ALLOC_STATS
+}
@@ -0,0 +1,169 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file ListSortBench.cc
+ * @brief list::sort 在随机、有序、逆序与基本有序输入下的耗时; 以
+ *        MYSTL_LIST_MERGE_SORT_ONLY 编译后对比复制到连续缓冲区排序与直接
+ *        在链表上归并。每个用例都检查结果有序、稳定且没有丢失节点, 出错时
+ *        以非零状态退出
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-24 10:05:18
+ *
+ * */
+
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif  // __linux__
+
+#include "../STL/list.h"
+
+namespace TestSTL {
+const long NODES = 10000000;
+
+enum Order { RANDOM, SORTED, REVERSED, NEARLY_SORTED };
+
+// 排序键与插入序号, 只按键比较, 用序号检查稳定性; 16 字节且可平凡复制,
+// 会走复制到缓冲区排序的路径
+struct Item {
+  long key;
+  long seq;
+};
+
+bool operator<(const Item &lhs, const Item &rhs) {
+  return lhs.key < rhs.key;
+}
+
+const char *SortName() {
+#if defined(MYSTL_LIST_MERGE_SORT_ONLY)
+  return "list merge sort";
+#else
+  return "copy-out sort";
+#endif  // MYSTL_LIST_MERGE_SORT_ONLY
+}
+
+const char *OrderName(Order order) {
+  switch (order) {
+    case RANDOM:
+      return "random";
+    case SORTED:
+      return "sorted";
+    case REVERSED:
+      return "reversed";
+    default:
+      return "nearly sorted";
+  }
+}
+
+// 基本有序: 每 1000 个元素中有一个随机值
+long Key(Order order, long i) {
+  switch (order) {
+    case RANDOM:
+      return std::rand();
+    case SORTED:
+      return i;
+    case REVERSED:
+      return NODES - i;
+    default:
+      return i % 1000 == 0 ? std::rand() % NODES : i;
+  }
+}
+
+void Fail(const char *what, long pos) {
+  std::cerr << "FAILED: " << what << " at node " << pos << std::endl;
+  std::exit(EXIT_FAILURE);
+}
+
+// 按键非降序, 键相等时序号递增, 且每个序号恰好出现一次
+void CheckSorted(const Mystl::list<Item> &l) {
+  if (static_cast<long>(l.size()) != NODES) {
+    Fail("size changed", static_cast<long>(l.size()));
+  }
+  std::vector<char> seen(NODES, 0);
+  const Item       *prev = nullptr;
+  long              pos  = 0;
+  for (auto it = l.begin(); it != l.end(); ++it, ++pos) {
+    if (it->seq < 0 || it->seq >= NODES || seen[it->seq]) {
+      Fail("node lost or duplicated", pos);
+    }
+    seen[it->seq] = 1;
+    if (prev != nullptr) {
+      if (it->key < prev->key) {
+        Fail("not sorted", pos);
+      }
+      if (it->key == prev->key && it->seq < prev->seq) {
+        Fail("not stable", pos);
+      }
+    }
+    prev = &*it;
+  }
+}
+
+#if defined(__linux__)
+// 把地址空间限制在当前用量之上 extra 字节, 使排序申请不到足够的缓冲区;
+// 原来的限制保存在 old 中
+bool LimitAddressSpace(size_t extra, struct rlimit *old) {
+  std::ifstream statm("/proc/self/statm");
+  size_t        pages = 0;
+  if (!(statm >> pages) || ::getrlimit(RLIMIT_AS, old) != 0) {
+    return false;
+  }
+  struct rlimit limit = *old;
+  limit.rlim_cur      = pages * ::sysconf(_SC_PAGESIZE) + extra;
+  return limit.rlim_cur < old->rlim_cur && ::setrlimit(RLIMIT_AS, &limit) == 0;
+}
+#endif  // __linux__
+
+// short_buffer 为 true 时限制地址空间, 检查复制排序退回链表归并的路径
+void TestSort(Order order, bool short_buffer = false) {
+  std::cout << "Test " << SortName() << " " << OrderName(order)
+            << (short_buffer ? " (buffer too short)" : "") << std::endl;
+
+  std::srand(1);
+  Mystl::list<Item> l;
+  for (long i = 0; i < NODES; ++i) {
+    l.push_back(Item{Key(order, i), i});
+  }
+
+#if defined(__linux__)
+  struct rlimit old;
+  if (short_buffer && !LimitAddressSpace(64 * 1024 * 1024, &old)) {
+    std::cout << "skipped: can not limit address space" << std::endl;
+    return;
+  }
+#endif  // __linux__
+
+  clock_t timeStart = std::clock();
+  l.sort();
+  clock_t timeEnd = std::clock();
+
+#if defined(__linux__)
+  if (short_buffer) {
+    ::setrlimit(RLIMIT_AS, &old);
+  }
+#endif  // __linux__
+
+  std::cout << "Milli-seconds : "
+            << (timeEnd - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  CheckSorted(l);
+  std::cout << "front / back : " << l.front().key << " / " << l.back().key
+            << std::endl;
+}
+}  // namespace TestSTL
+
+// 随机输入排序后释放的节点地址是打乱的, 放在最后以免影响其他用例的布局
+int main(int argc, char **argv) {
+  TestSTL::TestSort(TestSTL::SORTED);
+  TestSTL::TestSort(TestSTL::REVERSED);
+  TestSTL::TestSort(TestSTL::NEARLY_SORTED);
+  TestSTL::TestSort(TestSTL::RANDOM);
+#if !defined(MYSTL_LIST_MERGE_SORT_ONLY) && defined(__linux__)
+  TestSTL::TestSort(TestSTL::RANDOM, true);
+#endif  // !MYSTL_LIST_MERGE_SORT_ONLY && __linux__
+}
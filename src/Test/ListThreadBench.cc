@@ -0,0 +1,79 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file ListThreadBench.cc
+ * @brief 多线程 list 节点分配压力测试, 每轮每个线程构建一个 list,
+ *        随后由下一个线程负责销毁, 使节点跨线程释放
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-13 15:05:02
+ *
+ * */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../STL/list.h"
+
+namespace TestSTL {
+const int ROUNDS = 20;
+const int NODES  = 100000;
+
+void RunRounds(int nthreads) {
+  std::vector<Mystl::list<long>> lists(nthreads);
+
+  auto timeStart = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; ++r) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < nthreads; ++t) {
+      workers.emplace_back([&lists, t]() {
+        for (int i = 0; i < NODES; ++i) {
+          lists[t].push_back(i);
+        }
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+
+    workers.clear();
+    for (int t = 0; t < nthreads; ++t) {
+      workers.emplace_back([&lists, t, nthreads]() {
+        lists[(t + 1) % nthreads].clear();
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+  }
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - timeStart)
+                .count();
+
+  std::cout << "threads : " << nthreads << " Milli-seconds : " << ms
+            << " nodes/ms : "
+            << (ms > 0 ? static_cast<long>(nthreads) * ROUNDS * NODES / ms : 0)
+            << std::endl;
+}
+
+void TestListThread(int maxThreads) {
+#if defined(MYSTL_USE_THREAD_ALLOC)
+  std::cout << "Test list with thread_alloc" << std::endl;
+#elif defined(MYSTL_USE_POOL_ALLOC)
+  std::cout << "Test list with alloc" << std::endl;
+#else
+  std::cout << "Test list with allocator" << std::endl;
+#endif  // MYSTL_USE_THREAD_ALLOC
+
+  for (int n = 1; n <= maxThreads; n *= 2) {
+    RunRounds(n);
+  }
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  int maxThreads = argc > 1 ? std::atoi(argv[1]) : 8;
+  TestSTL::TestListThread(maxThreads > 0 ? maxThreads : 1);
+}
@@ -0,0 +1,90 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file MappedVectorBench.cc
+ * @brief 服务启动时加载查找表的耗时, 对比解析文本文件装入 vector 与只读
+ *        打开 mapped_vector
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-23 16:05:40
+ *
+ * */
+
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+
+#include "../STL/mapped_vector.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const long  ROWS      = 20000000;
+const char *TEXT_FILE = "mapped_vector_bench.txt";
+const char *DATA_FILE = "mapped_vector_bench.dat";
+
+struct Record {
+  long   id;
+  double price;
+};
+
+void WriteFiles() {
+  std::FILE                    *text = std::fopen(TEXT_FILE, "w");
+  Mystl::mapped_vector<Record> data(DATA_FILE, Mystl::mapped_truncate);
+  for (long i = 0; i < ROWS; ++i) {
+    Record r = {i, 0.25 * i};
+    std::fprintf(text, "%ld %.17g\n", r.id, r.price);
+    data.push_back(r);
+  }
+  std::fclose(text);
+  data.flush();
+}
+
+void TestParse() {
+  std::cout << "Test parse text into vector" << std::endl;
+
+  clock_t                timeStart = std::clock();
+  Mystl::vector<Record> rows;
+  std::FILE            *text = std::fopen(TEXT_FILE, "r");
+  Record                r;
+  while (std::fscanf(text, "%ld %lf", &r.id, &r.price) == 2) {
+    rows.push_back(r);
+  }
+  std::fclose(text);
+
+  double sum = 0;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    sum += rows[i].price;
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "rows / sum : " << rows.size() << " / " << sum << std::endl;
+}
+
+void TestMapped() {
+  std::cout << "Test open mapped_vector read-only" << std::endl;
+
+  // 只读映射只能通过 const 访问元素
+  clock_t                            timeStart = std::clock();
+  const Mystl::mapped_vector<Record> rows(DATA_FILE, Mystl::mapped_read_only);
+  clock_t                            opened    = std::clock();
+
+  double sum = 0;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    sum += rows[i].price;
+  }
+
+  std::cout << "open Milli-seconds : "
+            << (opened - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "rows / sum : " << rows.size() << " / " << sum << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::WriteFiles();
+  TestSTL::TestParse();
+  TestSTL::TestMapped();
+  std::remove(TestSTL::TEXT_FILE);
+  std::remove(TestSTL::DATA_FILE);
+}
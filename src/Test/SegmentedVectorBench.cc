@@ -0,0 +1,80 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file SegmentedVectorBench.cc
+ * @brief 不预留空间连续追加大量元素, 对比 vector 与 segmented_vector 的
+ *        耗时和内存峰值
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-23 11:05:48
+ *
+ * */
+
+#include <ctime>
+#include <iostream>
+
+#include "../STL/alloc_stats.h"
+#include "../STL/segmented_vector.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const long ELEMENTS = 100000000;
+
+struct Record {
+  long   id;
+  double price;
+};
+
+struct VectorTag {
+  static const char *name() {
+    return "vector";
+  }
+};
+
+struct SegmentedTag {
+  static const char *name() {
+    return "segmented_vector";
+  }
+};
+
+template <class Container, class Stats>
+void TestAppend(const char *name) {
+  std::cout << "Test " << name << std::endl;
+
+  clock_t timeStart = std::clock();
+  {
+    Container c;
+    for (long i = 0; i < ELEMENTS; ++i) {
+      c.push_back(Record{i, 0.5 * i});
+    }
+    double sum = 0;
+    for (long i = 0; i < ELEMENTS; i += 4096) {
+      sum += c[i].price;
+    }
+    std::cout << "sum : " << sum << std::endl;
+  }
+
+  const size_t used = ELEMENTS * sizeof(Record);
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "allocations : " << Stats::stats().allocs.load() << std::endl;
+  std::cout << "used / peak MiB : " << used / (1024 * 1024) << " / "
+            << Stats::stats().peak_bytes.load() / (1024 * 1024) << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  using TestSTL::Record;
+  typedef Mystl::instrumented_allocator<Mystl::allocator<Record>,
+                                        TestSTL::VectorTag>
+      vector_alloc;
+  typedef Mystl::instrumented_allocator<Mystl::allocator<Record>,
+                                        TestSTL::SegmentedTag>
+      segmented_alloc;
+  typedef Mystl::segment_default_size<Record> chunk;
+
+  TestSTL::TestAppend<Mystl::vector<Record, vector_alloc>, vector_alloc>(
+      "vector");
+  TestSTL::TestAppend<
+      Mystl::segmented_vector<Record, chunk::value, segmented_alloc>,
+      segmented_alloc>("segmented_vector");
+}
@@ -0,0 +1,69 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file SmallVectorBench.cc
+ * @brief 大量短小 vector 的构造与销毁性能测试, 对比 vector、small_vector
+ *        与 static_vector
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-19 16:05:48
+ *
+ * */
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include "../STL/small_vector.h"
+#include "../STL/static_vector.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const int LINES = 5000000;
+
+// 模拟解析器: 每行切出 1 ~ 8 个字段, 处理后丢弃
+template <class Fields>
+void TestShortLived(const char *name) {
+  std::cout << "Test " << name << std::endl;
+
+  long    sum       = 0;
+  clock_t timeStart = std::clock();
+  for (int line = 0; line < LINES; ++line) {
+    Fields fields;
+    for (int i = 0; i <= line % 8; ++i) {
+      fields.push_back(line + i);
+    }
+    sum += fields.back() - fields.front();
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+
+// 字段数不超过容量, 跳过容量检查
+void TestUnchecked() {
+  std::cout << "Test static_vector<int, 8> push_back_unchecked" << std::endl;
+
+  long    sum       = 0;
+  clock_t timeStart = std::clock();
+  for (int line = 0; line < LINES; ++line) {
+    Mystl::static_vector<int, 8> fields;
+    for (int i = 0; i <= line % 8; ++i) {
+      fields.push_back_unchecked(line + i);
+    }
+    sum += fields.back() - fields.front();
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestShortLived<Mystl::vector<int>>("vector<int>");
+  TestSTL::TestShortLived<Mystl::small_vector<int, 8>>("small_vector<int, 8>");
+  TestSTL::TestShortLived<Mystl::static_vector<int, 8>>(
+      "static_vector<int, 8>");
+  TestSTL::TestUnchecked();
+}
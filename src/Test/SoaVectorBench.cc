@@ -0,0 +1,84 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file SoaVectorBench.cc
+ * @brief 只访问一个字段的扫描性能测试, 对比按行存储的 vector 与按列
+ *        存储的 soa_vector
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-22 14:05:06
+ *
+ * */
+
+#include <array>
+#include <ctime>
+#include <iostream>
+
+#include "../STL/soa_vector.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const int ROWS  = 4000000;
+const int SCANS = 20;
+
+typedef std::array<char, 40> Tag;
+
+// 64 字节的记录, 扫描只读取 price
+struct Record {
+  long   id;
+  double price;
+  int    qty;
+  int    flags;
+  Tag    tag;
+};
+
+void TestRows() {
+  std::cout << "Test vector<Record>" << std::endl;
+
+  Mystl::vector<Record> rows;
+  rows.reserve(ROWS);
+  for (int i = 0; i < ROWS; ++i) {
+    Record r = {i, i * 0.25, i % 100, 0, Tag()};
+    rows.push_back(r);
+  }
+
+  double  sum       = 0;
+  clock_t timeStart = std::clock();
+  for (int scan = 0; scan < SCANS; ++scan) {
+    for (size_t i = 0; i < rows.size(); ++i) {
+      sum += rows[i].price;
+    }
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+
+void TestColumns() {
+  std::cout << "Test soa_vector column<1>()" << std::endl;
+
+  Mystl::soa_vector<long, double, int, int, Tag> rows;
+  rows.reserve(ROWS);
+  for (int i = 0; i < ROWS; ++i) {
+    rows.emplace_back(i, i * 0.25, i % 100, 0, Tag());
+  }
+
+  double  sum       = 0;
+  clock_t timeStart = std::clock();
+  for (int scan = 0; scan < SCANS; ++scan) {
+    const auto prices = rows.column<1>();
+    for (size_t i = 0; i < prices.size(); ++i) {
+      sum += prices[i];
+    }
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestRows();
+  TestSTL::TestColumns();
+}
@@ -0,0 +1,68 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file UnrolledListBench.cc
+ * @brief 队列式负载下 list 与 unrolled_list 的对比: 尾部追加、反复扫描、
+ *        偶尔在中间删除, 最后从头部逐个弹出
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-24 17:05:09
+ *
+ * */
+
+#include <ctime>
+#include <iostream>
+
+#include "../STL/list.h"
+#include "../STL/unrolled_list.h"
+
+namespace TestSTL {
+const long NODES = 5000000;
+const int  SCANS = 20;
+const int  GAP   = 100;  // 每隔 GAP 个元素删除一个
+
+template <class Container>
+void TestQueue(const char *name) {
+  std::cout << "Test " << name << std::endl;
+
+  Container c;
+  long      sum       = 0;
+  clock_t   timeStart = std::clock();
+  for (long i = 0; i < NODES; ++i) {
+    c.push_back(i);
+  }
+  clock_t pushed = std::clock();
+
+  for (int scan = 0; scan < SCANS; ++scan) {
+    for (auto it = c.begin(); it != c.end(); ++it) {
+      sum += *it;
+    }
+  }
+  clock_t scanned = std::clock();
+
+  long n = 0;
+  for (auto it = c.begin(); it != c.end(); ++n) {
+    it = n % GAP == 0 ? c.erase(it) : ++it;
+  }
+  clock_t erased = std::clock();
+
+  while (!c.empty()) {
+    sum -= c.front();
+    c.pop_front();
+  }
+  clock_t popped = std::clock();
+
+  std::cout << "push_back / scan / erase / pop_front Milli-seconds : "
+            << (pushed - timeStart) * 1000 / CLOCKS_PER_SEC << " / "
+            << (scanned - pushed) * 1000 / CLOCKS_PER_SEC << " / "
+            << (erased - scanned) * 1000 / CLOCKS_PER_SEC << " / "
+            << (popped - erased) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "Milli-seconds : "
+            << (popped - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestQueue<Mystl::list<long>>("list<long>");
+  TestSTL::TestQueue<Mystl::unrolled_list<long>>("unrolled_list<long>");
+}
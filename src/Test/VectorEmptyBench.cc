@@ -0,0 +1,80 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file VectorEmptyBench.cc
+ * @brief 构建大量各含两个基本为空的 vector 的记录, 统计耗时与峰值内存;
+ *        以 VECTOR_EAGER_INIT 编译后每个 vector 构造时即预留
+ *        VECTOR_INIT_CAP 个元素, 对比默认构造不申请空间的做法
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-21 10:05:48
+ *
+ * */
+
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const long RECORDS = 10000000;
+
+struct Record {
+  long               id;
+  Mystl::vector<int> tags;
+  Mystl::vector<int> refs;
+
+  explicit Record(long i) : id(i) {
+#if defined(VECTOR_EAGER_INIT)
+    tags.reserve(Mystl::VECTOR_INIT_CAP);
+    refs.reserve(Mystl::VECTOR_INIT_CAP);
+#endif  // VECTOR_EAGER_INIT
+  }
+};
+
+// 读取本进程的峰值常驻内存
+long PeakRssKB() {
+  std::ifstream status("/proc/self/status");
+  std::string   key;
+  long          value = 0;
+  while (status >> key) {
+    if (key == "VmHWM:") {
+      status >> value;
+      return value;
+    }
+  }
+  return -1;
+}
+
+void TestEmptyVectors() {
+#if defined(VECTOR_EAGER_INIT)
+  std::cout << "Test records with eagerly reserved vectors" << std::endl;
+#else
+  std::cout << "Test records with empty vectors" << std::endl;
+#endif  // VECTOR_EAGER_INIT
+
+  clock_t               timeStart = std::clock();
+  Mystl::vector<Record> records;
+  records.reserve(RECORDS);
+  long tagged = 0;
+  for (long i = 0; i < RECORDS; ++i) {
+    records.emplace_back(i);
+    // 每 100 条记录中只有一条带标签
+    if (i % 100 == 0) {
+      records.back().tags.push_back(static_cast<int>(i));
+      ++tagged;
+    }
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "Peak RSS : " << PeakRssKB() / 1024 << " MB" << std::endl;
+  std::cout << "records / tagged : " << records.size() << " / " << tagged
+            << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestEmptyVectors();
+}
@@ -0,0 +1,116 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file VectorGrowthBench.cc
+ * @brief 不同扩容策略下批量装载 vector 的分配次数、内存占用与耗时
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-20 15:05:02
+ *
+ * */
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif  // __GLIBC__
+
+#include "../STL/alloc_stats.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const int VECTORS = 20000;
+const int MAX_LEN = 2000;
+
+struct Record {
+  long   id;
+  double price;
+  int    qty;
+};
+
+// 每个策略一份分配统计, 以策略名区分
+template <class Growth>
+struct GrowthTag;
+
+template <>
+struct GrowthTag<Mystl::geometric_growth<3, 2>> {
+  static const char *name() {
+    return "geometric_growth<3, 2>";
+  }
+};
+
+template <>
+struct GrowthTag<Mystl::geometric_growth<2, 1>> {
+  static const char *name() {
+    return "geometric_growth<2, 1>";
+  }
+};
+
+template <>
+struct GrowthTag<Mystl::power_of_two_growth> {
+  static const char *name() {
+    return "power_of_two_growth";
+  }
+};
+
+template <>
+struct GrowthTag<Mystl::size_class_growth> {
+  static const char *name() {
+    return "size_class_growth";
+  }
+};
+
+// malloc 实际为缓冲区保留的字节数, 无法查询时按申请的字节数计
+size_t UsableBytes(void *p, size_t requested) {
+#if defined(__GLIBC__)
+  if (p != nullptr) {
+    return malloc_usable_size(p);
+  }
+#endif  // __GLIBC__
+  return requested;
+}
+
+template <class Growth>
+void TestBulkLoad() {
+  typedef Mystl::instrumented_allocator<Mystl::allocator<Record>,
+                                        GrowthTag<Growth>>
+                                               alloc_type;
+  typedef Mystl::vector<Record, alloc_type, Growth> records;
+
+  std::cout << "Test " << GrowthTag<Growth>::name() << std::endl;
+
+  std::srand(1);
+  records *tables    = new records[VECTORS];
+  clock_t  timeStart = std::clock();
+  for (int i = 0; i < VECTORS; ++i) {
+    const int len = std::rand() % MAX_LEN + 1;
+    for (int j = 0; j < len; ++j) {
+      tables[i].push_back(Record{j, 1.0 * j, j});
+    }
+  }
+  clock_t ms = (clock() - timeStart) * 1000 / CLOCKS_PER_SEC;
+
+  size_t used = 0, reserved = 0, usable = 0;
+  for (int i = 0; i < VECTORS; ++i) {
+    used += tables[i].size() * sizeof(Record);
+    reserved += tables[i].capacity() * sizeof(Record);
+    usable += UsableBytes(tables[i].data(),
+                          tables[i].capacity() * sizeof(Record));
+  }
+
+  std::cout << "Milli-seconds : " << ms << std::endl;
+  std::cout << "allocations : " << alloc_type::stats().allocs.load()
+            << std::endl;
+  std::cout << "used / capacity / malloc KiB : " << used / 1024 << " / "
+            << reserved / 1024 << " / " << usable / 1024 << std::endl;
+  delete[] tables;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestBulkLoad<Mystl::geometric_growth<>>();
+  TestSTL::TestBulkLoad<Mystl::geometric_growth<2, 1>>();
+  TestSTL::TestBulkLoad<Mystl::power_of_two_growth>();
+  TestSTL::TestBulkLoad<Mystl::size_class_growth>();
+}
@@ -0,0 +1,72 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file VectorHugePageBench.cc
+ * @brief 大 vector 随机访问性能测试, 分别以默认 allocator 与
+ *        MYSTL_USE_HUGE_PAGES 编译后对比
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-16 14:05:27
+ *
+ * */
+
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const size_t ELEMS  = 64 * 1024 * 1024;  // 512 MiB 的 uint64_t
+const long   ACCESS = 50000000;
+
+// 读取本进程映射的透明大页总量
+long AnonHugePagesKB() {
+  std::ifstream smaps("/proc/self/smaps_rollup");
+  std::string   key;
+  long          value = 0;
+  while (smaps >> key) {
+    if (key == "AnonHugePages:") {
+      smaps >> value;
+      return value;
+    }
+  }
+  return -1;
+}
+
+void TestRandomAccess() {
+#ifdef MYSTL_USE_HUGE_PAGES
+  std::cout << "Random access with huge_page_allocator" << std::endl;
+#else
+  std::cout << "Random access with allocator" << std::endl;
+#endif  // MYSTL_USE_HUGE_PAGES
+
+  Mystl::vector<uint64_t> v(ELEMS, 0);
+  for (size_t i = 0; i < ELEMS; ++i) {
+    v[i] = i;
+  }
+  std::cout << "AnonHugePages : " << AnonHugePagesKB() << " kB" << std::endl;
+
+  uint64_t x         = 88172645463325252ULL;
+  uint64_t sum       = 0;
+  clock_t  timeStart = std::clock();
+  for (long i = 0; i < ACCESS; ++i) {
+    // xorshift 生成随机下标
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    sum += v[x & (ELEMS - 1)];
+  }
+  clock_t ms = (clock() - timeStart) * 1000 / CLOCKS_PER_SEC;
+
+  std::cout << "Milli-seconds : " << ms << std::endl;
+  std::cout << "accesses/ms : " << (ms > 0 ? ACCESS / ms : 0) << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestRandomAccess();
+}
@@ -0,0 +1,125 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file VectorIngestBench.cc
+ * @brief 输入缓冲区的性能测试: 大块缓冲区的值初始化与默认初始化,
+ *        以及日志批量追加时逐个 push_back 与 append_range 的对比
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-21 15:05:12
+ *
+ * */
+
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const size_t CHUNK  = 64 * 1024 * 1024;  // 每次读入 64 MiB
+const int    CHUNKS = 16;
+
+// 模拟 read(): 整块覆盖缓冲区
+void FakeRead(char *buf, size_t n, int seed) {
+  std::memset(buf, 'a' + seed % 26, n);
+}
+
+// 通过 volatile 指针调用, 防止编译器看穿读入而删去初始化
+void (*volatile Read)(char *, size_t, int) = FakeRead;
+
+// 值初始化: 先清零, 再被 read 覆盖
+void TestValueInit() {
+  std::cout << "Test vector<char>(n)" << std::endl;
+
+  long    sum       = 0;
+  clock_t timeStart = std::clock();
+  for (int i = 0; i < CHUNKS; ++i) {
+    Mystl::vector<char> buf(CHUNK);
+    Read(buf.data(), CHUNK, i);
+    sum += buf[CHUNK - 1];
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+
+void TestDefaultInit() {
+  std::cout << "Test vector<char>::resize_default_init" << std::endl;
+
+  long    sum       = 0;
+  clock_t timeStart = std::clock();
+  for (int i = 0; i < CHUNKS; ++i) {
+    Mystl::vector<char> buf;
+    buf.resize_default_init(CHUNK);
+    Read(buf.data(), CHUNK, i);
+    sum += buf[CHUNK - 1];
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+
+// 分块追加到同一个缓冲区
+void TestAppend() {
+  std::cout << "Test vector<char>::append_uninitialized" << std::endl;
+
+  clock_t             timeStart = std::clock();
+  Mystl::vector<char> buf;
+  for (int i = 0; i < CHUNKS / 4; ++i) {
+    Read(buf.append_uninitialized(CHUNK), CHUNK, i);
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "size : " << buf.size() << std::endl;
+}
+
+const int BATCHES = 2000000;
+
+// 每批追加 1 ~ 64 字节的日志记录
+template <class Append>
+void TestBatches(const char *name, Append append) {
+  std::cout << "Test " << name << std::endl;
+
+  char line[64];
+  for (int i = 0; i < 64; ++i) {
+    line[i] = 'a' + i % 26;
+  }
+
+  Mystl::vector<char> log;
+  size_t              reallocs  = 0;
+  clock_t             timeStart = std::clock();
+  for (int i = 0; i < BATCHES; ++i) {
+    const char *old = log.data();
+    append(log, line, line + 1 + i % 64);
+    reallocs += old != log.data();
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "size : " << log.size() << " reallocs : " << reallocs
+            << std::endl;
+}
+
+void PushBackEach(Mystl::vector<char> &log, const char *first,
+                  const char *last) {
+  for (; first != last; ++first) {
+    log.push_back(*first);
+  }
+}
+
+void AppendRange(Mystl::vector<char> &log, const char *first,
+                 const char *last) {
+  log.append_range(first, last);
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestValueInit();
+  TestSTL::TestDefaultInit();
+  TestSTL::TestAppend();
+  TestSTL::TestBatches("push_back each", TestSTL::PushBackEach);
+  TestSTL::TestBatches("append_range", TestSTL::AppendRange);
+}
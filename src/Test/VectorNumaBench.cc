@@ -0,0 +1,79 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file VectorNumaBench.cc
+ * @brief numa_allocator 的放置结果与 vector 并行初始化的性能测试,
+ *        在单节点机器上验证策略设置失败时可以正常退化
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-18 15:05:40
+ *
+ * */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "../STL/numa_alloc.h"
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const size_t ELEMS = 32 * 1024 * 1024;  // 256 MiB 的 double
+
+typedef Mystl::vector<double, Mystl::numa_allocator<double>> numa_vector;
+
+// 依次输出若干页所在的节点
+void PrintNodes(const char *name, const numa_vector &v) {
+  std::cout << name << " nodes :";
+  const size_t step = 4096 / sizeof(double);
+  for (size_t i = 0; i < 8 * step && i < v.size(); i += step) {
+    std::cout << ' ' << Mystl::numa_node_of(&v[i]);
+  }
+  std::cout << std::endl;
+}
+
+void TestPlacement() {
+  std::cout << "online nodes mask : " << Mystl::numa_online_nodes()
+            << std::endl;
+
+  numa_vector bound(ELEMS / 8, 1.0, Mystl::numa_policy::bind_to(0));
+  PrintNodes("bind 0", bound);
+
+  numa_vector interleaved(ELEMS / 8, 1.0,
+                          Mystl::numa_policy::interleave_all());
+  PrintNodes("interleave", interleaved);
+
+  // 不存在的节点: mbind 失败, 退化为 first-touch
+  numa_vector missing(ELEMS / 8, 1.0, Mystl::numa_policy::bind_to(63));
+  PrintNodes("bind 63", missing);
+}
+
+template <class F>
+long TimeMs(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void TestParallelInit() {
+  double sum    = 0;
+  long   serial = TimeMs([&sum]() {
+    Mystl::vector<double> v(ELEMS, 1.0);
+    sum += v[ELEMS - 1];
+  });
+  long parallel = TimeMs([&sum]() {
+    Mystl::vector<double> v(ELEMS, 1.0, Mystl::parallel_init);
+    sum += v[ELEMS - 1];
+  });
+
+  std::cout << "serial init Milli-seconds : " << serial << std::endl;
+  std::cout << "parallel init Milli-seconds : " << parallel << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestPlacement();
+  TestSTL::TestParallelInit();
+}
@@ -0,0 +1,59 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file VectorPushBackBench.cc
+ * @brief 逐个 push_back 装载大 vector<int> 的耗时, 对比 allocator 提供
+ *        reallocate (大块由 realloc / mremap 扩大, 不复制元素) 与不提供
+ *        reallocate (每次扩容申请新空间并逐个搬移元素)
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-16 16:05:12
+ *
+ * */
+
+#include <ctime>
+#include <iostream>
+
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const long PUSHES = 200000000;
+
+// 与 Mystl::allocator 相同, 但不提供 reallocate, 扩容时只能搬移元素
+template <class T>
+struct CopyAllocator : public Mystl::allocator<T> {
+  template <class U>
+  struct rebind {
+    typedef CopyAllocator<U> other;
+  };
+
+  CopyAllocator() noexcept {
+  }
+
+  template <class U>
+  CopyAllocator(const CopyAllocator<U> &) noexcept {
+  }
+
+  T *reallocate(T *, size_t, size_t) = delete;
+};
+
+template <class Vector>
+void TestPushBack(const char *name) {
+  std::cout << "Test push_back " << name << std::endl;
+
+  Vector  v;
+  clock_t timeStart = std::clock();
+  for (long i = 0; i < PUSHES; ++i) {
+    v.push_back(static_cast<int>(i));
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "size / back : " << v.size() << " / " << v.back() << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestPushBack<Mystl::vector<int>>("vector<int>");
+  TestSTL::TestPushBack<Mystl::vector<int, TestSTL::CopyAllocator<int>>>(
+      "vector<int, CopyAllocator>");
+}
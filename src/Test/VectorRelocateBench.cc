@@ -0,0 +1,72 @@
+/**
+ * @Copyright (c) 2021  koritafei
+ * @file VectorRelocateBench.cc
+ * @brief 在 vector 头部反复插入、删除元素时平移的耗时, 对比可平凡重定位的
+ *        vector<int> 元素 (按字节搬移) 与使用不可重定位 allocator 的
+ *        vector<int> 元素 (逐个移动构造再析构)
+ * @author koritafei (koritafei@gmail.com)
+ * @version 0.1
+ * @date 2021-05-19 11:05:36
+ *
+ * */
+
+#include <ctime>
+#include <iostream>
+
+#include "../STL/vector.h"
+
+namespace TestSTL {
+const int ELEMENTS = 50000;
+const int ROW_LEN  = 4;
+
+// 与 Mystl::allocator 相同, 但声明为不可平凡重定位
+template <class T>
+struct PinnedAllocator : public Mystl::allocator<T> {
+  template <class U>
+  struct rebind {
+    typedef PinnedAllocator<U> other;
+  };
+
+  PinnedAllocator() noexcept {
+  }
+
+  template <class U>
+  PinnedAllocator(const PinnedAllocator<U> &) noexcept {
+  }
+};
+}  // namespace TestSTL
+
+namespace Mystl {
+template <class T>
+struct is_trivially_relocatable<TestSTL::PinnedAllocator<T>> : m_false_type {};
+}  // namespace Mystl
+
+namespace TestSTL {
+template <class Row>
+void TestFrontInsertErase(const char *name) {
+  std::cout << "Test " << name << std::endl;
+
+  Mystl::vector<Row> rows;
+  const Row          row(ROW_LEN, 1);
+  long               sum       = 0;
+  clock_t            timeStart = std::clock();
+  for (int i = 0; i < ELEMENTS; ++i) {
+    rows.insert(rows.begin(), row);
+  }
+  while (!rows.empty()) {
+    sum += rows.front()[0];
+    rows.erase(rows.begin());
+  }
+
+  std::cout << "Milli-seconds : "
+            << (clock() - timeStart) * 1000 / CLOCKS_PER_SEC << std::endl;
+  std::cout << "sum : " << sum << std::endl;
+}
+}  // namespace TestSTL
+
+int main(int argc, char **argv) {
+  TestSTL::TestFrontInsertErase<Mystl::vector<int>>("vector<vector<int>>");
+  TestSTL::TestFrontInsertErase<
+      Mystl::vector<int, TestSTL::PinnedAllocator<int>>>(
+      "vector<vector<int, PinnedAllocator>>");
+}